@@ -1,7 +1,69 @@
 #include "Application.hpp"
+#include "HeadlessApplication.hpp"
 
-int main()
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    // The whole argument has to be a number, so e.g. "--ticks 1e4" is rejected instead of read as 1.
+    template <typename T>
+    bool parseNumber(const char* text, T& out)
+    {
+        const auto* end = text + std::strlen(text);
+        const auto [last, error] = std::from_chars(text, end, out);
+        return error == std::errc{} && last == end && last != text;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
 {
+    // game --headless [--ticks N] [--tick-rate HZ] [--real-time] [--trace FILE]
+    if (argc > 1 && std::string(argv[1]) == "--headless")
+    {
+        lq::HeadlessOptions options;
+        for (int i = 2; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--ticks" && i + 1 < argc)
+            {
+                if (!parseNumber(argv[++i], options.ticks))
+                {
+                    std::cerr << "ERROR: --ticks takes a whole number of ticks (0 runs until stopped), got '"
+                              << argv[i] << "'" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--tick-rate" && i + 1 < argc)
+            {
+                if (!parseNumber(argv[++i], options.tickRate) || !(options.tickRate >= 1.0f))
+                {
+                    std::cerr << "ERROR: --tick-rate takes a rate of at least 1 Hz, got '" << argv[i] << "'"
+                              << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--real-time")
+            {
+                options.realTime = true;
+            }
+            else if (arg == "--trace" && i + 1 < argc)
+            {
+                options.tracePath = argv[++i];
+            }
+            else
+            {
+                std::cerr << "Unknown headless option: " << arg << std::endl;
+                return 1;
+            }
+        }
+        lq::HeadlessApplication headless(options);
+        headless.Update();
+        return 0;
+    }
+
     lq::Application gm;
     gm.Update();
     return 0;
@@ -12,22 +12,34 @@
 #include "engine/systems/CleanupSystem.hpp"
 #include "engine/UserInput.hpp"
 
+#include "FrameProfiler.hpp"
 #include "scenes/ExampleScene.hpp"
 #include "scenes/Scene.hpp"
+#include "StagedLoader.hpp"
 #include "Systems.hpp"
 
 // tmp
 #include "abilities/AbilityData.hpp"
+#include "AssetPack.hpp"
 #include "components/Ability.hpp"
 #include "MapLoader.hpp"
 #include "sage-cereal.hpp"
+#include "SimulationClock.hpp"
 
 #include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
 
 namespace lq
 {
     namespace
     {
+        // Independent of the render rate, which SetTargetFPS caps. May be lower than the display's refresh rate.
+        constexpr float kSimulationStepsPerSecond = 60;
+        constexpr int kProfilerOverlayRows = 24;
+        constexpr float kProfilerSpikeMs = 20; // A dropped frame at 60 fps
+
         RenderTexture LoadFilteredRenderTexture(const int width, const int height)
         {
             auto texture = LoadRenderTexture(std::max(1, width), std::max(1, height));
@@ -47,26 +59,60 @@ namespace lq
         rlSetClipPlanes(0.1, 1000); // Increase depth to reduce z-fighting at distance.
 
         audioManager = std::make_unique<sage::AudioManager>();
+        registry->ctx().emplace<SimulationClock>(kSimulationStepsPerSecond);
 
         scene =
             std::make_unique<ExampleScene>(registry.get(), keyMapping.get(), settings.get(), audioManager.get());
 
-        sage::serializer::LoadAssetBinFile(registry.get(), "resources/assets.bin");
-        maploader::LoadMap(registry.get(), "resources/dungeon-map.bin");
-        // serializer::LoadMap(registry.get(), "resources/cave.bin");
-
-        auto icon = sage::ResourceManager::GetInstance().GetImage("application_icon");
-        SetWindowIcon(icon.GetImage());
-        sage::ResourceManager::GetInstance().ImageUnload("application_icon");
         HideCursor();
         SetExitKey(KEY_NULL); // Disable KEY_ESCAPE to close window, X-button still works
 
-        scene->LoadContent();
-        const auto viewport = settings->GetViewPort();
-        renderTexture = LoadFilteredRenderTexture(static_cast<int>(viewport.x), static_cast<int>(viewport.y));
-        renderTexture2d = LoadFilteredRenderTexture(static_cast<int>(viewport.x), static_cast<int>(viewport.y));
+        loader = std::make_unique<StagedLoader>();
+        addLoadingStages();
+    }
+
+    void Application::addLoadingStages()
+    {
+        addAssetAndMapStages();
+        loader->Add({.name = "Loading scene", .weight = 2, .commit = [this](auto) {
+                         auto icon = sage::ResourceManager::GetInstance().GetImage("application_icon");
+                         SetWindowIcon(icon.GetImage());
+                         sage::ResourceManager::GetInstance().ImageUnload("application_icon");
+
+                         scene->LoadContent();
+                         const auto viewport = settings->GetViewPort();
+                         const auto width = static_cast<int>(viewport.x);
+                         const auto height = static_cast<int>(viewport.y);
+                         renderTexture = LoadFilteredRenderTexture(width, height);
+                         renderTexture2d = LoadFilteredRenderTexture(width, height);
+
+                         sage::serializer::SaveViewJson<AbilityData>(*registry, "resources/ability-data.json");
+                         return 1.0f;
+                     }});
+    }
 
-        sage::serializer::SaveViewJson<AbilityData>(*registry, "resources/ability-data.json");
+    void Application::addAssetAndMapStages()
+    {
+        loader->Add({.name = "Loading asset pack", .weight = 1, .commit = [this](auto) {
+                         AssetPack::GetInstance().Open(registry.get(), "resources/assets.bin");
+                         return 1.0f;
+                     }});
+
+        // The map bin is read and decompressed on a worker while the asset pack opens. Its models and entities
+        // are then decoded and created a slice at a time.
+        auto mapData = std::make_shared<maploader::MapBinData>();
+        auto mapCommit = std::make_shared<std::optional<maploader::MapLoadCommit>>();
+        loader->Add(
+            {.name = "Loading map",
+             .weight = 6,
+             .background = [mapData] { *mapData = maploader::ReadMapBin("resources/dungeon-map.bin"); },
+             .commit = [this, mapData, mapCommit](const StagedLoader::Clock::duration budget) {
+                 if (!mapCommit->has_value()) mapCommit->emplace(registry.get(), std::move(*mapData));
+                 if (!(*mapCommit)->Step(budget)) return (*mapCommit)->Progress();
+                 mapCommit->reset();
+                 return 1.0f;
+             }});
+        // serializer::LoadMap(registry.get(), "resources/cave.bin");
     }
 
     void Application::handleScreenUpdate()
@@ -128,8 +174,16 @@ namespace lq
     void Application::Update()
     {
         init();
-        scene->Init();
         SetTargetFPS(60);
+        while (!loader->Update())
+        {
+            if (WindowShouldClose()) return;
+            drawLoadingScreen();
+        }
+        loader.reset();
+
+        scene->Init();
+        auto& clock = registry->ctx().get<SimulationClock>();
         while (!exitWindow) // Detect window close button or ESC key
         {
 
@@ -146,10 +200,24 @@ namespace lq
                     exitWindowRequested = false;
             }
 
+            auto& profiler = FrameProfiler::GetInstance();
+            if (IsKeyPressed(KEY_F3)) profiler.showOverlay = !profiler.showOverlay;
+            if (IsKeyPressed(KEY_F4))
+            {
+                profiler.WriteChromeTrace("frame-trace-" + std::to_string(profiler.FrameCount()) + ".json");
+            }
+
+            const int steps = clock.Advance(GetFrameTime());
             scene->Update();
+            for (int step = 0; step < steps; ++step)
+            {
+                scene->FixedUpdate();
+                clock.Tick();
+            }
             cleanupSystem->Execute();
             draw();
             handleScreenUpdate();
+            profiler.EndFrame();
         }
     }
 
@@ -199,12 +267,52 @@ namespace lq
                 WHITE);
         }
         DrawFPS(settings->GetScreenSize().x - settings->ScaleValueWidth(120), 10);
+        if (FrameProfiler::GetInstance().showOverlay) drawProfilerOverlay();
         EndDrawing();
     };
 
+    void Application::drawProfilerOverlay()
+    {
+        constexpr int x = 10;
+        constexpr int rowHeight = 14;
+        constexpr int valuesX = x + 170;
+        const auto timings = FrameProfiler::GetInstance().Timings();
+        const auto rows = std::min<int>(kProfilerOverlayRows, static_cast<int>(timings.size()));
+
+        DrawRectangle(x - 5, 5, 300, (rows + 1) * rowHeight + 10, Fade(BLACK, 0.7f));
+        DrawText("ms per frame (F4: trace)", x, 10, 10, GRAY);
+        DrawText("mean      max", valuesX, 10, 10, GRAY);
+        for (int i = 0; i < rows; ++i)
+        {
+            const auto& timing = timings[i];
+            const int y = 10 + (i + 1) * rowHeight;
+            const std::string name(timing.name.substr(0, 28));
+            DrawText(name.c_str(), x, y, 10, WHITE);
+            const auto colour = timing.maxMs > kProfilerSpikeMs ? RED : WHITE;
+            DrawText(TextFormat("%6.3f   %6.3f", timing.meanMs, timing.maxMs), valuesX, y, 10, colour);
+        }
+    }
+
+    void Application::drawLoadingScreen() const
+    {
+        const auto [width, height] = settings->GetScreenSize();
+        const auto barWidth = width * 0.5f;
+        const auto barX = (width - barWidth) / 2.0f;
+        const auto barY = height * 0.75f;
+
+        BeginDrawing();
+        ClearBackground(BLACK);
+        const auto& stage = loader->CurrentStage();
+        const auto textX = (width - static_cast<float>(MeasureText(stage.c_str(), 20))) / 2.0f;
+        DrawText(stage.c_str(), static_cast<int>(textX), static_cast<int>(barY - 40), 20, WHITE);
+        DrawRectangleLinesEx({barX, barY, barWidth, 16}, 1, GRAY);
+        DrawRectangleRec({barX + 2, barY + 2, (barWidth - 4) * loader->Progress(), 12}, WHITE);
+        EndDrawing();
+    }
+
     void Application::cleanup()
     {
-        CloseWindow();
+        if (IsWindowReady()) CloseWindow(); // A subclass may have closed it already (HeadlessApplication)
     }
 
     Application::~Application()
@@ -18,6 +18,7 @@ namespace sage
 namespace lq
 {
     class Scene;
+    class StagedLoader;
     class Application
     {
         RenderTexture renderTexture{};
@@ -30,13 +31,21 @@ namespace lq
         std::unique_ptr<sage::Settings> settings;
         std::unique_ptr<sage::KeyMapping> keyMapping;
         std::unique_ptr<Scene> scene;
+        std::unique_ptr<StagedLoader> loader; // Assets, map and scene content, loaded while the window draws
         bool exitWindowRequested = false; // Flag to request window to exit
         bool exitWindow = false;          // Flag to set window to exit
 
         void handleScreenUpdate();
         virtual void init();
+        // Adds the asset pack, the map and the scene's content to 'loader'.
+        virtual void addLoadingStages();
+        // The asset pack and map stages of addLoadingStages, which nothing drawn depends on.
+        void addAssetAndMapStages();
         static void cleanup();
         virtual void draw();
+        void drawLoadingScreen() const;
+        // Rolling per-system timings (see FrameProfiler), toggled with F3.
+        static void drawProfilerOverlay();
 
       public:
         void Quit();
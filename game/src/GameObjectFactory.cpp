@@ -6,6 +6,7 @@
 #include "animation/RpgAnimationIds.hpp"
 
 #include "AbilityFactory.hpp"
+#include "AssetPack.hpp"
 #include "collision/RpgCollisionLayers.hpp"
 #include "components/CombatableActor.hpp"
 #include "components/DialogComponent.hpp"
@@ -98,7 +99,7 @@ namespace lq
 
         Matrix modelTransform = MatrixScale(0.03f, 0.03f, 0.03f);
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().CreateModelMutable("mdl_goblin"), modelTransform);
+            id, AssetPack::GetInstance().CreateModelMutable("mdl_goblin"), modelTransform);
         renderable.SetName(name);
         auto& uber = registry->emplace<sage::UberShaderComponent>(id, renderable.GetModel()->GetMaterialCount());
         uber.SetFlagAll(sage::UberShaderComponent::Flags::Lit);
@@ -138,7 +139,7 @@ namespace lq
 
         Matrix modelTransform = MatrixScale(0.03f, 0.03f, 0.03f);
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().CreateModelMutable("mdl_goblin"), modelTransform);
+            id, AssetPack::GetInstance().CreateModelMutable("mdl_goblin"), modelTransform);
         renderable.SetName(name);
         auto& uber = registry->emplace<sage::UberShaderComponent>(id, renderable.GetModel()->GetMaterialCount());
         uber.SetFlagAll(sage::UberShaderComponent::Flags::Lit);
@@ -175,7 +176,7 @@ namespace lq
 
         Matrix modelTransform = MatrixScale(0.035f, 0.035f, 0.035f);
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().CreateModelMutable("mdl_player_default"), modelTransform);
+            id, AssetPack::GetInstance().CreateModelMutable("mdl_player_default"), modelTransform);
         renderable.SetName("Arissa");
         auto& uber = registry->emplace<sage::UberShaderComponent>(id, renderable.GetModel()->GetMaterialCount());
         uber.SetFlagAll(sage::UberShaderComponent::Flags::Lit);
@@ -220,7 +221,7 @@ namespace lq
 
         Matrix modelTransform = MatrixScale(0.035f, 0.035f, 0.035f);
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().CreateModelMutable("mdl_player_default"), modelTransform);
+            id, AssetPack::GetInstance().CreateModelMutable("mdl_player_default"), modelTransform);
         renderable.SetName(name);
         auto& uber = registry->emplace<sage::UberShaderComponent>(id, renderable.GetModel()->GetMaterialCount());
         uber.SetFlagAll(sage::UberShaderComponent::Flags::Lit);
@@ -299,7 +300,7 @@ namespace lq
             // Portal plane: scale the canonical unit primitive_plane by 20 via the model transform.
             Matrix modelTransform = MatrixMultiply(MatrixScale(20.0f, 20.0f, 1.0f), MatrixRotateX(90 * DEG2RAD));
 
-            auto portalModel = sage::ResourceManager::GetInstance().CreateModelMutable("primitive_plane");
+            auto portalModel = AssetPack::GetInstance().CreateModelMutable("primitive_plane");
 
             Shader shader =
                 sage::ResourceManager::GetInstance().ShaderLoad(nullptr, "resources/shaders/custom/portal.fs");
@@ -342,7 +343,7 @@ namespace lq
         Matrix modelTransform = MatrixIdentity();
 
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().GetModelView("MDL_BUILDING_PORTAL"), modelTransform);
+            id, AssetPack::GetInstance().GetModelView("MDL_BUILDING_PORTAL"), modelTransform);
         renderable.SetName("Portal Outer");
         sys->engine.lightSubSystem->LinkRenderableToLight(id);
 
@@ -370,7 +371,7 @@ namespace lq
 
         Matrix modelTransform = MatrixIdentity();
         auto& renderable = registry->emplace<sage::Renderable>(
-            id, sage::ResourceManager::GetInstance().GetModelView("MDL_BUILDING_WIZARDTOWER1"), modelTransform);
+            id, AssetPack::GetInstance().GetModelView("MDL_BUILDING_WIZARDTOWER1"), modelTransform);
         renderable.SetName("Wizard Tower");
         sys->engine.lightSubSystem->LinkRenderableToLight(id);
 
@@ -388,7 +389,7 @@ namespace lq
     {
         auto& item = registry->get<ItemComponent>(itemId);
         if (item.HasFlag(ItemFlags::QUEST)) return false;
-        auto model = sage::ResourceManager::GetInstance().GetModelView(item.model);
+        auto model = AssetPack::GetInstance().GetModelView(item.model);
         // TODO: Need a way to store the matrix scale? Maybe in the resource packer we should store the transform
         registry->emplace<sage::Renderable>(itemId, std::move(model), MatrixScale(0.035, 0.035, 0.035));
         auto& transform = registry->emplace<sage::sgTransform>(itemId);
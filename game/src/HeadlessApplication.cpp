@@ -0,0 +1,125 @@
+#include "HeadlessApplication.hpp"
+
+#include "engine/AudioManager.hpp"
+#include "engine/components/sgTransform.hpp"
+#include "engine/Settings.hpp"
+#include "engine/systems/CleanupSystem.hpp"
+
+#include "FrameProfiler.hpp"
+#include "scenes/ExampleScene.hpp"
+#include "scenes/Scene.hpp"
+#include "SimulationClock.hpp"
+#include "StagedLoader.hpp"
+
+#include "raylib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace lq
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Frames between reports when running without a tick limit.
+        constexpr std::uint64_t kSoakReportInterval = 3600;
+    } // namespace
+
+    void HeadlessApplication::init()
+    {
+        context.emplace(!HeadlessContext::DisplayAvailable(), "Baldur's Raylib (headless)");
+        settings->UpdateViewport();
+
+        audioManager = std::make_unique<sage::AudioManager>();
+        registry->ctx().emplace<SimulationClock>(options.tickRate);
+
+        scene =
+            std::make_unique<ExampleScene>(registry.get(), keyMapping.get(), settings.get(), audioManager.get());
+
+        loader = std::make_unique<StagedLoader>();
+        addLoadingStages();
+    }
+
+    void HeadlessApplication::addLoadingStages()
+    {
+        addAssetAndMapStages();
+        loader->Add({.name = "Loading scene", .weight = 2, .commit = [this](auto) {
+                         scene->LoadContent();
+                         return 1.0f;
+                     }});
+    }
+
+    void HeadlessApplication::report(const std::uint64_t frames, const double totalMs, const double maxMs) const
+    {
+        const auto& clock = registry->ctx().get<SimulationClock>();
+        const auto meanMs = totalMs / static_cast<double>(frames);
+        std::cout << "Headless simulation: " << frames << " frame(s), " << clock.Ticks() << " tick(s) at "
+                  << options.tickRate << " Hz (" << (options.realTime ? "real time" : "as fast as possible")
+                  << ", " << clock.DroppedSteps() << " dropped), " << clock.Time() << " s simulated, "
+                  << registry->view<sage::sgTransform>().size() << " entities \n";
+        std::cout << "  " << std::fixed << std::setprecision(3) << meanMs << " ms mean, " << maxMs
+                  << " ms max per frame, " << std::setprecision(0);
+        if (options.realTime)
+        {
+            std::cout << meanMs * options.tickRate / 10.0 << "% of the frame budget \n";
+        }
+        else
+        {
+            std::cout << static_cast<double>(frames) / (totalMs / 1000.0) << " ticks/s \n";
+        }
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    void HeadlessApplication::Update()
+    {
+        std::cout << "START: Loading headless scene \n";
+        init();
+        while (!loader->Update())
+        {
+        }
+        loader.reset();
+        scene->Init();
+        std::cout << "FINISH: Loading headless scene \n";
+
+        SetTargetFPS(options.realTime ? static_cast<int>(options.tickRate) : 0);
+        auto& clock = registry->ctx().get<SimulationClock>();
+        auto& profiler = FrameProfiler::GetInstance();
+        std::uint64_t frames = 0;
+        double totalMs = 0;
+        double maxMs = 0;
+        while (options.ticks == 0 || clock.Ticks() < options.ticks)
+        {
+            // Nothing is drawn. Ending the frame advances raylib's frame timer and polls input, both of which
+            // the engine systems read, and waits out the rest of the tick when pacing.
+            BeginDrawing();
+            EndDrawing();
+
+            const auto start = Clock::now();
+            // Back to back, every frame is exactly one step of simulated time.
+            const int steps = clock.Advance(options.realTime ? GetFrameTime() : clock.DeltaTime());
+            scene->Update();
+            for (int step = 0; step < steps; ++step)
+            {
+                scene->FixedUpdate();
+                clock.Tick();
+            }
+            cleanupSystem->Execute();
+            const auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            profiler.EndFrame();
+
+            ++frames;
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+            if (options.ticks == 0 && frames % kSoakReportInterval == 0) report(frames, totalMs, maxMs);
+        }
+        if (frames > 0) report(frames, totalMs, maxMs);
+        if (!options.tracePath.empty()) profiler.WriteChromeTrace(options.tracePath);
+    }
+
+    HeadlessApplication::HeadlessApplication(const HeadlessOptions& _options) : options(_options)
+    {
+    }
+} // namespace lq
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Application.hpp"
+#include "HeadlessContext.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace lq
+{
+    struct HeadlessOptions
+    {
+        // Simulation steps to run, 0 runs until the process is stopped (soak tests), reporting periodically.
+        std::uint64_t ticks = 3600;
+        float tickRate = 60; // Simulation steps per second
+        // Pace ticks at tickRate instead of running them back to back.
+        bool realTime = false;
+        // If set, the last ticks' per-system timings are written there as a Chrome trace (see FrameProfiler).
+        std::string tracePath;
+    };
+
+    // Runs ExampleScene without drawing anything: loads the asset pack and the map, then ticks Scene::Update and
+    // the state machines (AI, combat, abilities) and reports how long ticks took. Meant for benchmarking and
+    // soak-testing gameplay systems on build machines without a display or GPU. The scene's content is loaded
+    // without the window's render textures or the ability data export.
+    //
+    // raylib's loaders still upload to a GL context, a hidden window or, without a display, the software
+    // context of HeadlessContext. Engine systems (movement, animation) read raylib's frame time, which only
+    // EndDrawing advances, so an empty frame is ended per tick; nothing is drawn into it.
+    //
+    // With realTime, ticks are paced at tickRate and the simulation clock advances by raylib's frame time, as in
+    // Application, so the engine and the state machines agree on elapsed time. Otherwise ticks run back to back
+    // and the clock advances by exactly one step per tick: the state machines see simulated time, but the
+    // engine's per-frame systems stay bound to the wall-clock time a tick took, so movement lags behind the AI
+    // driving it. That mode measures the cost of a tick, not gameplay.
+    class HeadlessApplication : public Application
+    {
+        HeadlessOptions options;
+        std::optional<HeadlessContext> context;
+
+        void report(std::uint64_t frames, double totalMs, double maxMs) const;
+
+      protected:
+        void init() override;
+        // The asset pack, the map and the scene's content, without anything only drawing needs.
+        void addLoadingStages() override;
+
+      public:
+        void Update() override;
+        explicit HeadlessApplication(const HeadlessOptions& _options);
+    };
+} // namespace lq
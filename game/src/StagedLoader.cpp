@@ -0,0 +1,81 @@
+#include "StagedLoader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace lq
+{
+    void StagedLoader::Add(Stage stage)
+    {
+        assert(!started);
+        entries.push_back({.stage = std::move(stage)});
+    }
+
+    void StagedLoader::start()
+    {
+        started = true;
+        for (auto& entry : entries)
+        {
+            if (entry.stage.background)
+            {
+                entry.background = std::async(std::launch::async, entry.stage.background);
+            }
+        }
+    }
+
+    bool StagedLoader::Update()
+    {
+        if (!started) start();
+        const auto deadline = Clock::now() + budget;
+        while (current < entries.size())
+        {
+            auto& entry = entries[current];
+            if (entry.background.valid())
+            {
+                if (entry.background.wait_for(std::chrono::seconds(0)) != std::future_status::ready) break;
+                entry.background.get();
+            }
+
+            if (!entry.committing) std::cout << "START: " << entry.stage.name << " \n";
+            entry.committing = true;
+            const auto remaining = std::max(Clock::duration::zero(), deadline - Clock::now());
+            entry.progress = entry.stage.commit ? std::clamp(entry.stage.commit(remaining), 0.0f, 1.0f) : 1.0f;
+            if (entry.progress < 1.0f) break;
+            std::cout << "FINISH: " << entry.stage.name << " \n";
+            ++current;
+            if (Clock::now() >= deadline) break;
+        }
+
+        float total = 0;
+        float done = 0;
+        for (const auto& entry : entries)
+        {
+            total += entry.stage.weight;
+            done += entry.stage.weight * entry.progress;
+        }
+        const float updated = total > 0 ? done / total : 1.0f;
+        if (updated != progress)
+        {
+            progress = updated;
+            onProgress.Publish(progress);
+        }
+        return Done();
+    }
+
+    bool StagedLoader::Done() const
+    {
+        return current >= entries.size();
+    }
+
+    float StagedLoader::Progress() const
+    {
+        return Done() ? 1.0f : progress;
+    }
+
+    const std::string& StagedLoader::CurrentStage() const
+    {
+        static const std::string none;
+        return Done() ? none : entries[current].stage.name;
+    }
+} // namespace lq
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "engine/Event.hpp"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace lq
+{
+    // Loads in stages without blocking the main loop, so a loading screen can be drawn meanwhile. A stage may
+    // have a background part (file I/O, decompression, decoding) that runs on a worker thread, and a commit
+    // part that runs on the main thread once the background part is done, a slice of at most 'budget' per
+    // Update. Commits run in the order the stages were added.
+    //
+    // Every background part is started on the first Update, so they mustn't depend on an earlier stage's
+    // commit. Exceptions thrown by either part are rethrown from Update.
+    class StagedLoader
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stage
+        {
+            std::string name; // Shown on the loading screen
+            float weight = 1; // Share of the overall progress, relative to the other stages
+            std::function<void()> background;
+            // Called once per Update until it returns 1. Returns the stage's progress (0 to 1).
+            std::function<float(Clock::duration budget)> commit;
+        };
+
+        // Main thread time given to commits per Update.
+        Clock::duration budget = std::chrono::milliseconds(8);
+        // Overall progress (0 to 1), published whenever it changes.
+        sage::Event<float> onProgress;
+
+        void Add(Stage stage);
+        // Advances the current stage. Returns true once every stage is committed.
+        bool Update();
+
+        [[nodiscard]] bool Done() const;
+        [[nodiscard]] float Progress() const;
+        // Name of the stage being loaded, empty once done.
+        [[nodiscard]] const std::string& CurrentStage() const;
+
+      private:
+        struct Entry
+        {
+            Stage stage;
+            std::future<void> background;
+            float progress = 0;
+            bool committing = false;
+        };
+
+        std::vector<Entry> entries;
+        std::size_t current = 0;
+        bool started = false;
+        float progress = 0;
+
+        void start();
+    };
+} // namespace lq
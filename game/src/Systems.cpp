@@ -39,7 +39,9 @@ namespace lq
           questManager(std::make_unique<QuestManager>(_registry, this)),
           contextualDialogSystem(std::make_unique<ContextualDialogSystem>(_registry, this)),
           lootTable(std::make_unique<LootTable>(_registry, this)),
-          lootSystem(std::make_unique<LootSystem>(_registry, this))
+          lootSystem(std::make_unique<LootSystem>(_registry, this)),
+          mapChunkStreamer(std::make_unique<MapChunkStreamer>(_registry, this)),
+          lodSystem(std::make_unique<LodSystem>(_registry, this))
     {
         engine.ReplaceUiEngine(std::make_unique<LeverUIEngine>(_registry, this));
         selectionSystem->onSelectedActorChange.Subscribe([this](entt::entity prev, entt::entity current) {
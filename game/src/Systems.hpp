@@ -32,6 +32,8 @@ namespace lq
     class ControllableActorSystem;
     class CursorClickIndicator;
     class DoorSystem;
+    class MapChunkStreamer;
+    class LodSystem;
 
     class Systems
     {
@@ -59,6 +61,8 @@ namespace lq
         std::unique_ptr<ContextualDialogSystem> contextualDialogSystem;
         std::unique_ptr<LootTable> lootTable;
         std::unique_ptr<LootSystem> lootSystem;
+        std::unique_ptr<MapChunkStreamer> mapChunkStreamer;
+        std::unique_ptr<LodSystem> lodSystem;
         Systems(
             entt::registry* _registry,
             sage::KeyMapping* _keyMapping,
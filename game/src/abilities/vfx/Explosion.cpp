@@ -4,6 +4,9 @@
 
 #include "Explosion.hpp"
 
+#include "AssetPack.hpp"
+#include "SimulationClock.hpp"
+
 #include "engine/components/Renderable.hpp"
 #include "engine/components/sgTransform.hpp"
 #include "engine/EngineSystems.hpp"
@@ -22,7 +25,7 @@ namespace lq
     void Explosion::Update()
     {
         if (scale >= maxScale) return;
-        scale += increment * GetFrameTime();
+        scale += increment * registry->ctx().get<SimulationClock>().FrameTime();
         registry->get<sage::sgTransform>(entity).scale.world = {scale, scale, scale};
         if (scale >= maxScale)
         {
@@ -39,7 +42,7 @@ namespace lq
     Explosion::Explosion(entt::registry* _registry, sage::EngineSystems* _sys) : sys(_sys)
     {
         registry = _registry;
-        auto sphere = sage::ResourceManager::GetInstance().CreateModelMutable("primitive_hemisphere");
+        auto sphere = AssetPack::GetInstance().CreateModelMutable("primitive_hemisphere");
         sphere.SetShader(
             sage::ResourceManager::GetInstance().ShaderLoad(nullptr, "resources/shaders/glsl330/base.fs"), 0);
 
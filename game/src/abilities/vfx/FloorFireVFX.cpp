@@ -26,7 +26,7 @@ namespace lq
 
     void FloorFireVFX::Update(float dt)
     {
-        time += 3 * GetFrameTime();
+        time += 3 * dt;
         SetShaderValue(shader, secondsLoc, &time, SHADER_UNIFORM_FLOAT);
     }
 
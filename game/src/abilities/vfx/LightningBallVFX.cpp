@@ -9,6 +9,7 @@
 #include "engine/components/sgTransform.hpp"
 #include "engine/ResourceManager.hpp"
 
+#include "AssetPack.hpp"
 #include "components/Ability.hpp"
 #include "Systems.hpp"
 
@@ -55,7 +56,7 @@ namespace lq
         shader = sage::ResourceManager::GetInstance().ShaderLoad(nullptr, "resources/shaders/custom/lightning.fs");
         secondsLoc = GetShaderLocation(shader, "seconds");
         SetShaderValue(shader, secondsLoc, &time, SHADER_UNIFORM_FLOAT);
-        model = sage::ResourceManager::GetInstance().CreateModelMutable("vfx_sphere");
+        model = AssetPack::GetInstance().CreateModelMutable("vfx_sphere");
 
         model.SetTexture(texture, 0, MATERIAL_MAP_DIFFUSE);
         model.SetTexture(texture2, 0, MATERIAL_MAP_EMISSION);
@@ -4,6 +4,7 @@
 
 #include "WhirlwindVFX.hpp"
 
+#include "AssetPack.hpp"
 #include "components/Ability.hpp"
 #include "Systems.hpp"
 
@@ -59,7 +60,7 @@ namespace lq
         // SetShaderValue(shader, secondsLoc, &time, SHADER_UNIFORM_FLOAT);
         // shader.locs[SHADER_LOC_MAP_EMISSION] = GetShaderLocation(shader, "texture1");
 
-        slashModel = sage::ResourceManager::GetInstance().CreateModelMutable("vfx_flattorus");
+        slashModel = AssetPack::GetInstance().CreateModelMutable("vfx_flattorus");
         slashModel.SetTexture(texture, 0, MATERIAL_MAP_DIFFUSE);
         slashModel.SetShader(shader, 0);
     }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <string>
+#include <vector>
+
+namespace lq
+{
+    // respacker stores up to this many simplified copies of a model next to it.
+    inline constexpr int kMaxLodLevels = 4;
+
+    // Key of a model's simplified copy. Level 0 is the model itself.
+    [[nodiscard]] inline std::string LodModelKey(const std::string& key, const int level)
+    {
+        return level == 0 ? key : key + "_lod" + std::to_string(level);
+    }
+
+    // Added to renderables by LodSystem. Levels are swapped by pointing the renderable's raylib Model at another
+    // mesh array, every level has the same mesh count and material layout as the base model.
+    struct MeshLod
+    {
+        std::string key;
+        Mesh* baseMeshes = nullptr;
+        std::vector<Mesh*> levels; // LOD1..N, empty if the model has none
+        // Skinned models get their own copies of the level mesh arrays, so bone matrices aren't shared between
+        // instances. Vertex buffers still are.
+        std::vector<std::vector<Mesh>> ownedLevels;
+        int current = 0;
+
+        MeshLod() = default;
+        MeshLod(const MeshLod&) = delete;
+        MeshLod& operator=(const MeshLod&) = delete;
+        MeshLod(MeshLod&&) noexcept = default;
+        MeshLod& operator=(MeshLod&&) noexcept = default;
+
+        ~MeshLod()
+        {
+            for (auto& meshes : ownedLevels)
+            {
+                for (auto& mesh : meshes)
+                {
+                    RL_FREE(mesh.boneMatrices);
+                }
+            }
+        }
+    };
+} // namespace lq
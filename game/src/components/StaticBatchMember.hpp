@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+namespace lq
+{
+    // A static map object whose geometry respacker merged into a batch mesh ("--batch-static"). It keeps its
+    // transform, collision and tags, but has no Renderable of its own.
+    struct StaticBatchMember
+    {
+        std::string modelKey; // The model it was drawn with before batching, for tools
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(modelKey);
+        }
+    };
+} // namespace lq
@@ -5,17 +5,31 @@
 
 #include "engine/AudioManager.hpp"
 #include "engine/Camera.hpp"
+#include "engine/components/Animation.hpp"
+#include "engine/components/Collideable.hpp"
 #include "engine/components/Renderable.hpp"
+#include "engine/components/sgTransform.hpp"
 #include "engine/components/Spawner.hpp"
 #include "engine/components/UberShaderComponent.hpp"
 #include "engine/Cursor.hpp"
 #include "engine/FullscreenTextOverlayManager.hpp"
 #include "engine/GameUiEngine.hpp"
+#include "engine/LightManager.hpp"
 
+#include "components/CombatableActor.hpp"
+#include "components/ControllableActor.hpp"
+#include "components/HealthBar.hpp"
+#include "components/MeshLod.hpp"
 #include "DialogFactory.hpp"
+#include "FrameProfiler.hpp"
 #include "engine/GameUiEngine.hpp"
 #include "GameObjectFactory.hpp"
 #include "MapLoader.hpp"
+#include "MapObjectTags.hpp"
+#include "NavigationGridBake.hpp"
+#include "ParallelFor.hpp"
+#include "SimulationClock.hpp"
+#include "SystemScheduler.hpp"
 #include "ui/GameUI.hpp"
 #include "ui/GameUiFactory.hpp"
 
@@ -63,19 +77,32 @@ namespace lq
         sage::serializer::DeserializeJsonFile<LootTable>("resources/loot-table.json", *sys->lootTable);
         // serializer::SaveClassJson<LootTable>("resources/loot-table.json", *sys->lootTable);
 
-        const auto heightMap = sage::ResourceManager::GetInstance().GetImage("HEIGHT_MAP");
-        const auto normalMap = sage::ResourceManager::GetInstance().GetImage("NORMAL_MAP");
-        const auto slices = heightMap.GetWidth();
-        sys->engine.navigationGridSystem->Init(slices, 1.0f);
-        sys->engine.navigationGridSystem->PopulateGrid(heightMap, normalMap);
+        const auto& navigation = registry->ctx().get<maploader::BakedNavigationGrid>();
+        sys->engine.navigationGridSystem->Init(navigation.slices, navigation.spacing);
+        maploader::ApplyBakedNavigationGrid(navigation, *sys->engine.navigationGridSystem);
 
-        // NB: Dependent on *only* the map/static meshes having been loaded at this point
-        for (const auto view = registry->view<sage::Renderable>(); auto entity : view)
+        // Static geometry around the party has to be there on the first frame, the rest streams in.
+        sys->mapChunkStreamer->Init();
+        for (const auto view = registry->view<sage::Spawner>(); auto entity : view)
         {
+            const auto& spawner = view.get<sage::Spawner>(entity);
+            if (spawner.type == sage::SpawnerType::PLAYER) sys->mapChunkStreamer->LoadAround(spawner.pos);
+        }
+
+        // NB: Dependent on *only* the map/static meshes having been loaded at this point
+        auto makeLit = [this](const entt::entity entity) {
             auto& uber = registry->emplace<sage::UberShaderComponent>(
                 entity, registry->get<sage::Renderable>(entity).GetModel()->GetMaterialCount());
+            // Baked scenery carries its static lighting in its vertex colours (respacker --bake-lighting).
+            const auto* tags = registry->try_get<MapObjectTags>(entity);
+            if (tags != nullptr && tags->HasAnyTag(MapObjectTag::BAKEDLIGHT)) return;
             uber.SetFlagAll(sage::UberShaderComponent::Flags::Lit);
+        };
+        for (const auto view = registry->view<sage::Renderable>(); auto entity : view)
+        {
+            makeLit(entity);
         }
+        sys->mapChunkStreamer->onEntityStreamedIn.Subscribe(makeLit);
 
         loadSpawners();
 
@@ -107,26 +134,72 @@ namespace lq
         GameUiFactory::CreateGameWindowButtons(&sys->UI(), inventoryWindow, equipmentWindow, journalWindow);
     }
 
+    void Scene::buildUpdateSchedule()
+    {
+        // Accesses are what each system touches while updating, including whatever its events reach. Systems
+        // publishing events with arbitrary subscribers (input, UI, movement...) are exclusive. Access tokens that
+        // aren't components (the camera, cursor, audio) stand for that object's state.
+        //
+        // For now this only orders and profiles the frame. lodSelect is the one system that could leave the main
+        // thread, and the scheduler doesn't start its pool for a single one, so everything runs here in order.
+        // The heavy engine systems (movement, collision, animation) each mix their CPU work with GL calls, events
+        // or structural changes in one Update, and the state machines run per fixed step in FixedUpdate. Each can
+        // be declared AnyThread once that work is split out, as LodSystem's was.
+        auto& schedule = *updateSchedule;
+        schedule.Add("audio", [this] { sys->engine.audioManager->Update(); }).Writes<sage::AudioManager>();
+        schedule.Add("render", [this] { sys->engine.renderSystem->Update(); })
+            .Reads<sage::sgTransform>()
+            .Writes<sage::Renderable>();
+        schedule.Add("camera", [this] { sys->engine.camera->Update(); }).Writes<sage::Camera>();
+        schedule.Add("input", [this] { sys->engine.userInput->ListenForInput(); }).Exclusive();
+        schedule.Add("cursor", [this] { sys->engine.cursor->Update(); }).Exclusive();
+        schedule.Add("lights", [this] { sys->engine.lightSubSystem->Update(); })
+            .Reads<sage::sgTransform, sage::Camera>()
+            .Writes<sage::Light>();
+        schedule.Add("ui", [this] { sys->UI().Update(); }).Exclusive();
+        schedule.Add("spiral", [this] { spiral->Update(registry->ctx().get<SimulationClock>().FrameTime()); })
+            .Writes<SpiralFountainVFX>();
+        schedule.Add("cursorClickIndicator", [this] { sys->cursorClickIndicator->Update(); })
+            .Reads<sage::Cursor>()
+            .Writes<sage::sgTransform, sage::Renderable>();
+        schedule.Add("textOverlay", [this] { sys->engine.fullscreenTextOverlayFactory->Update(); }).Exclusive();
+        schedule.Add("actorMovement", [this] { sys->engine.actorMovementSystem->Update(); }).Exclusive();
+        schedule.Add("collision", [this] { sys->engine.collisionSystem->Update(); }).Exclusive();
+        // Level selection reads the bounds collision just updated and has to finish before animation poses the
+        // selected meshes.
+        schedule.Add("lodAttach", [this] { sys->lodSystem->AttachNew(); }).Exclusive();
+        schedule.Add("lodSelect", [this] { sys->lodSystem->SelectLevels(); })
+            .Reads<sage::Camera, sage::Collideable>()
+            .Writes<MeshLod, sage::Renderable>()
+            .AnyThread();
+        schedule.Add("controllableActors", [this] { sys->controllableActorSystem->Update(); })
+            .Reads<sage::sgTransform, sage::Collideable>()
+            .Writes<ControllableActor>();
+        schedule.Add("healthBars", [this] { sys->healthBarSystem->Update(); })
+            .Reads<CombatableActor>()
+            .Writes<HealthBar>();
+        schedule.Add("animation", [this] { sys->engine.animationSystem->Update(); })
+            .Writes<sage::Animation, sage::Renderable>();
+        schedule.Add("contextualDialog", [this] { sys->contextualDialogSystem->Update(); }).Exclusive();
+        schedule.Add("spatialAudio", [this] { sys->engine.spatialAudioSystem->Update(); })
+            .Reads<sage::sgTransform, sage::Camera>()
+            .Writes<sage::AudioManager, sage::SpatialAudioComponent>();
+        schedule.Add("loot", [this] { sys->lootSystem->Update(); }).Exclusive();
+        schedule
+            .Add(
+                "abilityVisuals",
+                [this] { sys->stateMachines->UpdateVisuals(registry->ctx().get<SimulationClock>().FrameTime()); })
+            .Exclusive();
+        schedule.Add("mapChunkStreamer", [this] { sys->mapChunkStreamer->Update(); }).Exclusive();
+    }
+
     void Scene::Update()
     {
-        sys->engine.audioManager->Update();
-        sys->engine.renderSystem->Update();
-        sys->engine.camera->Update();
-        sys->engine.userInput->ListenForInput();
-        sys->engine.cursor->Update();
-        sys->engine.lightSubSystem->Update();
-        sys->UI().Update();
-        spiral->Update(GetFrameTime());
-        sys->cursorClickIndicator->Update();
-        sys->engine.fullscreenTextOverlayFactory->Update();
-        sys->engine.actorMovementSystem->Update();
-        sys->engine.collisionSystem->Update();
-        sys->controllableActorSystem->Update();
-        sys->healthBarSystem->Update();
-        sys->engine.animationSystem->Update();
-        sys->contextualDialogSystem->Update();
-        sys->engine.spatialAudioSystem->Update();
-        sys->lootSystem->Update();
+        updateSchedule->Run();
+    }
+
+    void Scene::FixedUpdate()
+    {
         sys->stateMachines->Update();
     }
 
@@ -142,10 +215,22 @@ namespace lq
 
     void Scene::Draw3D()
     {
-        sys->engine.renderSystem->Draw();
-        sys->engine.cursor->Draw3D();
-        sys->healthBarSystem->Draw3D();
-        sys->stateMachines->Draw3D();
+        {
+            ProfileScope scope("render.Draw3D");
+            sys->engine.renderSystem->Draw();
+        }
+        {
+            ProfileScope scope("cursor.Draw3D");
+            sys->engine.cursor->Draw3D();
+        }
+        {
+            ProfileScope scope("healthBars.Draw3D");
+            sys->healthBarSystem->Draw3D();
+        }
+        {
+            ProfileScope scope("stateMachines.Draw3D");
+            sys->stateMachines->Draw3D();
+        }
         // spiral->Draw3D();
     };
 
@@ -156,10 +241,22 @@ namespace lq
 
     void Scene::Draw2D()
     {
-        sys->contextualDialogSystem->Draw2D();
-        sys->UI().Draw2D();
-        sys->engine.cursor->Draw2D();
-        sys->engine.fullscreenTextOverlayFactory->Draw2D();
+        {
+            ProfileScope scope("contextualDialog.Draw2D");
+            sys->contextualDialogSystem->Draw2D();
+        }
+        {
+            ProfileScope scope("ui.Draw2D");
+            sys->UI().Draw2D();
+        }
+        {
+            ProfileScope scope("cursor.Draw2D");
+            sys->engine.cursor->Draw2D();
+        }
+        {
+            ProfileScope scope("textOverlay.Draw2D");
+            sys->engine.fullscreenTextOverlayFactory->Draw2D();
+        }
     }
 
     Scene::~Scene()
@@ -191,8 +288,12 @@ namespace lq
         sage::KeyMapping* _keyMapping,
         sage::Settings* _settings,
         sage::AudioManager* _audioManager)
-        : registry(_registry), sys(std::make_unique<Systems>(_registry, _keyMapping, _settings, _audioManager))
+        : registry(_registry),
+          sys(std::make_unique<Systems>(_registry, _keyMapping, _settings, _audioManager)),
+          // The calling thread is a worker too.
+          updateSchedule(std::make_unique<SystemScheduler>(ResolveJobCount(0) - 1))
     {
+        buildUpdateSchedule();
     };
 
 } // namespace lq
@@ -20,10 +20,13 @@ namespace lq
 {
     class Systems;
     class SpiralFountainVFX;
+    class SystemScheduler;
 
     class Scene
     {
         std::unique_ptr<SpiralFountainVFX> spiral;
+        std::unique_ptr<SystemScheduler> updateSchedule;
+        void buildUpdateSchedule();
         void initAssets() const;
         void initUI() const;
         void loadSpawners() const;
@@ -37,7 +40,11 @@ namespace lq
         sage::Event<entt::entity> sceneChange;
 
         virtual void Init() = 0;
+        // Once per rendered frame: input, camera, movement, animation, UI and other presentation. Movement and
+        // animation belong in FixedUpdate, but are engine systems on raylib's frame time (see SimulationClock).
         virtual void Update();
+        // Once per simulation step (see SimulationClock): game logic that must not depend on the frame rate.
+        virtual void FixedUpdate();
         virtual void Draw3D();
         virtual void DrawDebug3D();
         virtual void Draw2D();
@@ -20,7 +20,9 @@
 #include "systems/EquipmentSystem.hpp"
 #include "systems/HealthBarSystem.hpp"
 #include "systems/InventorySystem.hpp"
+#include "systems/LodSystem.hpp"
 #include "systems/LootSystem.hpp"
+#include "systems/MapChunkStreamer.hpp"
 #include "systems/PartySystem.hpp"
 #include "systems/PlayerAbilitySystem.hpp"
 #include "systems/SelectionSystem.hpp"
@@ -1,5 +1,7 @@
 #include "systems/CursorClickIndicator.hpp"
 
+#include "AssetPack.hpp"
+#include "SimulationClock.hpp"
 #include "Systems.hpp"
 
 #include "engine/components/MoveableActor.hpp"
@@ -24,7 +26,7 @@ namespace lq
             registry->emplace<sage::sgTransform>(self);
         }
 
-        auto sphere = sage::ResourceManager::GetInstance().CreateModelMutable("primitive_sphere");
+        auto sphere = AssetPack::GetInstance().CreateModelMutable("primitive_sphere");
         auto& renderable = registry->emplace<sage::Renderable>(self, std::move(sphere), MatrixIdentity());
         renderable.hint = GREEN;
         renderable.active = false;
@@ -93,7 +95,7 @@ namespace lq
         auto& renderable = registry->get<sage::Renderable>(self);
         if (!renderable.active) return;
 
-        k += 5.0f * GetFrameTime();
+        k += 5.0f * registry->ctx().get<SimulationClock>().FrameTime();
         constexpr float minScale = 0.25f;
         constexpr float maxScale = 1.0f;
         const float normalizedScale = (sin(k) + 1.0f) * 0.5f;
@@ -14,6 +14,7 @@
 #include "engine/ResourceManager.hpp"
 #include "engine/slib.hpp"
 
+#include "AssetPack.hpp"
 #include "components/EquipmentComponent.hpp"
 #include "components/InventoryComponent.hpp"
 #include "components/ItemComponent.hpp"
@@ -223,7 +224,7 @@ namespace lq
         const auto& item = registry->get<ItemComponent>(itemId);
         registry->emplace<sage::Renderable>(
             weaponEntity,
-            sage::ResourceManager::GetInstance().GetModelView(item.model),
+            AssetPack::GetInstance().GetModelView(item.model),
             renderable.initialTransform);
         auto& uber =
             registry->emplace<sage::UberShaderComponent>(weaponEntity, renderable.GetModel()->GetMaterialCount());
@@ -8,6 +8,7 @@
 #include "engine/components/Collideable.hpp"
 #include "components/CombatableActor.hpp"
 #include "components/HealthBar.hpp"
+#include "SimulationClock.hpp"
 
 #include "raylib.h"
 
@@ -19,13 +20,14 @@ namespace lq
 
     void HealthBarSystem::updateHealthBarTextures() const
     {
+        const float dt = registry->ctx().get<SimulationClock>().FrameTime();
         const auto& view = registry->view<HealthBar>();
         for (const auto& entity : view)
         {
             auto& hb = registry->get<HealthBar>(entity);
             const auto& c = registry->get<CombatableActor>(entity);
             const float decayRate = 2.0f; // Adjust this value to control the speed of decay
-            hb.damageTaken *= exp(-decayRate * GetFrameTime());
+            hb.damageTaken *= exp(-decayRate * dt);
 
             if (hb.damageTaken < 0.1f) hb.damageTaken = 0; // Reset to zero when it's very small
 
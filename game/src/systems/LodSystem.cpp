@@ -0,0 +1,195 @@
+#include "LodSystem.hpp"
+
+#include "AssetPack.hpp"
+#include "Systems.hpp"
+
+#include "engine/Camera.hpp"
+#include "engine/components/Collideable.hpp"
+#include "engine/components/Renderable.hpp"
+#include "engine/ResourceManager.hpp"
+
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lq
+{
+    namespace
+    {
+        // Bounding sphere diameter over the height of the view at the sphere's distance.
+        float projectedSize(const BoundingBox& box, const Camera3D& camera)
+        {
+            const auto center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+            const float radius = Vector3Distance(box.min, box.max) * 0.5f;
+            if (camera.projection == CAMERA_ORTHOGRAPHIC) return radius / (camera.fovy * 0.5f);
+            const float distance = std::max(Vector3Distance(center, camera.position), 0.001f);
+            return radius / (distance * std::tan(camera.fovy * DEG2RAD * 0.5f));
+        }
+    } // namespace
+
+    const LodSystem::Chain& LodSystem::chainFor(const std::string& key)
+    {
+        const auto [it, inserted] = chains.try_emplace(key);
+        auto& chain = it->second;
+        if (!inserted) return chain;
+
+        auto& pack = AssetPack::GetInstance();
+        auto& rm = sage::ResourceManager::GetInstance();
+        pack.Require(key);
+        const auto base = rm.modelCopies.find(key);
+        if (base == rm.modelCopies.end()) return chain;
+        chain.base = base->second.model.meshes;
+
+        for (int level = 1; level <= kMaxLodLevels; ++level)
+        {
+            const auto lodKey = LodModelKey(key, level);
+            pack.Require(lodKey);
+            const auto lod = rm.modelCopies.find(lodKey);
+            // A level with a different mesh layout comes from a stale pack and can't be swapped in.
+            if (lod == rm.modelCopies.end() || lod->second.model.meshCount != base->second.model.meshCount) break;
+
+            auto& model = lod->second.model;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                // Levels are never created through the ResourceManager, so nothing else uploads them.
+                if (model.meshes[m].vaoId == 0) UploadMesh(&model.meshes[m], false);
+            }
+            chain.levels.push_back(model.meshes);
+        }
+        return chain;
+    }
+
+    void LodSystem::attach(const entt::entity entity)
+    {
+        // Added even if the model has no levels, so it isn't looked at again.
+        auto& lod = registry->emplace<MeshLod>(entity);
+        auto* model = registry->get<sage::Renderable>(entity).GetModel();
+        if (model == nullptr || model->GetKey().empty()) return;
+
+        const auto& chain = chainFor(model->GetKey());
+        if (chain.levels.empty()) return;
+        const auto& rlModel = model->GetRlModel();
+        lod.key = model->GetKey();
+        // A model view may already be showing a level another renderable picked.
+        const bool showingLevel = std::ranges::find(chain.levels, rlModel.meshes) != chain.levels.end();
+        lod.baseMeshes = showingLevel ? chain.base : rlModel.meshes;
+
+        if (rlModel.boneCount == 0 || lod.baseMeshes[0].boneMatrices == nullptr)
+        {
+            lod.levels = chain.levels;
+            return;
+        }
+
+        // Skinned: the animation system writes this renderable's pose into whichever mesh array it's showing.
+        for (const auto* levelMeshes : chain.levels)
+        {
+            std::vector<Mesh> meshes(levelMeshes, levelMeshes + rlModel.meshCount);
+            for (int m = 0; m < rlModel.meshCount; ++m)
+            {
+                const auto& base = lod.baseMeshes[m];
+                auto& mesh = meshes[m];
+                if (base.boneMatrices == nullptr || base.boneCount != mesh.boneCount)
+                {
+                    mesh.boneMatrices = nullptr;
+                    continue;
+                }
+                const auto bytes = static_cast<std::size_t>(base.boneCount) * sizeof(Matrix);
+                mesh.boneMatrices = static_cast<Matrix*>(RL_MALLOC(bytes));
+                std::memcpy(mesh.boneMatrices, base.boneMatrices, bytes);
+            }
+            lod.levels.push_back(meshes.data());
+            lod.ownedLevels.push_back(std::move(meshes));
+        }
+    }
+
+    void LodSystem::restore(const entt::entity entity)
+    {
+        auto* lod = registry->try_get<MeshLod>(entity);
+        auto* renderable = registry->try_get<sage::Renderable>(entity);
+        if (lod == nullptr || renderable == nullptr || lod->baseMeshes == nullptr) return;
+        // The renderable's model frees whatever it points at, which has to be its own meshes again.
+        if (auto* model = renderable->GetModel()) model->GetRlModel().meshes = lod->baseMeshes;
+        lod->current = 0;
+    }
+
+    int LodSystem::selectLevel(const float screenSize, const int current, const int available) const
+    {
+        int level = 0;
+        while (level < available && screenSize < screenSizes[level])
+        {
+            ++level;
+        }
+        if (level < current)
+        {
+            level = std::min(current, available);
+            while (level > 0 && screenSize >= screenSizes[level - 1] * (1.0f + hysteresis))
+            {
+                --level;
+            }
+        }
+        return level;
+    }
+
+    void LodSystem::AttachNew()
+    {
+        if (!enabled) return;
+
+        std::vector<entt::entity> added;
+        for (const auto entity : registry->view<sage::Renderable, sage::Collideable>(entt::exclude<MeshLod>))
+        {
+            added.push_back(entity);
+        }
+        for (const auto entity : added)
+        {
+            attach(entity);
+        }
+    }
+
+    void LodSystem::SelectLevels()
+    {
+        if (!enabled) return;
+
+        const auto& camera = *sys->engine.camera->getRaylibCam();
+        const auto view = registry->view<MeshLod, sage::Renderable, sage::Collideable>();
+        sharedLevels.clear();
+        for (const auto entity : view)
+        {
+            auto& lod = view.get<MeshLod>(entity);
+            if (lod.levels.empty()) continue;
+            const auto* model = view.get<sage::Renderable>(entity).GetModel();
+            const float size = projectedSize(view.get<sage::Collideable>(entity).worldBoundingBox, camera);
+            const int level = selectLevel(size, lod.current, static_cast<int>(lod.levels.size()));
+            const auto [it, inserted] = sharedLevels.try_emplace(&model->GetRlModel(), level);
+            if (!inserted) it->second = std::min(it->second, level);
+        }
+
+        for (const auto entity : view)
+        {
+            auto& lod = view.get<MeshLod>(entity);
+            if (lod.levels.empty()) continue;
+            auto& model = view.get<sage::Renderable>(entity).GetModel()->GetRlModel();
+            lod.current = sharedLevels.at(&model);
+            model.meshes = lod.current == 0 ? lod.baseMeshes : lod.levels[lod.current - 1];
+        }
+    }
+
+    void LodSystem::Update()
+    {
+        AttachNew();
+        SelectLevels();
+    }
+
+    void LodSystem::ForgetModel(const std::string& key)
+    {
+        chains.erase(key);
+    }
+
+    LodSystem::LodSystem(entt::registry* _registry, Systems* _sys) : registry(_registry), sys(_sys)
+    {
+        // Whichever of the two goes first puts the renderable's own meshes back.
+        registry->on_destroy<sage::Renderable>().connect<&LodSystem::restore>(this);
+        registry->on_destroy<MeshLod>().connect<&LodSystem::restore>(this);
+    }
+} // namespace lq
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "components/MeshLod.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lq
+{
+    class Systems;
+
+    // Picks a detail level for every renderable whose model has simplified copies in the asset pack (see
+    // sage::meshopt::GenerateResourceManagerLods), based on how large its bounds appear on screen.
+    // Renderables sharing one raylib Model (model views) can only show one level between them, so they all get
+    // the finest level any of them needs.
+    class LodSystem
+    {
+        struct Chain
+        {
+            Mesh* base = nullptr; // The ResourceManager's copy of the model
+            std::vector<Mesh*> levels;
+        };
+
+        entt::registry* registry;
+        Systems* sys;
+        std::unordered_map<std::string, Chain> chains;
+        std::unordered_map<const Model*, int> sharedLevels; // Scratch for SelectLevels
+
+        const Chain& chainFor(const std::string& key);
+        void attach(entt::entity entity);
+        void restore(entt::entity entity);
+        [[nodiscard]] int selectLevel(float screenSize, int current, int available) const;
+
+      public:
+        // A renderable uses LOD n once its bounding sphere covers less than screenSizes[n - 1] of the screen
+        // height.
+        std::array<float, kMaxLodLevels> screenSizes{0.3f, 0.15f, 0.075f, 0.04f};
+        // Going back to a finer level needs the size to clear its threshold by this share, so objects sitting
+        // on a threshold don't flicker between two levels.
+        float hysteresis = 0.1f;
+        bool enabled = true;
+
+        // Adds MeshLod to new renderables and uploads their levels. Structural and touches GL: main thread only.
+        void AttachNew();
+        // Swaps every renderable to the level its screen size calls for. Only reads the camera and collision
+        // bounds and writes MeshLod and the renderables' models, so it may run on a worker (see SystemScheduler).
+        void SelectLevels();
+        void Update();
+        // Drops what's cached about a model's levels, before it's taken out of the ResourceManager.
+        void ForgetModel(const std::string& key);
+
+        LodSystem(entt::registry* _registry, Systems* _sys);
+    };
+} // namespace lq
@@ -0,0 +1,199 @@
+#include "MapChunkStreamer.hpp"
+
+#include "components/PartyMemberComponent.hpp"
+#include "MapLoader.hpp"
+#include "Systems.hpp"
+
+#include "engine/Camera.hpp"
+#include "engine/components/sgTransform.hpp"
+#include "engine/systems/NavigationGridSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace lq
+{
+    std::vector<Vector3> MapChunkStreamer::focusPoints() const
+    {
+        std::vector<Vector3> out;
+        out.push_back(sys->engine.camera->getRaylibCam()->target);
+        for (const auto view = registry->view<PartyMemberComponent, sage::sgTransform>(); const auto entity : view)
+        {
+            out.push_back(view.get<sage::sgTransform>(entity).GetWorldPos());
+        }
+        return out;
+    }
+
+    float MapChunkStreamer::distanceTo(const std::size_t chunk, const std::vector<Vector3>& points) const
+    {
+        const auto& bounds = registry->ctx().get<maploader::MapChunkSource>().index.chunks[chunk].bounds;
+        auto closest = std::numeric_limits<float>::max();
+        for (const auto& point : points)
+        {
+            const float dx = std::max({bounds.min.x - point.x, 0.0f, point.x - bounds.max.x});
+            const float dz = std::max({bounds.min.z - point.z, 0.0f, point.z - bounds.max.z});
+            closest = std::min(closest, std::sqrt(dx * dx + dz * dz));
+        }
+        return closest;
+    }
+
+    std::vector<maploader::MapChunkModel> MapChunkStreamer::modelsToRead(const std::size_t chunk) const
+    {
+        const auto& index = registry->ctx().get<maploader::MapChunkSource>().index;
+        std::vector<maploader::MapChunkModel> out;
+        for (const auto model : index.chunks[chunk].models)
+        {
+            if (modelUsers[model] == 0) out.push_back(index.models[model]);
+        }
+        return out;
+    }
+
+    void MapChunkStreamer::instantiate(const std::size_t chunk, maploader::MapChunkData data)
+    {
+        const auto& source = registry->ctx().get<maploader::MapChunkSource>();
+        maploader::CommitMapChunkModels(data);
+        // Any that were released while the chunk was being read are read again now.
+        for (const auto model : source.index.chunks[chunk].models)
+        {
+            if (modelUsers[model]++ == 0) maploader::LoadMapChunkModel(source, model);
+        }
+
+        chunks[chunk].entities = maploader::InstantiateMapChunk(registry, data.View());
+        chunks[chunk].state = ChunkState::Loaded;
+        for (const auto entity : chunks[chunk].entities)
+        {
+            onEntityStreamedIn.Publish(entity);
+        }
+    }
+
+    void MapChunkStreamer::unload(const std::size_t chunk)
+    {
+        for (const auto entity : chunks[chunk].entities)
+        {
+            if (registry->valid(entity)) registry->destroy(entity);
+        }
+        chunks[chunk].entities.clear();
+        chunks[chunk].state = ChunkState::Unloaded;
+
+        // Destroying the collideables may have cleared their squares.
+        const auto& source = registry->ctx().get<maploader::MapChunkSource>();
+        const auto& info = source.index.chunks[chunk];
+        for (const auto& obstacle : info.obstacles)
+        {
+            sys->engine.navigationGridSystem->MarkSquareAreaOccupied(obstacle, true);
+        }
+
+        for (const auto model : info.models)
+        {
+            if (--modelUsers[model] > 0) continue;
+            sys->lodSystem->ForgetModel(source.index.models[model].key);
+            maploader::ReleaseMapChunkModel(source, model);
+        }
+    }
+
+    void MapChunkStreamer::Init()
+    {
+        for (auto& chunk : chunks)
+        {
+            if (chunk.state == ChunkState::Loading) chunk.pending.wait();
+        }
+        chunks.clear();
+        modelUsers.clear();
+
+        const auto* source = registry->ctx().find<maploader::MapChunkSource>();
+        if (source == nullptr) return;
+        chunks.resize(source->index.chunks.size());
+        modelUsers.assign(source->index.models.size(), 0);
+
+        // Unloaded chunks still have to block pathfinding.
+        for (const auto& chunk : source->index.chunks)
+        {
+            for (const auto& obstacle : chunk.obstacles)
+            {
+                sys->engine.navigationGridSystem->MarkSquareAreaOccupied(obstacle, true);
+            }
+        }
+    }
+
+    void MapChunkStreamer::LoadAround(const Vector3 point)
+    {
+        if (chunks.empty()) return;
+        const auto& source = registry->ctx().get<maploader::MapChunkSource>();
+        const std::vector points{point};
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            if (chunks[i].state != ChunkState::Unloaded || distanceTo(i, points) > loadRadius) continue;
+            instantiate(i, maploader::ReadMapChunk(source.file, source.index.chunks[i], modelsToRead(i)));
+        }
+    }
+
+    void MapChunkStreamer::Update()
+    {
+        if (chunks.empty()) return;
+        const auto& source = registry->ctx().get<maploader::MapChunkSource>();
+        const auto points = focusPoints();
+
+        unsigned int instantiated = 0;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            auto& chunk = chunks[i];
+            const auto distance = distanceTo(i, points);
+            switch (chunk.state)
+            {
+            case ChunkState::Unloaded:
+                if (distance <= loadRadius)
+                {
+                    chunk.pending = std::async(
+                        std::launch::async,
+                        maploader::ReadMapChunk,
+                        source.file,
+                        source.index.chunks[i],
+                        modelsToRead(i));
+                    chunk.state = ChunkState::Loading;
+                }
+                break;
+            case ChunkState::Loading:
+                if (instantiated >= maxInstantiationsPerFrame ||
+                    chunk.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    break;
+                }
+                try
+                {
+                    auto data = chunk.pending.get();
+                    // Left the radius while loading, drop it rather than spawning something to unload next frame.
+                    if (distance > unloadRadius)
+                    {
+                        chunk.state = ChunkState::Unloaded;
+                        break;
+                    }
+                    instantiate(i, std::move(data));
+                    ++instantiated;
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "ERROR: MapChunkStreamer -> " << e.what() << std::endl;
+                    chunk.state = ChunkState::Failed;
+                }
+                break;
+            case ChunkState::Loaded:
+                if (distance > unloadRadius) unload(i);
+                break;
+            case ChunkState::Failed:
+                break;
+            }
+        }
+    }
+
+    std::size_t MapChunkStreamer::LoadedChunkCount() const
+    {
+        return std::ranges::count_if(chunks, [](const Chunk& chunk) { return chunk.state == ChunkState::Loaded; });
+    }
+
+    MapChunkStreamer::MapChunkStreamer(entt::registry* _registry, Systems* _sys) : registry(_registry), sys(_sys)
+    {
+    }
+} // namespace lq
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "engine/Event.hpp"
+
+#include "MapLoader.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <future>
+#include <vector>
+
+namespace lq
+{
+    class Systems;
+
+    // Streams the static geometry chunks of the loaded map (see maploader::MapChunkIndex) in and out around the
+    // camera and the party. Chunks are read and decompressed on a worker thread (uncompressed ones are used in
+    // place from the mapped ".chunks" file), together with whichever of their models aren't loaded yet.
+    // Entities are created on the main thread, at most a few chunks per frame. A chunk model stays in the
+    // ResourceManager while any loaded chunk uses it.
+    class MapChunkStreamer
+    {
+        enum class ChunkState
+        {
+            Unloaded,
+            Loading,
+            Loaded,
+            Failed // Not retried, the error has been reported
+        };
+
+        struct Chunk
+        {
+            ChunkState state = ChunkState::Unloaded;
+            std::future<maploader::MapChunkData> pending;
+            std::vector<entt::entity> entities;
+        };
+
+        entt::registry* registry;
+        Systems* sys;
+        std::vector<Chunk> chunks;
+        std::vector<int> modelUsers; // Loaded chunks using each of MapChunkIndex::models
+
+        [[nodiscard]] std::vector<Vector3> focusPoints() const;
+        [[nodiscard]] float distanceTo(std::size_t chunk, const std::vector<Vector3>& points) const;
+        [[nodiscard]] std::vector<maploader::MapChunkModel> modelsToRead(std::size_t chunk) const;
+        void instantiate(std::size_t chunk, maploader::MapChunkData data);
+        void unload(std::size_t chunk);
+
+      public:
+        // Chunks closer than loadRadius (XZ distance to their bounds) are loaded, chunks further than
+        // unloadRadius are unloaded. The gap between the two stops chunks on a boundary from thrashing.
+        float loadRadius = 120.0f;
+        float unloadRadius = 160.0f;
+        unsigned int maxInstantiationsPerFrame = 2;
+
+        sage::Event<entt::entity> onEntityStreamedIn;
+
+        // Reads the chunk index LoadMap left in the registry context and marks every chunk's obstacles on the
+        // navigation grid. Call after the grid has been populated.
+        void Init();
+        // Synchronously loads every chunk within loadRadius of 'point' (e.g. the party's spawn).
+        void LoadAround(Vector3 point);
+        void Update();
+
+        [[nodiscard]] std::size_t LoadedChunkCount() const;
+
+        MapChunkStreamer(entt::registry* _registry, Systems* _sys);
+    };
+} // namespace lq
@@ -185,10 +185,16 @@ namespace lq
             if (!ab.IsActive() && !inCursorSelect) continue;
 
             std::visit([this, entity](auto& cur) { cur.Update(*this, entity); }, state.current);
+        }
+    }
 
-            if (auto* vfx = ab.GetVfx(registry); vfx && vfx->active)
+    void AbilityStateMachine::UpdateVisuals(const float dt)
+    {
+        for (const auto view = registry->view<Ability>(); const auto entity : view)
+        {
+            if (auto* vfx = registry->get<Ability>(entity).GetVfx(registry); vfx && vfx->active)
             {
-                vfx->Update(GetFrameTime());
+                vfx->Update(dt);
             }
         }
     }
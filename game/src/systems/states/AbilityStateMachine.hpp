@@ -46,7 +46,10 @@ namespace lq
         }
 
       public:
+        // Simulation step: ability states and their timers.
         void Update();
+        // Per rendered frame: advances the VFX of active abilities by 'dt'.
+        void UpdateVisuals(float dt);
         void Draw3D();
 
         ~AbilityStateMachine() = default;
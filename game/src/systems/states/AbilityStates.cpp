@@ -9,6 +9,7 @@
 #include "engine/components/MoveableActor.hpp"
 #include "engine/Cursor.hpp"
 #include "engine/Timer.hpp"
+#include "SimulationClock.hpp"
 #include "Systems.hpp"
 
 #include "raylib.h"
@@ -28,7 +29,7 @@ namespace lq
         auto* registry = machine.registry;
         auto& ab = registry->get<Ability>(entity);
         const auto& ad = registry->get<AbilityData>(entity);
-        ab.cooldownTimer.Update(GetFrameTime());
+        ab.cooldownTimer.Update(registry->ctx().get<SimulationClock>().DeltaTime());
         if (ab.cooldownTimer.HasFinished() && ad.base.HasOptionalBehaviour(AbilityBehaviourOptional::REPEAT_AUTO))
         {
             machine.startCast(entity);
@@ -85,7 +86,7 @@ namespace lq
     {
         auto* registry = machine.registry;
         auto& ab = registry->get<Ability>(entity);
-        ab.castTimer.Update(GetFrameTime());
+        ab.castTimer.Update(registry->ctx().get<SimulationClock>().DeltaTime());
         const auto& ad = registry->get<AbilityData>(entity);
 
         // "executionDelayTimer" should just be a cast timer. Therefore, below should check for cast time
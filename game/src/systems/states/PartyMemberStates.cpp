@@ -3,6 +3,7 @@
 #include "PartyMemberStateMachine.hpp"
 #include "animation/RpgAnimationIds.hpp"
 
+#include "SimulationClock.hpp"
 #include "Systems.hpp"
 #include "components/PartyMemberComponent.hpp"
 #include "engine/components/Animation.hpp"
@@ -63,7 +64,8 @@ namespace lq
             machinePtr->ChangeState(
                 e,
                 PartyMemberDestinationUnreachableState{
-                    .originalDestination = requestedPos, .timeStart = GetTime()});
+                    .originalDestination = requestedPos,
+                    .timeStart = machinePtr->registry->ctx().get<SimulationClock>().Time()});
         };
 
         state.BindSubscription(moveable.onDestinationReached.Subscribe(onTargetReached));
@@ -177,10 +179,11 @@ namespace lq
             return;
         }
 
-        if (GetTime() < timeStart + RETRY_TIME_THRESHOLD) return;
+        const auto now = registry->ctx().get<SimulationClock>().Time();
+        if (now < timeStart + RETRY_TIME_THRESHOLD) return;
 
         ++tryCount;
-        timeStart = GetTime();
+        timeStart = now;
         if (sys->engine.actorMovementSystem->TryPathfindToLocation(entity, originalDestination, true))
         {
             machine.ChangeState(entity, PartyMemberFollowingLeaderState{});
@@ -1,5 +1,6 @@
 #include "StateMachines.hpp"
 
+#include "FrameProfiler.hpp"
 #include "scenes/Scene.hpp"
 #include "Systems.hpp"
 
@@ -7,11 +8,31 @@ namespace lq
 {
     void StateMachines::Update() const
     {
-        gameModeStateMachine->Update();
-        wavemobStatemachine->Update();
-        playerStateMachine->Update();
-        partyMemberStateMachine->Update();
-        abilityStateMachine->Update();
+        {
+            ProfileScope scope("gameModeStateMachine");
+            gameModeStateMachine->Update();
+        }
+        {
+            ProfileScope scope("wavemobStateMachine");
+            wavemobStatemachine->Update();
+        }
+        {
+            ProfileScope scope("playerStateMachine");
+            playerStateMachine->Update();
+        }
+        {
+            ProfileScope scope("partyMemberStateMachine");
+            partyMemberStateMachine->Update();
+        }
+        {
+            ProfileScope scope("abilityStateMachine");
+            abilityStateMachine->Update();
+        }
+    }
+
+    void StateMachines::UpdateVisuals(const float dt) const
+    {
+        abilityStateMachine->UpdateVisuals(dt);
     }
 
     void StateMachines::Draw3D() const
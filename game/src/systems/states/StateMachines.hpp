@@ -24,7 +24,9 @@ namespace lq
         std::unique_ptr<PlayerStateMachine> playerStateMachine;
         std::unique_ptr<PartyMemberStateMachine> partyMemberStateMachine;
         std::unique_ptr<AbilityStateMachine> abilityStateMachine;
+        // Simulation step, see SimulationClock.
         void Update() const;
+        void UpdateVisuals(float dt) const;
         void Draw3D() const;
         StateMachines(entt::registry* _registry, Systems* _sys);
     };
@@ -7,6 +7,7 @@
 #include "collision/RpgCollisionLayers.hpp"
 #include "components/Ability.hpp"
 #include "components/CombatableActor.hpp"
+#include "StaticCollisionBvh.hpp"
 
 #include "engine/components/Animation.hpp"
 #include "engine/components/DeleteEntityComponent.hpp"
@@ -39,10 +40,26 @@ namespace lq
         ray.direction.y = trans.GetWorldPos().y + height;
         trans.movementDirectionDebugLine = ray;
 
-        const auto collisions =
-            sys->engine.collisionSystem->GetCollisionsWithRay(entity, ray, collideable.collidesWith);
+        bool blocked;
+        if (const auto* bvh = registry->ctx().find<StaticCollisionBvh>())
+        {
+            // Map geometry comes from the map's baked BVH. Building is the only static layer enemies collide
+            // with, and the other layer they do (the player) can't block sight to the player.
+            const Vector3 eye{trans.GetWorldPos().x, trans.GetWorldPos().y + height, trans.GetWorldPos().z};
+            const Vector3 targetEye{targetPos.x, targetPos.y + height, targetPos.z};
+            const Ray sight{eye, Vector3Normalize(Vector3Subtract(targetEye, eye))};
+            blocked = bvh->FirstHit(*registry, sight, Vector3Distance(eye, targetEye), [](const auto layer) {
+                            return layer == lq::collision_layers::Building;
+                        }).has_value();
+        }
+        else
+        {
+            const auto collisions =
+                sys->engine.collisionSystem->GetCollisionsWithRay(entity, ray, collideable.collidesWith);
+            blocked = !collisions.empty() && collisions.at(0).collisionLayer != lq::collision_layers::Player;
+        }
 
-        if (!collisions.empty() && collisions.at(0).collisionLayer != lq::collision_layers::Player)
+        if (blocked)
         {
             // Lost line of sight, out of combat
             combatable.target = entt::null;
@@ -0,0 +1,284 @@
+#include "AnimationCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace lq::packed
+{
+    namespace
+    {
+        constexpr float kSqrtHalf = 0.70710678f;
+        constexpr float kRotationScale = 32767.0f;
+
+        Vector3 lerp(const Vector3& a, const Vector3& b, const float t)
+        {
+            return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+        }
+
+        float dot(const Quaternion& a, const Quaternion& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+        }
+
+        Quaternion normalize(const Quaternion& q)
+        {
+            const float length = std::sqrt(dot(q, q));
+            if (length == 0.0f) return {0, 0, 0, 1};
+            return {q.x / length, q.y / length, q.z / length, q.w / length};
+        }
+
+        // Normalised lerp along the shorter arc. Close enough to slerp between neighbouring keys.
+        Quaternion nlerp(const Quaternion& a, Quaternion b, const float t)
+        {
+            if (dot(a, b) < 0.0f) b = {-b.x, -b.y, -b.z, -b.w};
+            return normalize(
+                {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t});
+        }
+
+        // Greedily keeps the fewest frames of 'samples' that reproduce every frame of 'exact' (by linear
+        // interpolation between kept frames) within 'fits'. A single kept frame means the track is constant.
+        template <typename T, typename Lerp, typename Fits>
+        std::vector<std::uint16_t> reduceKeys(
+            const std::vector<T>& samples, const std::vector<T>& exact, Lerp interpolate, Fits fits)
+        {
+            std::vector<std::uint16_t> keys{0};
+            const auto count = samples.size();
+            if (std::ranges::all_of(exact, [&](const T& value) { return fits(samples[0], value); })) return keys;
+
+            const auto spanFits = [&](const std::size_t from, const std::size_t to) {
+                for (std::size_t f = from + 1; f < to; ++f)
+                {
+                    const float t = static_cast<float>(f - from) / static_cast<float>(to - from);
+                    if (!fits(interpolate(samples[from], samples[to], t), exact[f])) return false;
+                }
+                return true;
+            };
+            std::size_t from = 0;
+            while (from + 1 < count)
+            {
+                auto to = from + 1;
+                while (to + 1 < count && spanFits(from, to + 1))
+                {
+                    ++to;
+                }
+                keys.push_back(static_cast<std::uint16_t>(to));
+                from = to;
+            }
+            return keys;
+        }
+
+        Vector3Track compressVector3s(const std::vector<Vector3>& exact, const float tolerance)
+        {
+            const auto fits = [tolerance](const Vector3& a, const Vector3& b) {
+                const float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+                return dx * dx + dy * dy + dz * dz <= tolerance * tolerance;
+            };
+            Vector3Track out;
+            out.frames = reduceKeys(exact, exact, lerp, fits);
+            for (const auto frame : out.frames)
+            {
+                out.values.insert(out.values.end(), {exact[frame].x, exact[frame].y, exact[frame].z});
+            }
+            return out;
+        }
+
+        RotationTrack compressRotations(const std::vector<Quaternion>& exact, const float tolerance)
+        {
+            // Keys are picked from the quantized rotations, so the tolerance covers the quantization error too.
+            std::vector<std::uint16_t> encoded(exact.size() * 3);
+            std::vector<Quaternion> samples(exact.size());
+            for (std::size_t f = 0; f < exact.size(); ++f)
+            {
+                EncodeRotation(exact[f], &encoded[f * 3]);
+                samples[f] = DecodeRotation(&encoded[f * 3]);
+            }
+            // Unit quaternions an angle apart are 2 sin(angle / 4) apart (on the closer of q and -q). Unlike the
+            // dot product, that's still precise in floats at these tolerances.
+            const float chord = 2.0f * std::sin(tolerance * 0.25f);
+            const auto fits = [chord](const Quaternion& a, const Quaternion& b) {
+                const Quaternion d{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+                const Quaternion s{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+                return std::min(dot(d, d), dot(s, s)) <= chord * chord;
+            };
+            RotationTrack out;
+            out.frames = reduceKeys(samples, exact, nlerp, fits);
+            for (const auto frame : out.frames)
+            {
+                out.values.insert(out.values.end(), &encoded[frame * 3], &encoded[frame * 3] + 3);
+            }
+            return out;
+        }
+
+        // Calls write(frame, value) for every frame of a track.
+        template <typename T, typename Decode, typename Lerp, typename Write>
+        void expandTrack(
+            const std::vector<std::uint16_t>& frames,
+            const int frameCount,
+            Decode decode,
+            Lerp interpolate,
+            Write write)
+        {
+            if (frames.empty()) return;
+            std::size_t key = 0;
+            T from = decode(0);
+            T to = frames.size() > 1 ? decode(1) : from;
+            for (int f = 0; f < frameCount; ++f)
+            {
+                while (key + 1 < frames.size() && frames[key + 1] <= f)
+                {
+                    ++key;
+                    from = to;
+                    if (key + 1 < frames.size()) to = decode(key + 1);
+                }
+                if (key + 1 >= frames.size())
+                {
+                    write(f, from);
+                    continue;
+                }
+                const float t =
+                    static_cast<float>(f - frames[key]) / static_cast<float>(frames[key + 1] - frames[key]);
+                write(f, interpolate(from, to, t));
+            }
+        }
+    } // namespace
+
+    void EncodeRotation(const Quaternion rotation, std::uint16_t* out)
+    {
+        const auto q = normalize(rotation);
+        float components[4]{q.x, q.y, q.z, q.w};
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (std::fabs(components[i]) > std::fabs(components[largest])) largest = i;
+        }
+        // q and -q are the same rotation, make the dropped component positive.
+        const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+        for (int i = 0, o = 0; i < 4; ++i)
+        {
+            if (i == largest) continue;
+            const float unit = std::clamp(components[i] * sign / kSqrtHalf * 0.5f + 0.5f, 0.0f, 1.0f);
+            out[o++] = static_cast<std::uint16_t>(std::lround(unit * kRotationScale));
+        }
+        out[0] |= static_cast<std::uint16_t>((largest & 1) << 15);
+        out[1] |= static_cast<std::uint16_t>((largest >> 1) << 15);
+    }
+
+    Quaternion DecodeRotation(const std::uint16_t* in)
+    {
+        const int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+        float components[4]{};
+        float sum = 0.0f;
+        for (int i = 0, o = 0; i < 4; ++i)
+        {
+            if (i == largest) continue;
+            const float unit = static_cast<float>(in[o++] & 0x7fffu) / kRotationScale;
+            components[i] = (unit * 2.0f - 1.0f) * kSqrtHalf;
+            sum += components[i] * components[i];
+        }
+        components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+        return normalize({components[0], components[1], components[2], components[3]});
+    }
+
+    bool CanCompressClip(const ModelAnimation& animation)
+    {
+        return animation.frameCount > 0 && animation.frameCount <= std::numeric_limits<std::uint16_t>::max();
+    }
+
+    CompressedClip CompressClip(const ModelAnimation& animation, const AnimationTolerances& tolerances)
+    {
+        CompressedClip clip;
+        clip.name = animation.name;
+        clip.frameCount = animation.frameCount;
+
+        // Translation tolerance scales with the rig, which may be authored in any unit.
+        float extent = 0.0f;
+        for (int f = 0; f < animation.frameCount; ++f)
+        {
+            for (int b = 0; b < animation.boneCount; ++b)
+            {
+                const auto& t = animation.framePoses[f][b].translation;
+                extent = std::max(extent, std::sqrt(t.x * t.x + t.y * t.y + t.z * t.z));
+            }
+        }
+        const float translationTolerance = tolerances.translation * std::max(extent, 1e-6f);
+
+        const auto frames = static_cast<std::size_t>(animation.frameCount);
+        std::vector<Vector3> translations(frames), scales(frames);
+        std::vector<Quaternion> rotations(frames);
+        for (int b = 0; b < animation.boneCount; ++b)
+        {
+            clip.boneNames.emplace_back(animation.bones[b].name);
+            clip.boneParents.push_back(animation.bones[b].parent);
+            for (std::size_t f = 0; f < frames; ++f)
+            {
+                const auto& pose = animation.framePoses[f][b];
+                translations[f] = pose.translation;
+                rotations[f] = pose.rotation;
+                scales[f] = pose.scale;
+            }
+            clip.translations.push_back(compressVector3s(translations, translationTolerance));
+            clip.rotations.push_back(compressRotations(rotations, tolerances.rotation));
+            clip.scales.push_back(compressVector3s(scales, tolerances.scale));
+        }
+        return clip;
+    }
+
+    void DecompressClip(const CompressedClip& clip, ModelAnimation& animation)
+    {
+        const auto boneCount = static_cast<int>(clip.boneNames.size());
+        animation.boneCount = boneCount;
+        animation.frameCount = clip.frameCount;
+        std::strncpy(animation.name, clip.name.c_str(), sizeof(animation.name) - 1);
+
+        animation.bones = static_cast<BoneInfo*>(RL_CALLOC(boneCount, sizeof(BoneInfo)));
+        for (int b = 0; b < boneCount; ++b)
+        {
+            std::strncpy(animation.bones[b].name, clip.boneNames[b].c_str(), sizeof(animation.bones[b].name) - 1);
+            animation.bones[b].parent = clip.boneParents[b];
+        }
+
+        animation.framePoses = static_cast<Transform**>(RL_MALLOC(clip.frameCount * sizeof(Transform*)));
+        for (int f = 0; f < clip.frameCount; ++f)
+        {
+            animation.framePoses[f] = static_cast<Transform*>(RL_MALLOC(boneCount * sizeof(Transform)));
+        }
+
+        for (int b = 0; b < boneCount; ++b)
+        {
+            const auto expandVector3s = [&](const Vector3Track& track, Vector3 Transform::*member) {
+                expandTrack<Vector3>(
+                    track.frames,
+                    clip.frameCount,
+                    [&track](const std::size_t key) {
+                        const float* v = &track.values[key * 3];
+                        return Vector3{v[0], v[1], v[2]};
+                    },
+                    lerp,
+                    [&](const int f, const Vector3& value) { animation.framePoses[f][b].*member = value; });
+            };
+            expandVector3s(clip.translations[b], &Transform::translation);
+            expandVector3s(clip.scales[b], &Transform::scale);
+
+            const auto& rotations = clip.rotations[b];
+            expandTrack<Quaternion>(
+                rotations.frames,
+                clip.frameCount,
+                [&rotations](const std::size_t key) { return DecodeRotation(&rotations.values[key * 3]); },
+                nlerp,
+                [&](const int f, const Quaternion& value) { animation.framePoses[f][b].rotation = value; });
+        }
+    }
+
+    std::size_t RawAnimationBytes(const ModelAnimation* animations, const int count)
+    {
+        std::size_t bytes = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& animation = animations[i];
+            bytes += static_cast<std::size_t>(animation.frameCount) * animation.boneCount * sizeof(Transform);
+        }
+        return bytes;
+    }
+} // namespace lq::packed
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Lossy storage for raylib ModelAnimation clips (see PackedModel.hpp). Every bone gets a translation, rotation
+// and scale track. Tracks that don't change are stored once, and frames that linear interpolation between the
+// kept keys reproduces within tolerance are dropped. Rotations are stored "smallest three" in 48 bits.
+// The engine samples full per-frame poses, so clips are expanded back into that layout when decoded. That's a
+// few lerps per bone and frame, once per clip.
+namespace lq::packed
+{
+    struct AnimationTolerances
+    {
+        float rotation = 0.001f;     // Radians
+        float translation = 0.0002f; // Share of the largest bone translation in the clip
+        float scale = 0.0005f;
+    };
+
+    struct Vector3Track
+    {
+        std::vector<std::uint16_t> frames; // Kept frames, always starts at 0. One entry is a constant track.
+        std::vector<float> values;         // 3 per kept frame
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(frames, values);
+        }
+    };
+
+    struct RotationTrack
+    {
+        std::vector<std::uint16_t> frames;
+        std::vector<std::uint16_t> values; // 3 per kept frame, see EncodeRotation
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(frames, values);
+        }
+    };
+
+    struct CompressedClip
+    {
+        std::string name;
+        int frameCount = 0;
+        std::vector<std::string> boneNames;
+        std::vector<int> boneParents;
+        std::vector<Vector3Track> translations; // Per bone
+        std::vector<RotationTrack> rotations;
+        std::vector<Vector3Track> scales;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(name, frameCount, boneNames, boneParents, translations, rotations, scales);
+        }
+    };
+
+    // Largest component dropped (it's recovered from the unit length), the other three as 15 bit values, the
+    // dropped component's index in the top bits of the first two.
+    void EncodeRotation(Quaternion rotation, std::uint16_t* out);
+    [[nodiscard]] Quaternion DecodeRotation(const std::uint16_t* in);
+
+    // Clips with more than 65535 frames can't be compressed; check with CanCompressClip.
+    [[nodiscard]] bool CanCompressClip(const ModelAnimation& animation);
+    [[nodiscard]] CompressedClip CompressClip(
+        const ModelAnimation& animation, const AnimationTolerances& tolerances);
+    // Fills 'animation' with RL_MALLOC'd buffers, in the layout LoadModelAnimations produces.
+    void DecompressClip(const CompressedClip& clip, ModelAnimation& animation);
+
+    // Size of a clip's per-frame poses, as raylib keeps them.
+    [[nodiscard]] std::size_t RawAnimationBytes(const ModelAnimation* animations, int count);
+} // namespace lq::packed
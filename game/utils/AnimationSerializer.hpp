@@ -0,0 +1,65 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/string.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+// Binary (de)serialisation of raylib ModelAnimation arrays, as stored in ResourceManager::modelAnimations.
+// Buffers are allocated with RL_MALLOC so the result can be released with UnloadModelAnimations.
+namespace lq::serializer
+{
+    template <class Archive>
+    void SaveModelAnimations(Archive& archive, const ModelAnimation* animations, const int count)
+    {
+        archive(count);
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& anim = animations[i];
+            archive(anim.boneCount, anim.frameCount, std::string(anim.name));
+            for (int b = 0; b < anim.boneCount; ++b)
+            {
+                archive(std::string(anim.bones[b].name), anim.bones[b].parent);
+            }
+            for (int f = 0; f < anim.frameCount; ++f)
+            {
+                archive(cereal::binary_data(anim.framePoses[f], sizeof(Transform) * anim.boneCount));
+            }
+        }
+    }
+
+    template <class Archive>
+    std::pair<ModelAnimation*, int> LoadModelAnimations(Archive& archive)
+    {
+        int count = 0;
+        archive(count);
+        auto* animations = static_cast<ModelAnimation*>(RL_CALLOC(count, sizeof(ModelAnimation)));
+        for (int i = 0; i < count; ++i)
+        {
+            auto& anim = animations[i];
+            std::string name;
+            archive(anim.boneCount, anim.frameCount, name);
+            std::strncpy(anim.name, name.c_str(), sizeof(anim.name) - 1);
+
+            anim.bones = static_cast<BoneInfo*>(RL_CALLOC(anim.boneCount, sizeof(BoneInfo)));
+            for (int b = 0; b < anim.boneCount; ++b)
+            {
+                std::string boneName;
+                archive(boneName, anim.bones[b].parent);
+                std::strncpy(anim.bones[b].name, boneName.c_str(), sizeof(anim.bones[b].name) - 1);
+            }
+
+            anim.framePoses = static_cast<Transform**>(RL_MALLOC(anim.frameCount * sizeof(Transform*)));
+            for (int f = 0; f < anim.frameCount; ++f)
+            {
+                anim.framePoses[f] = static_cast<Transform*>(RL_MALLOC(anim.boneCount * sizeof(Transform)));
+                archive(cereal::binary_data(anim.framePoses[f], sizeof(Transform) * anim.boneCount));
+            }
+        }
+        return {animations, count};
+    }
+} // namespace lq::serializer
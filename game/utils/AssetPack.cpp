@@ -0,0 +1,149 @@
+#include "AssetPack.hpp"
+
+#include "FramedCompression.hpp"
+#include "MemoryStream.hpp"
+#include "PackedModel.hpp"
+
+#include "engine/raylib-cereal.hpp"
+#include "engine/Serializer.hpp"
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace lq
+{
+    std::string_view AssetPack::entryData(const AssetPackEntry& entry, std::string& scratch) const
+    {
+        if (entry.offset + entry.size > file->Size())
+        {
+            throw std::runtime_error("Entry '" + entry.key + "' lies outside of " + path);
+        }
+        const auto* stored = file->Data() + entry.offset;
+        if (entry.compression == AssetPackEntry::Compression::None)
+        {
+            return {reinterpret_cast<const char*>(stored), entry.size};
+        }
+        if (entry.compression == AssetPackEntry::Compression::Framed)
+        {
+            try
+            {
+                scratch = framed::Decompress({reinterpret_cast<const char*>(stored), entry.size}, 0);
+            }
+            catch (const std::runtime_error&)
+            {
+                scratch.clear();
+            }
+            if (scratch.size() != entry.rawSize)
+            {
+                throw std::runtime_error("Corrupt entry '" + entry.key + "' in " + path);
+            }
+            return scratch;
+        }
+
+        int size = 0;
+        auto* data = DecompressData(stored, static_cast<int>(entry.size), &size);
+        if (data == nullptr || static_cast<std::uint32_t>(size) != entry.rawSize)
+        {
+            MemFree(data);
+            throw std::runtime_error("Corrupt entry '" + entry.key + "' in " + path);
+        }
+        scratch.assign(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+        MemFree(data);
+        return scratch;
+    }
+
+    void AssetPack::Open(entt::registry* registry, const char* _path)
+    {
+        std::cout << "START: Loading asset pack \n";
+        path = _path;
+        models.clear();
+        animations.clear();
+        file.emplace(path);
+
+        AssetPackHeader header{};
+        if (file->Size() >= sizeof(header)) std::memcpy(&header, file->Data(), sizeof(header));
+        if (header.magic != kAssetPackMagic)
+        {
+            std::cout << "WARNING: AssetPack -> " << path
+                      << " has no table of contents, loading it whole. Re-run respacker to enable lazy loading."
+                      << std::endl;
+            file.reset();
+            sage::serializer::LoadAssetBinFile(registry, path.c_str());
+            return;
+        }
+        if (header.version != kAssetPackVersion)
+        {
+            throw std::runtime_error(
+                path + " was packed with asset pack version " + std::to_string(header.version) + ", expected " +
+                std::to_string(kAssetPackVersion) + ". Re-run respacker.");
+        }
+        if (header.tocOffset > file->Size())
+        {
+            throw std::runtime_error(path + " is truncated.");
+        }
+
+        std::vector<AssetPackEntry> toc;
+        {
+            MemoryIStream stream(file->View().substr(header.tocOffset));
+            cereal::BinaryInputArchive archive(stream);
+            archive(toc);
+        }
+
+        std::string scratch;
+        for (auto& entry : toc)
+        {
+            switch (entry.kind)
+            {
+            case AssetPackEntry::Kind::Core: {
+                MemoryIStream stream(entryData(entry, scratch));
+                cereal::BinaryInputArchive archive(stream);
+                archive(sage::ResourceManager::GetInstance());
+                break;
+            }
+            case AssetPackEntry::Kind::Model: {
+                auto key = entry.key;
+                models.emplace(std::move(key), std::move(entry));
+                break;
+            }
+            case AssetPackEntry::Kind::Animation: {
+                auto key = entry.key;
+                animations.emplace(std::move(key), std::move(entry));
+                break;
+            }
+            }
+        }
+        std::cout << "FINISH: Loading asset pack (" << models.size() << " model(s), " << animations.size()
+                  << " animation set(s) deferred) \n";
+    }
+
+    void AssetPack::Require(const std::string& key)
+    {
+        auto& rm = sage::ResourceManager::GetInstance();
+        std::string scratch;
+        if (!rm.modelCopies.contains(key))
+        {
+            if (const auto it = models.find(key); it != models.end())
+            {
+                rm.modelCopies.try_emplace(key, packed::DecodeModel(entryData(it->second, scratch)));
+            }
+        }
+        if (!rm.modelAnimations.contains(key))
+        {
+            if (const auto it = animations.find(key); it != animations.end())
+            {
+                rm.modelAnimations.try_emplace(key, packed::DecodeAnimations(entryData(it->second, scratch)));
+            }
+        }
+    }
+
+    bool AssetPack::Contains(const std::string& key) const
+    {
+        return models.contains(key) || animations.contains(key);
+    }
+} // namespace lq
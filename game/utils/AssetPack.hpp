@@ -0,0 +1,120 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include "engine/ResourceManager.hpp"
+
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace lq
+{
+    // assets.bin layout:
+    //   AssetPackHeader
+    //   entry data, every entry compressed on its own or stored as is
+    //   table of contents (cereal binary vector<AssetPackEntry>, uncompressed) at header.tocOffset
+    // The Core entry is the ResourceManager minus its models and animations (images, fonts, materials, shaders)
+    // and is loaded up front. Model and Animation entries are keyed like ResourceManager::modelCopies and
+    // ResourceManager::modelAnimations and are only read the first time something asks for that key.
+    // The file is memory mapped. Stored (uncompressed) entries are deserialized straight out of the mapping, so
+    // loading one costs no read or decompression buffer, and untouched entries never leave the page cache.
+    inline constexpr std::uint32_t kAssetPackMagic = 0x4b50514c; // "LQPK"
+    // 1: initial table of contents layout
+    // 2: per-entry compression
+    // 3: model entries may hold quantized vertex attributes
+    // 4: animation entries may hold compressed clips
+    // 5: compressed entries are frames of independent blocks (FramedCompression.hpp)
+    inline constexpr std::uint32_t kAssetPackVersion = 5;
+
+    struct AssetPackHeader
+    {
+        std::uint32_t magic = kAssetPackMagic;
+        std::uint32_t version = kAssetPackVersion;
+        std::uint64_t tocOffset = 0;
+        std::uint32_t entryCount = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    struct AssetPackEntry
+    {
+        enum class Kind : std::uint8_t
+        {
+            Core,
+            Model,
+            Animation
+        };
+
+        enum class Compression : std::uint8_t
+        {
+            None,
+            Deflate,
+            Framed // Large entries decompress on every core
+        };
+
+        std::string key;
+        Kind kind = Kind::Core;
+        Compression compression = Compression::Framed;
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0;    // As stored in the file
+        std::uint32_t rawSize = 0; // Decompressed
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(key, kind, compression, offset, size, rawSize);
+        }
+    };
+
+    // Runtime side of the asset pack. Models and animations are pulled into the ResourceManager on first use,
+    // so the game should fetch models through GetModelView/CreateModelMutable here rather than on the
+    // ResourceManager directly.
+    class AssetPack
+    {
+        std::string path;
+        std::optional<MappedFile> file;
+        // Key -> entry, one table per kind
+        std::unordered_map<std::string, AssetPackEntry> models;
+        std::unordered_map<std::string, AssetPackEntry> animations;
+
+        AssetPack() = default;
+        // Returns a view of the entry's bytes: into the mapping if it's stored, else into 'scratch'.
+        [[nodiscard]] std::string_view entryData(const AssetPackEntry& entry, std::string& scratch) const;
+
+      public:
+        static AssetPack& GetInstance()
+        {
+            static AssetPack instance;
+            return instance;
+        }
+
+        // Reads the table of contents and the Core entry. Falls back to loading the whole file if it's an
+        // assets.bin from before the table of contents existed.
+        void Open(entt::registry* registry, const char* _path);
+        // Loads the model (and its animations, if packed) with this key into the ResourceManager unless it's
+        // already there. Keys that aren't in the pack (e.g. map geometry) are left to the ResourceManager.
+        void Require(const std::string& key);
+        [[nodiscard]] bool Contains(const std::string& key) const;
+
+        // Same as the ResourceManager functions of the same name, but Require the key first.
+        [[nodiscard]] auto CreateModelMutable(const std::string& key)
+        {
+            Require(key);
+            return sage::ResourceManager::GetInstance().CreateModelMutable(key);
+        }
+
+        [[nodiscard]] auto GetModelView(const std::string& key)
+        {
+            Require(key);
+            return sage::ResourceManager::GetInstance().GetModelView(key);
+        }
+
+        AssetPack(const AssetPack&) = delete;
+        void operator=(const AssetPack&) = delete;
+    };
+} // namespace lq
@@ -0,0 +1,148 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace lq
+{
+    namespace
+    {
+        constexpr const char* kFrameName = "Frame";
+
+        std::uint32_t threadIndex()
+        {
+            static std::atomic<std::uint32_t> next = 0;
+            thread_local const std::uint32_t index = next++;
+            return index;
+        }
+
+        std::uint64_t nanoseconds(const FrameProfiler::Clock::duration duration)
+        {
+            return static_cast<std::uint64_t>(
+                std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+        }
+
+        void writeEscaped(std::ostream& out, const std::string_view text)
+        {
+            for (const char c : text)
+            {
+                if (c == '"' || c == '\\') out << '\\';
+                if (static_cast<unsigned char>(c) >= 0x20) out << c;
+            }
+        }
+    } // namespace
+
+    void FrameProfiler::Record(const char* name, const Clock::time_point start, const Clock::time_point end)
+    {
+        const auto index = head.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = ring[index & (kCapacity - 1)];
+        slot.sample = {
+            .name = name,
+            .startNs = nanoseconds(start - epoch),
+            .durationNs = nanoseconds(end - start),
+            .thread = threadIndex()};
+        slot.written.store(index + 1, std::memory_order_release);
+    }
+
+    bool FrameProfiler::read(const std::uint64_t index, Sample& out) const
+    {
+        const auto& slot = ring[index & (kCapacity - 1)];
+        // Not yet finished, or already overwritten by a later sample.
+        if (slot.written.load(std::memory_order_acquire) != index + 1) return false;
+        out = slot.sample;
+        return true;
+    }
+
+    void FrameProfiler::EndFrame()
+    {
+        const auto now = Clock::now();
+        // The first frame would also span everything before it, e.g. loading.
+        if (frames > 0 && enabled) Record(kFrameName, frameStart, now);
+        frameStart = now;
+
+        const auto end = head.load(std::memory_order_acquire);
+        folded = std::max(folded, end > kCapacity ? end - kCapacity : 0);
+        for (; folded < end; ++folded)
+        {
+            Sample sample;
+            if (!read(folded, sample)) continue;
+            rolling[sample.name].current += static_cast<float>(sample.durationNs) / 1e6f;
+        }
+
+        const auto frameSlot = frames % kWindow;
+        for (auto it = rolling.begin(); it != rolling.end();)
+        {
+            auto& timing = it->second;
+            timing.ms[frameSlot] = timing.current;
+            timing.current = 0;
+            // Drop names that haven't been recorded for a whole window (e.g. a system that was removed).
+            if (std::ranges::all_of(timing.ms, [](const float ms) { return ms == 0; }))
+            {
+                it = rolling.erase(it);
+                continue;
+            }
+            ++it;
+        }
+        ++frames;
+    }
+
+    std::vector<FrameProfiler::Timing> FrameProfiler::Timings() const
+    {
+        const auto window = static_cast<float>(std::clamp<std::uint64_t>(frames, 1, kWindow));
+        std::vector<Timing> timings;
+        timings.reserve(rolling.size());
+        for (const auto& [name, timing] : rolling)
+        {
+            float sum = 0;
+            float max = 0;
+            for (const float ms : timing.ms)
+            {
+                sum += ms;
+                max = std::max(max, ms);
+            }
+            timings.push_back({.name = name, .meanMs = sum / window, .maxMs = max});
+        }
+        std::ranges::sort(timings, [](const Timing& a, const Timing& b) { return a.meanMs > b.meanMs; });
+        return timings;
+    }
+
+    bool FrameProfiler::WriteChromeTrace(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+        {
+            std::cerr << "ERROR: Could not write frame trace to " << path << "\n";
+            return false;
+        }
+
+        // Complete ("X") events, timestamps in microseconds. pid is arbitrary, tid is the recording thread.
+        const auto end = head.load(std::memory_order_acquire);
+        std::size_t written = 0;
+        file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (auto index = end > kCapacity ? end - kCapacity : 0; index < end; ++index)
+        {
+            Sample sample;
+            if (!read(index, sample)) continue;
+            file << (written++ == 0 ? "\n" : ",\n") << "{\"name\":\"";
+            writeEscaped(file, sample.name);
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.thread << ",\"ts\":"
+                 << static_cast<double>(sample.startNs) / 1e3 << ",\"dur\":"
+                 << static_cast<double>(sample.durationNs) / 1e3 << "}";
+        }
+        file << "\n]}\n";
+        if (!file)
+        {
+            std::cerr << "ERROR: Could not write frame trace to " << path << "\n";
+            return false;
+        }
+        std::cout << "Frame trace: " << written << " sample(s) written to " << path << "\n";
+        return true;
+    }
+
+    FrameProfiler::FrameProfiler()
+        : ring(std::make_unique<Slot[]>(kCapacity)), epoch(Clock::now()), frameStart(epoch)
+    {
+    }
+} // namespace lq
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lq
+{
+    // Collects how long systems take, per frame. ProfileScope records a sample into a fixed ring buffer; any
+    // thread may record (SystemScheduler workers do) without taking a lock. Once per frame, the main thread calls
+    // EndFrame, which folds the frame's samples into rolling per-name timings for the overlay. The ring keeps the
+    // last kCapacity samples, which WriteChromeTrace dumps as a Chrome/Perfetto trace (chrome://tracing,
+    // ui.perfetto.dev) to find out what a spike was made of.
+    //
+    // Names must outlive the profiler (string literals, or strings owned by something that lives as long).
+    // EndFrame and the readers must not overlap with recording threads lapping the ring, i.e. call them from the
+    // main thread between frames.
+    class FrameProfiler
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr std::size_t kCapacity = 1 << 16; // Samples kept for traces, a power of two
+        static constexpr std::size_t kWindow = 120;       // Frames the rolling timings cover
+
+        struct Sample
+        {
+            const char* name = nullptr;
+            std::uint64_t startNs = 0; // Since the profiler started
+            std::uint64_t durationNs = 0;
+            std::uint32_t thread = 0;
+        };
+
+        struct Timing
+        {
+            std::string_view name;
+            float meanMs = 0; // Per frame, over the window; a name recorded twice in a frame counts both
+            float maxMs = 0;
+        };
+
+        std::atomic<bool> enabled = true;
+        bool showOverlay = false;
+
+        void Record(const char* name, Clock::time_point start, Clock::time_point end);
+        // Closes the current frame (recorded as a "Frame" sample) and updates the rolling timings.
+        void EndFrame();
+        // Slowest first; "Frame" is included.
+        [[nodiscard]] std::vector<Timing> Timings() const;
+        // Writes the samples still in the ring. Returns false if the file couldn't be written.
+        bool WriteChromeTrace(const std::string& path) const;
+
+        [[nodiscard]] std::uint64_t FrameCount() const
+        {
+            return frames;
+        }
+
+        static FrameProfiler& GetInstance()
+        {
+            static FrameProfiler instance;
+            return instance;
+        }
+
+        FrameProfiler(const FrameProfiler&) = delete;
+        void operator=(const FrameProfiler&) = delete;
+
+      private:
+        struct Slot
+        {
+            std::atomic<std::uint64_t> written = 0; // Index + 1 of the sample last completed in this slot
+            Sample sample;
+        };
+
+        struct Rolling
+        {
+            std::array<float, kWindow> ms{};
+            float current = 0; // This frame so far
+        };
+
+        std::unique_ptr<Slot[]> ring;
+        std::atomic<std::uint64_t> head = 0; // Samples ever recorded
+        std::uint64_t folded = 0;            // Samples EndFrame has looked at
+        std::uint64_t frames = 0;
+        Clock::time_point epoch;
+        Clock::time_point frameStart;
+        std::unordered_map<std::string_view, Rolling> rolling;
+
+        bool read(std::uint64_t index, Sample& out) const;
+
+        FrameProfiler();
+    };
+
+    // Times its own lifetime, e.g. `ProfileScope scope("LodSystem");`.
+    class ProfileScope
+    {
+        const char* name;
+        FrameProfiler::Clock::time_point start;
+
+      public:
+        explicit ProfileScope(const char* _name)
+            : name(FrameProfiler::GetInstance().enabled.load(std::memory_order_relaxed) ? _name : nullptr),
+              start(name != nullptr ? FrameProfiler::Clock::now() : FrameProfiler::Clock::time_point{})
+        {
+        }
+
+        ~ProfileScope()
+        {
+            if (name != nullptr) FrameProfiler::GetInstance().Record(name, start, FrameProfiler::Clock::now());
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        void operator=(const ProfileScope&) = delete;
+    };
+} // namespace lq
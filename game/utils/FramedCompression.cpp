@@ -0,0 +1,163 @@
+#include "FramedCompression.hpp"
+
+#include "MappedFile.hpp"
+#include "MemoryStream.hpp"
+#include "ParallelFor.hpp"
+
+#include "raylib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace lq::framed
+{
+    std::string Compress(const std::string_view raw, const unsigned int jobs)
+    {
+        FrameHeader header;
+        header.rawSize = raw.size();
+        header.blockCount = static_cast<std::uint32_t>((raw.size() + kBlockSize - 1) / kBlockSize);
+
+        std::vector<std::string> blocks(header.blockCount);
+        std::vector<std::uint32_t> sizes(header.blockCount);
+        ParallelFor(blocks.size(), jobs, [&](const std::size_t b) {
+            const auto block = raw.substr(b * kBlockSize, kBlockSize);
+            int compressedSize = 0;
+            auto* compressed = CompressData(
+                reinterpret_cast<const unsigned char*>(block.data()),
+                static_cast<int>(block.size()),
+                &compressedSize);
+            if (compressed != nullptr && static_cast<std::size_t>(compressedSize) < block.size())
+            {
+                blocks[b].assign(reinterpret_cast<const char*>(compressed), compressedSize);
+                sizes[b] = static_cast<std::uint32_t>(compressedSize);
+            }
+            else
+            {
+                blocks[b].assign(block);
+                sizes[b] = static_cast<std::uint32_t>(block.size()) | kStoredRaw;
+            }
+            MemFree(compressed);
+        });
+
+        std::string out;
+        std::size_t total = sizeof(header) + sizes.size() * sizeof(std::uint32_t);
+        for (const auto& block : blocks)
+        {
+            total += block.size();
+        }
+        out.reserve(total);
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.append(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(std::uint32_t));
+        for (const auto& block : blocks)
+        {
+            out.append(block);
+        }
+        return out;
+    }
+
+    std::string Decompress(const std::string_view data, const unsigned int jobs)
+    {
+        FrameHeader header;
+        if (data.size() < sizeof(header)) throw std::runtime_error("Truncated frame header");
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != kFrameMagic || header.blockSize == 0)
+        {
+            throw std::runtime_error("Not a compressed frame (written before frames were introduced?)");
+        }
+        const auto expectedBlocks = (header.rawSize + header.blockSize - 1) / header.blockSize;
+        const auto tableSize = static_cast<std::size_t>(header.blockCount) * sizeof(std::uint32_t);
+        if (header.blockCount != expectedBlocks || data.size() < sizeof(header) + tableSize)
+        {
+            throw std::runtime_error("Corrupt frame header");
+        }
+
+        std::vector<std::uint32_t> sizes(header.blockCount);
+        if (tableSize > 0) std::memcpy(sizes.data(), data.data() + sizeof(header), tableSize);
+        std::vector<std::size_t> offsets(header.blockCount);
+        std::size_t offset = sizeof(header) + tableSize;
+        for (std::size_t b = 0; b < sizes.size(); ++b)
+        {
+            offsets[b] = offset;
+            offset += sizes[b] & ~kStoredRaw;
+        }
+        if (offset > data.size()) throw std::runtime_error("Truncated frame");
+
+        std::string out(header.rawSize, '\0');
+        ParallelFor(sizes.size(), jobs, [&](const std::size_t b) {
+            const auto rawOffset = b * header.blockSize;
+            const auto rawSize = std::min<std::uint64_t>(header.blockSize, header.rawSize - rawOffset);
+            const auto stored = data.substr(offsets[b], sizes[b] & ~kStoredRaw);
+            if ((sizes[b] & kStoredRaw) != 0)
+            {
+                if (stored.size() != rawSize) throw std::runtime_error("Corrupt frame block");
+                std::memcpy(out.data() + rawOffset, stored.data(), rawSize);
+                return;
+            }
+            int size = 0;
+            auto* block = DecompressData(
+                reinterpret_cast<const unsigned char*>(stored.data()), static_cast<int>(stored.size()), &size);
+            const bool valid = block != nullptr && static_cast<std::uint64_t>(size) == rawSize;
+            if (valid) std::memcpy(out.data() + rawOffset, block, rawSize);
+            MemFree(block);
+            if (!valid) throw std::runtime_error("Corrupt frame block");
+        });
+        return out;
+    }
+
+    void WriteBinary(
+        const char* path,
+        const std::uint32_t magic,
+        const unsigned int jobs,
+        const std::function<void(cereal::BinaryOutputArchive&)>& write)
+    {
+        std::ostringstream stream(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive archive(stream);
+            write(archive);
+        }
+        const auto frame = Compress(stream.view(), jobs);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        file.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+        if (!file)
+        {
+            throw std::runtime_error(std::string("Could not write ") + path);
+        }
+    }
+
+    std::string ReadPayload(const char* path, const std::uint32_t magic, const unsigned int jobs)
+    {
+        const MappedFile file(path);
+        std::uint32_t stored = 0;
+        if (file.Size() >= sizeof(stored)) std::memcpy(&stored, file.Data(), sizeof(stored));
+        if (stored != magic)
+        {
+            throw std::runtime_error(std::string(path) + " has the wrong file type (bad magic number)");
+        }
+        try
+        {
+            return Decompress(file.View().substr(sizeof(stored)), jobs);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::runtime_error(std::string(path) + ": " + e.what() + ". Re-run respacker.");
+        }
+    }
+
+    void ReadBinary(
+        const char* path,
+        const std::uint32_t magic,
+        const unsigned int jobs,
+        const std::function<void(cereal::BinaryInputArchive&, std::istream&)>& read)
+    {
+        const auto payload = ReadPayload(path, magic, jobs);
+        MemoryIStream stream(payload);
+        cereal::BinaryInputArchive archive(stream);
+        read(archive, stream);
+    }
+} // namespace lq::framed
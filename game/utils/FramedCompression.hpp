@@ -0,0 +1,52 @@
+#pragma once
+
+#include "cereal/archives/binary.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+
+namespace lq::framed
+{
+    // A payload split into blocks of kBlockSize bytes that are DEFLATE compressed independently, so both
+    // directions spread over worker threads (see ParallelFor.hpp for 'jobs'):
+    //   FrameHeader
+    //   uint32 per block: stored size, kStoredRaw set if the block didn't compress and is kept as is
+    //   the blocks, back to back
+    // Every block but the last holds exactly blockSize raw bytes, so each one's place in the output is known
+    // before anything is decompressed.
+    inline constexpr std::uint32_t kFrameMagic = 0x4d52464c; // "LFRM"
+    inline constexpr std::uint32_t kBlockSize = 1024 * 1024;
+    inline constexpr std::uint32_t kStoredRaw = 0x80000000;
+
+    struct FrameHeader
+    {
+        std::uint32_t magic = kFrameMagic;
+        std::uint32_t blockSize = kBlockSize;
+        std::uint64_t rawSize = 0;
+        std::uint32_t blockCount = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    [[nodiscard]] std::string Compress(std::string_view raw, unsigned int jobs);
+    // Throws std::runtime_error if 'data' isn't a complete frame.
+    [[nodiscard]] std::string Decompress(std::string_view data, unsigned int jobs);
+
+    // Framed replacements for sage::serializer::Write/ReadCompressedBinary: 'magic' followed by one frame
+    // holding everything 'write' archived. The file is memory mapped for reading.
+    void WriteBinary(
+        const char* path,
+        std::uint32_t magic,
+        unsigned int jobs,
+        const std::function<void(cereal::BinaryOutputArchive&)>& write);
+    void ReadBinary(
+        const char* path,
+        std::uint32_t magic,
+        unsigned int jobs,
+        const std::function<void(cereal::BinaryInputArchive&, std::istream&)>& read);
+    // The payload of a file WriteBinary wrote, decompressed.
+    [[nodiscard]] std::string ReadPayload(const char* path, std::uint32_t magic, unsigned int jobs);
+} // namespace lq::framed
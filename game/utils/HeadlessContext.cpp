@@ -0,0 +1,59 @@
+#include "HeadlessContext.hpp"
+
+#include "raylib.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#if defined(PLATFORM_DESKTOP)
+// raylib links GLFW in statically but doesn't expose its headers; only the init hint is needed here.
+extern "C" void glfwInitHint(int hint, int value);
+constexpr int GLFW_PLATFORM = 0x00050003;
+constexpr int GLFW_PLATFORM_NULL = 0x00060005;
+#endif
+
+namespace lq
+{
+    bool HeadlessContext::DisplayAvailable()
+    {
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+        const char* x11 = std::getenv("DISPLAY");
+        const char* wayland = std::getenv("WAYLAND_DISPLAY");
+        return (x11 != nullptr && *x11 != '\0') || (wayland != nullptr && *wayland != '\0');
+#else
+        return true;
+#endif
+    }
+
+    bool HeadlessContext::IsHeadless() const
+    {
+        return headless;
+    }
+
+    HeadlessContext::HeadlessContext(const bool _headless, const char* title) : headless(_headless)
+    {
+        if (headless)
+        {
+#if defined(PLATFORM_DESKTOP)
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+            std::cout << "WARNING: HeadlessContext -> No null platform, using a hidden window. \n";
+#endif
+        }
+
+        SetTraceLogLevel(headless ? LOG_WARNING : LOG_INFO);
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(1, 1, title);
+        if (!IsWindowReady())
+        {
+            std::cerr << "ERROR: HeadlessContext -> Could not create a GL context"
+                      << (headless ? " (headless mode needs Mesa's libOSMesa installed)." : ".") << std::endl;
+            exit(1);
+        }
+    }
+
+    HeadlessContext::~HeadlessContext()
+    {
+        CloseWindow();
+    }
+} // namespace lq
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace lq
+{
+    // Owns the GL context raylib's loaders need (LoadModel, GenMesh*, LoadFont, ... upload to the GPU as they
+    // load) for the lifetime of the object.
+    // When headless, no window or display is used: GLFW is started on its null platform, which creates an
+    // offscreen software (OSMesa) context, so tools can run on build machines without X11/Wayland or a GPU.
+    // That needs Mesa's libOSMesa installed at runtime (see README.md, Building).
+    class HeadlessContext
+    {
+        bool headless;
+
+      public:
+        // True if there is a display to open a (hidden) window on. Always true outside Linux/BSD.
+        [[nodiscard]] static bool DisplayAvailable();
+        [[nodiscard]] bool IsHeadless() const;
+
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+        HeadlessContext(bool _headless, const char* title);
+        ~HeadlessContext();
+    };
+} // namespace lq
@@ -6,162 +6,848 @@
 #include "engine/components/sgTransform.hpp"
 #include "engine/components/Spawner.hpp"
 #include "engine/Light.hpp"
+#include "engine/ResourceManager.hpp"
 #include "engine/Serializer.hpp"
 #include "engine/ViewSerializer.hpp"
 
+#include "collision/RpgCollisionLayers.hpp"
 #include "components/DialogComponent.hpp"
 #include "components/InventoryComponent.hpp"
 #include "components/ItemComponent.hpp"
+#include "components/MeshLod.hpp"
+#include "components/StaticBatchMember.hpp"
+#include "FramedCompression.hpp"
+#include "MapObjectTags.hpp"
+#include "MemoryStream.hpp"
+#include "ModelRelease.hpp"
+#include "NavigationGridBake.hpp"
+#include "PackedModel.hpp"
+#include "StaticCollisionBvh.hpp"
 #include "Systems.hpp"
 
 #include "cereal/archives/binary.hpp"
 #include "cereal/archives/xml.hpp"
 #include "cereal/cereal.hpp"
 #include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
 #include "engine/raylib-cereal.hpp"
 #include "entt/core/hashed_string.hpp"
 #include "entt/core/type_traits.hpp"
+#include "raymath.h"
 #include <cereal/archives/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace lq::maploader
 {
-    void SaveMap(entt::registry& source, const char* path)
+    namespace
+    {
+        constexpr std::uint32_t kChunkFileMagic = 0x48434d4c; // "LMCH"
+        constexpr auto kResidentTags =
+            MapObjectTag::DOOR | MapObjectTag::INTERACTABLE | MapObjectTag::CHEST | MapObjectTag::ITEM |
+            MapObjectTag::MAPBASE;
+        constexpr std::uint32_t kNoParent = std::numeric_limits<std::uint32_t>::max();
+
+        MapObjectTags tagsOf(const entt::registry& source, const entt::entity entity, const sage::Renderable* rend)
+        {
+            if (const auto* tags = source.try_get<MapObjectTags>(entity)) return *tags;
+            return MapObjectTags{rend != nullptr ? ClassifyMapObjectName(rend->GetName()) : MapObjectTag::NONE};
+        }
+
+        // A transform's parent as a map id (see serializer::entity::id).
+        std::uint32_t parentIdOf(const entt::registry& source, const sage::sgTransform& trans)
+        {
+            const auto parent = trans.GetParent();
+            if (parent == entt::null || !source.valid(parent)) return kNoParent;
+            return entt::entt_traits<entt::entity>::to_entity(parent);
+        }
+
+        // Static entities are rendered on their own or are members of a static batch (StaticBatchMember).
+        void saveStatic(cereal::BinaryOutputArchive& output, const entt::registry& source, const entt::entity ent)
+        {
+            const auto* rend = source.try_get<sage::Renderable>(ent);
+            const auto& trans = source.get<sage::sgTransform>(ent);
+            const auto& col = source.get<sage::Collideable>(ent);
+
+            sage::serializer::entity entity{};
+            entity.id = entt::entt_traits<entt::entity>::to_entity(ent);
+            const bool rendered = rend != nullptr;
+            output(entity, trans, parentIdOf(source, trans), col, rendered);
+            if (rendered)
+            {
+                output(*rend);
+            }
+            else
+            {
+                output(source.get<StaticBatchMember>(ent));
+            }
+            output(tagsOf(source, ent, rend));
+        }
+
+        // The ResourceManager's models, keyed and encoded like asset pack entries, sorted so the bin is stable.
+        // Chunk models are stored with the chunks instead.
+        void saveModels(
+            cereal::BinaryOutputArchive& output,
+            const bool quantize,
+            const std::set<std::string>& chunkModels,
+            packed::VertexBytes& vertexBytes)
+        {
+            const auto& models = sage::ResourceManager::GetInstance().modelCopies;
+            std::vector<const std::string*> keys;
+            keys.reserve(models.size());
+            for (const auto& [key, info] : models)
+            {
+                if (!chunkModels.contains(key)) keys.push_back(&key);
+            }
+            std::ranges::sort(keys, [](const auto* a, const auto* b) { return *a < *b; });
+
+            output(static_cast<std::uint32_t>(keys.size()));
+            for (const auto* key : keys)
+            {
+                output(*key, packed::EncodeModel(models.at(*key), quantize, &vertexBytes));
+            }
+        }
+
+        // The models an entity needs, LOD levels included: the one its Renderable draws with or, for a static
+        // batch member, the one it was placed with (only tools use that).
+        std::vector<std::string> modelsOf(entt::registry& source, const entt::entity ent)
+        {
+            std::string key;
+            if (auto* rend = source.try_get<sage::Renderable>(ent))
+            {
+                if (const auto* model = rend->GetModel()) key = model->GetKey();
+            }
+            else if (const auto* member = source.try_get<StaticBatchMember>(ent))
+            {
+                key = member->modelKey;
+            }
+
+            std::vector<std::string> out;
+            const auto& models = sage::ResourceManager::GetInstance().modelCopies;
+            for (int level = 0; !key.empty() && level <= kMaxLodLevels; ++level)
+            {
+                auto levelKey = LodModelKey(key, level);
+                if (!models.contains(levelKey)) break;
+                out.push_back(std::move(levelKey));
+            }
+            return out;
+        }
+
+        // A section archived on its own, so ReadMapBin can keep it aside for the main thread.
+        template <typename Write>
+        std::string archived(Write&& write)
+        {
+            std::ostringstream stream(std::ios::binary);
+            {
+                cereal::BinaryOutputArchive output(stream);
+                write(output);
+            }
+            return std::move(stream).str();
+        }
+
+        // Checks a blob of the ".chunks" file is there and, if compressed, returns it decompressed.
+        std::string readBlob(
+            const std::shared_ptr<const MappedFile>& file,
+            const std::uint64_t offset,
+            const std::uint32_t size,
+            const bool compressed,
+            const std::string& what)
+        {
+            if (!file || offset + size > file->Size())
+            {
+                throw std::runtime_error("The map's .chunks file is missing " + what + ".");
+            }
+            if (!compressed) return {};
+
+            int decompressedSize = 0;
+            auto* data = DecompressData(file->Data() + offset, static_cast<int>(size), &decompressedSize);
+            if (data == nullptr)
+            {
+                throw std::runtime_error("Could not decompress " + what);
+            }
+            std::string out(reinterpret_cast<const char*>(data), decompressedSize);
+            MemFree(data);
+            return out;
+        }
+
+        // A chunk model, still encoded.
+        std::string readChunkModel(const std::shared_ptr<const MappedFile>& file, const MapChunkModel& model)
+        {
+            const auto what = "model " + model.key;
+            if (model.compressed) return readBlob(file, model.offset, model.size, true, what);
+            readBlob(file, model.offset, model.size, false, what);
+            return {reinterpret_cast<const char*>(file->Data() + model.offset), model.size};
+        }
+
+        // Entities are created in batches (see createBatch) and then filled in by loadItem/loadStatic. Both
+        // return false if the entity couldn't be read, the caller then destroys what's left of the batch.
+        bool loadItem(
+            cereal::BinaryInputArchive& input,
+            entt::registry* destination,
+            const entt::entity entt,
+            MapIdRemap& idRemap)
+        {
+            sage::serializer::entity entityId{};
+            auto& transform = destination->emplace<sage::sgTransform>(entt);
+            auto& collideable = destination->emplace<sage::Collideable>(entt);
+            auto& renderable = destination->emplace<sage::Renderable>(entt);
+            auto& item = destination->emplace<ItemComponent>(entt);
+            auto& tags = destination->emplace<MapObjectTags>(entt);
+
+            std::uint32_t parentId = kNoParent;
+            try
+            {
+                input(entityId, transform, parentId, collideable, renderable, item, tags);
+                collideable.isStatic = true;
+            }
+            catch (const cereal::Exception& e)
+            {
+                std::cerr << "ERROR: Serialization error: " << e.what() << std::endl;
+                return false;
+            }
+            idRemap.Set(entityId.id, entt);
+            if (parentId != kNoParent) idRemap.AddChild(entt, parentId);
+            return true;
+        }
+
+        bool loadStatic(
+            cereal::BinaryInputArchive& input,
+            entt::registry* destination,
+            const entt::entity entt,
+            MapIdRemap& idRemap)
+        {
+            sage::serializer::entity entityId{};
+            auto& transform = destination->emplace<sage::sgTransform>(entt);
+            auto& collideable = destination->emplace<sage::Collideable>(entt);
+
+            std::uint32_t parentId = kNoParent;
+            try
+            {
+                bool rendered = true;
+                input(entityId, transform, parentId, collideable, rendered);
+                if (rendered)
+                {
+                    input(destination->emplace<sage::Renderable>(entt));
+                }
+                else
+                {
+                    input(destination->emplace<StaticBatchMember>(entt));
+                }
+                input(destination->emplace<MapObjectTags>(entt));
+                collideable.isStatic = true;
+            }
+            catch (const cereal::Exception& e)
+            {
+                std::cerr << "ERROR: Serialization error: " << e.what() << std::endl;
+                return false;
+            }
+            idRemap.Set(entityId.id, entt);
+            if (parentId != kNoParent) idRemap.AddChild(entt, parentId);
+
+            const auto& tags = destination->get<MapObjectTags>(entt);
+            if (tags.HasAnyTag(MapObjectTag::DOOR))
+            {
+                destination->emplace<sage::DoorBehaviorComponent>(entt);
+            }
+            if (tags.HasAnyTag(MapObjectTag::INTERACTABLE))
+            {
+                destination->emplace<DialogComponent>(entt);
+            }
+            if (tags.HasAnyTag(MapObjectTag::CHEST))
+            {
+                destination->emplace<InventoryComponent>(entt);
+            }
+            return true;
+        }
+
+        // Creates 'count' entities at once and reserves room for the components every map entity has.
+        std::vector<entt::entity> createBatch(entt::registry* destination, const std::size_t count)
+        {
+            std::vector<entt::entity> batch(count);
+            destination->create(batch.begin(), batch.end());
+            const auto reserve = [&]<typename Component>(std::type_identity<Component>) {
+                auto& storage = destination->storage<Component>();
+                storage.reserve(storage.size() + count);
+            };
+            reserve(std::type_identity<sage::sgTransform>{});
+            reserve(std::type_identity<sage::Collideable>{});
+            reserve(std::type_identity<MapObjectTags>{});
+            return batch;
+        }
+
+        // Only the entities of the batch can have a parent in it, others are left unparented.
+        void resolveParents(entt::registry* destination, const MapIdRemap& idRemap)
+        {
+            for (const auto& [child, parentId] : idRemap.Children())
+            {
+                const auto parent = idRemap.Find(parentId);
+                if (parent != entt::null) destination->get<sage::sgTransform>(child).SetParent(parent);
+            }
+        }
+
+        void mergeBounds(BoundingBox& into, const BoundingBox& box)
+        {
+            into.min = Vector3Min(into.min, box.min);
+            into.max = Vector3Max(into.max, box.max);
+        }
+
+        // Every static collider of the map, resident or chunked. Background colliders are left out, default
+        // queries ignore them.
+        StaticCollisionBvh buildCollisionBvh(
+            const entt::registry& source,
+            const std::vector<entt::entity>& residentStatics,
+            const std::vector<entt::entity>& chunkedStatics)
+        {
+            std::vector<StaticCollisionBvh::Primitive> primitives;
+            for (const auto* statics : {&residentStatics, &chunkedStatics})
+            {
+                for (const auto ent : *statics)
+                {
+                    const auto& col = source.get<sage::Collideable>(ent);
+                    if (col.collisionLayer == collision_layers::Background) continue;
+                    const auto mapId = entt::entt_traits<entt::entity>::to_entity(ent); // As saveStatic writes it
+                    primitives.push_back({col.worldBoundingBox, col.collisionLayer, mapId});
+                }
+            }
+            auto bvh = StaticCollisionBvh::Build(std::move(primitives));
+            std::cout << "Static collision BVH: " << bvh.PrimitiveCount() << " collider(s), " << bvh.NodeCount()
+                      << " node(s). \n";
+            return bvh;
+        }
+
+        // Appends a blob to the ".chunks" file, compressed if asked. Returns its size as stored.
+        std::uint32_t writeBlob(std::ofstream& file, const std::string& raw, const bool compress)
+        {
+            if (!compress)
+            {
+                file.write(raw.data(), static_cast<std::streamsize>(raw.size()));
+                return static_cast<std::uint32_t>(raw.size());
+            }
+            int compressedSize = 0;
+            auto* compressed = CompressData(
+                reinterpret_cast<const unsigned char*>(raw.data()), static_cast<int>(raw.size()), &compressedSize);
+            file.write(reinterpret_cast<const char*>(compressed), compressedSize);
+            MemFree(compressed);
+            return static_cast<std::uint32_t>(compressedSize);
+        }
+
+        // Splits the chunkable static entities into cells, writes each cell as a blob to the ".chunks" file
+        // followed by the chunk models (sorted keys), and returns the index describing them.
+        MapChunkIndex saveChunks(
+            entt::registry& source,
+            const std::vector<entt::entity>& entities,
+            const std::vector<std::string>& chunkModels,
+            const std::string& chunkPath,
+            const MapSaveOptions& options,
+            packed::VertexBytes& vertexBytes)
+        {
+            const auto cellSize = options.chunkSize;
+            std::map<std::pair<int, int>, std::vector<entt::entity>> cells; // Ordered, so the output is stable
+            for (const auto ent : entities)
+            {
+                const auto& box = source.get<sage::Collideable>(ent).worldBoundingBox;
+                const auto center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+                const auto cell = std::pair{
+                    static_cast<int>(std::floor(center.x / cellSize)),
+                    static_cast<int>(std::floor(center.z / cellSize))};
+                cells[cell].push_back(ent);
+            }
+
+            MapChunkIndex index{.cellSize = cellSize};
+            std::ofstream file(chunkPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&kChunkFileMagic), sizeof(kChunkFileMagic));
+            file.write(reinterpret_cast<const char*>(&kMapFormatVersion), sizeof(kMapFormatVersion));
+            std::uint64_t offset = sizeof(kChunkFileMagic) + sizeof(kMapFormatVersion);
+
+            for (const auto& [cell, members] : cells)
+            {
+                MapChunkInfo chunk{.cellX = cell.first, .cellZ = cell.second};
+                chunk.bounds = source.get<sage::Collideable>(members.front()).worldBoundingBox;
+                chunk.entityCount = static_cast<std::uint32_t>(members.size());
+
+                std::set<std::uint32_t> models;
+                std::ostringstream stream(std::ios::binary);
+                {
+                    cereal::BinaryOutputArchive output(stream);
+                    output(chunk.entityCount);
+                    for (const auto ent : members)
+                    {
+                        const auto& col = source.get<sage::Collideable>(ent);
+                        mergeBounds(chunk.bounds, col.worldBoundingBox);
+                        if (IsNavigationObstacle(col))
+                        {
+                            chunk.obstacles.push_back(col.worldBoundingBox);
+                        }
+                        saveStatic(output, source, ent);
+
+                        if (!source.all_of<sage::Renderable>(ent)) continue; // Batch members aren't drawn
+                        for (const auto& key : modelsOf(source, ent))
+                        {
+                            const auto it = std::ranges::lower_bound(chunkModels, key);
+                            if (it != chunkModels.end() && *it == key)
+                            {
+                                models.insert(static_cast<std::uint32_t>(it - chunkModels.begin()));
+                            }
+                        }
+                    }
+                }
+                chunk.models.assign(models.begin(), models.end());
+
+                chunk.compressed = options.compressChunks;
+                chunk.size = writeBlob(file, std::move(stream).str(), options.compressChunks);
+                chunk.offset = offset;
+                offset += chunk.size;
+                index.chunks.push_back(std::move(chunk));
+            }
+
+            const auto& rmModels = sage::ResourceManager::GetInstance().modelCopies;
+            for (const auto& key : chunkModels)
+            {
+                MapChunkModel model{.key = key, .offset = offset, .compressed = options.compressChunks};
+                const auto encoded = packed::EncodeModel(rmModels.at(key), options.quantizeMeshes, &vertexBytes);
+                model.size = writeBlob(file, encoded, options.compressChunks);
+                offset += model.size;
+                index.models.push_back(std::move(model));
+            }
+
+            if (!file)
+            {
+                throw std::runtime_error("Could not write map chunks to " + chunkPath);
+            }
+            return index;
+        }
+
+        // Models used by chunked entities and by nothing that stays resident. Models no entity uses stay in the
+        // map bin, something may still look them up by key.
+        std::set<std::string> findChunkModels(
+            entt::registry& source,
+            const std::vector<entt::entity>& residentStatics,
+            const std::vector<entt::entity>& chunkedStatics)
+        {
+            std::set<std::string> out;
+            for (const auto ent : chunkedStatics)
+            {
+                for (auto& key : modelsOf(source, ent))
+                    out.insert(std::move(key));
+            }
+            const auto keepResident = [&out, &source](const entt::entity ent) {
+                for (const auto& key : modelsOf(source, ent))
+                    out.erase(key);
+            };
+            for (const auto ent : residentStatics)
+                keepResident(ent);
+            for (const auto ent : source.view<ItemComponent>())
+                keepResident(ent);
+            return out;
+        }
+    } // namespace
+
+    void SaveMap(entt::registry& source, const char* path, const MapSaveOptions& options)
     {
         std::cout << "START: Saving map data to file." << std::endl;
 
-        sage::serializer::WriteCompressedBinary(
-            path, sage::serializer::kMapBinMagic, [&](cereal::BinaryOutputArchive& output) {
-                sage::ViewSerializer<sage::Spawner> spawnerLoader(&source);
-                output(spawnerLoader);
+        // Static (non-item) entities either stay resident in the map bin or go into a streamed chunk.
+        std::vector<entt::entity> residentStatics;
+        std::vector<entt::entity> chunkedStatics;
+        const auto view = source.view<sage::sgTransform, sage::Collideable>(entt::exclude<ItemComponent>);
+        for (const auto& ent : view)
+        {
+            const auto* rend = source.try_get<sage::Renderable>(ent);
+            if (rend == nullptr && !source.all_of<StaticBatchMember>(ent)) continue;
+            const bool resident = options.chunkSize <= 0 || tagsOf(source, ent, rend).HasAnyTag(kResidentTags) ||
+                                  (options.keepResident && options.keepResident(ent));
+            (resident ? residentStatics : chunkedStatics).push_back(ent);
+        }
 
-                sage::ViewSerializer<sage::Light> lightLoader(&source);
-                output(lightLoader);
+        const auto chunkModels = findChunkModels(source, residentStatics, chunkedStatics);
+        packed::VertexBytes vertexBytes;
+        const auto chunkPath = std::string(path) + ".chunks";
+        MapChunkIndex chunkIndex;
+        if (!chunkedStatics.empty())
+        {
+            const std::vector<std::string> sortedChunkModels(chunkModels.begin(), chunkModels.end());
+            chunkIndex = saveChunks(source, chunkedStatics, sortedChunkModels, chunkPath, options, vertexBytes);
+        }
+        else if (std::filesystem::exists(chunkPath))
+        {
+            std::filesystem::remove(chunkPath); // Stale from a previous chunked build
+        }
+
+        framed::WriteBinary(
+            path, sage::serializer::kMapBinMagic, options.jobs, [&](cereal::BinaryOutputArchive& output) {
+                output(kMapFormatVersion);
 
-                output(sage::ResourceManager::GetInstance());
+                output(archived([&](cereal::BinaryOutputArchive& resources) {
+                    sage::ViewSerializer<sage::Spawner> spawnerLoader(&source);
+                    resources(spawnerLoader);
+
+                    sage::ViewSerializer<sage::Light> lightLoader(&source);
+                    resources(lightLoader);
+
+                    // Models go through saveModels instead, so they can be quantized.
+                    auto& rm = sage::ResourceManager::GetInstance();
+                    auto models = std::move(rm.modelCopies);
+                    rm.modelCopies.clear();
+                    resources(rm);
+                    rm.modelCopies = std::move(models);
+                }));
+                saveModels(output, options.quantizeMeshes, chunkModels, vertexBytes);
 
                 // Note: ViewSerializer creates separate entities per component type, so it can't
                 // reconstruct multi-component entities (Renderable+Collideable+sgTransform must share
                 // one entity). Per-entity serialization is used instead.
                 const auto itemView =
                     source.view<sage::Renderable, sage::sgTransform, sage::Collideable, ItemComponent>();
-                unsigned int itemCount = 0;
+                std::uint32_t itemCount = 0;
                 for (const auto& entity : itemView)
                     ++itemCount;
-                output(itemCount);
+                output(itemCount, static_cast<std::uint32_t>(residentStatics.size()));
 
-                for (const auto& ent : itemView)
-                {
-                    const auto& rend = source.get<sage::Renderable>(ent);
-                    const auto& trans = source.get<sage::sgTransform>(ent);
-                    const auto& col = source.get<sage::Collideable>(ent);
-                    const auto& item = source.get<ItemComponent>(ent);
+                output(archived([&](cereal::BinaryOutputArchive& entities) {
+                    for (const auto& ent : itemView)
+                    {
+                        const auto& rend = source.get<sage::Renderable>(ent);
+                        const auto& trans = source.get<sage::sgTransform>(ent);
+                        const auto& col = source.get<sage::Collideable>(ent);
+                        const auto& item = source.get<ItemComponent>(ent);
 
-                    sage::serializer::entity entity{};
-                    entity.id = entt::entt_traits<entt::entity>::to_entity(ent);
-                    output(entity, trans, col, rend, item);
-                }
+                        sage::serializer::entity entity{};
+                        entity.id = entt::entt_traits<entt::entity>::to_entity(ent);
+                        entities(
+                            entity, trans, parentIdOf(source, trans), col, rend, item, tagsOf(source, ent, &rend));
+                    }
+                    for (const auto& ent : residentStatics)
+                    {
+                        saveStatic(entities, source, ent);
+                    }
+                }));
 
-                const auto view = source.view<sage::sgTransform, sage::Renderable, sage::Collideable>(
-                    entt::exclude<ItemComponent>);
-                for (const auto& ent : view)
-                {
-                    const auto& rend = view.get<sage::Renderable>(ent);
-                    const auto& trans = view.get<sage::sgTransform>(ent);
-                    const auto& col = view.get<sage::Collideable>(ent);
+                output(chunkIndex);
 
-                    sage::serializer::entity entity{};
-                    entity.id = entt::entt_traits<entt::entity>::to_entity(ent);
-                    output(entity, trans, col, rend);
-                }
+                const auto* navigation = source.ctx().find<BakedNavigationGrid>();
+                output(navigation != nullptr ? *navigation : BakedNavigationGrid{});
+
+                output(buildCollisionBvh(source, residentStatics, chunkedStatics));
             });
 
+        if (options.quantizeMeshes)
+        {
+            const auto saved = vertexBytes.original - std::min(vertexBytes.stored, vertexBytes.original);
+            std::cout << "Vertex attributes: " << vertexBytes.original / 1024 << " KiB as floats, "
+                      << vertexBytes.stored / 1024 << " KiB quantized (" << saved / 1024 << " KiB saved). \n";
+        }
+        std::cout << "Map entities: " << residentStatics.size() << " resident, " << chunkedStatics.size()
+                  << " in " << chunkIndex.chunks.size() << " chunk(s), with " << chunkIndex.models.size()
+                  << " model(s) of their own. \n";
         std::cout << "FINISH: Saving map data to file." << std::endl;
     }
 
-    void LoadMap(entt::registry* destination, const char* path)
+    MapBinData ReadMapBin(const char* path, const unsigned int jobs)
+    {
+        MapBinData data;
+        data.path = path;
+
+        framed::ReadBinary(
+            path, sage::serializer::kMapBinMagic, jobs, [&](cereal::BinaryInputArchive& input, std::istream&) {
+                std::uint32_t version = 0;
+                input(version);
+                if (version != kMapFormatVersion)
+                {
+                    throw std::runtime_error(
+                        std::string(path) + " is map format " + std::to_string(version) + ", expected " +
+                        std::to_string(kMapFormatVersion) + ". Rebuild it with respacker --construct-map.");
+                }
+
+                input(data.resources);
+
+                std::uint32_t modelCount = 0;
+                input(modelCount);
+                data.models.resize(modelCount);
+                for (auto& [key, encoded] : data.models)
+                {
+                    input(key, encoded);
+                }
+
+                input(data.itemCount, data.staticCount, data.entities);
+                input(data.chunkIndex, data.navigation, data.collisionBvh);
+            });
+        return data;
+    }
+
+    MapLoadCommit::MapLoadCommit(entt::registry* _destination, MapBinData _data)
+        : destination(_destination), data(std::move(_data)), modelCount(data.models.size())
     {
         assert(destination != nullptr);
-        std::cout << "START: Loading map data from file." << std::endl;
+    }
 
-        std::unordered_map<std::uint32_t, entt::entity> idMap;
+    void MapLoadCommit::commitResources()
+    {
+        MemoryIStream stream(data.resources);
+        cereal::BinaryInputArchive input(stream);
 
-        sage::serializer::ReadCompressedBinary(
-            path, sage::serializer::kMapBinMagic, [&](cereal::BinaryInputArchive& input, std::istream& stream) {
-                sage::ViewSerializer<sage::Spawner> spawnerLoader(destination);
-                input(spawnerLoader);
+        sage::ViewSerializer<sage::Spawner> spawnerLoader(destination);
+        input(spawnerLoader);
 
-                sage::ViewSerializer<sage::Light> lightLoader(destination);
-                input(lightLoader);
+        sage::ViewSerializer<sage::Light> lightLoader(destination);
+        input(lightLoader);
 
-                input(sage::ResourceManager::GetInstance());
+        input(sage::ResourceManager::GetInstance());
+        data.resources = {};
+    }
 
-                unsigned int itemCount;
-                input(itemCount);
+    void MapLoadCommit::finish()
+    {
+        resolveParents(destination, idRemap);
 
-                for (unsigned int i = 0; i < itemCount; ++i)
+        MapChunkSource source{data.path + ".chunks", std::move(data.chunkIndex)};
+        if (!source.index.chunks.empty())
+        {
+            try
+            {
+                auto file = std::make_shared<const MappedFile>(source.path);
+                std::uint32_t header[2]{};
+                if (file->Size() >= sizeof(header)) std::memcpy(header, file->Data(), sizeof(header));
+                if (header[0] != kChunkFileMagic || header[1] != kMapFormatVersion)
                 {
-                    auto entt = destination->create();
-                    sage::serializer::entity entityId{};
-                    auto& transform = destination->emplace<sage::sgTransform>(entt);
-                    auto& collideable = destination->emplace<sage::Collideable>(entt);
-                    auto& renderable = destination->emplace<sage::Renderable>(entt);
-                    auto& item = destination->emplace<ItemComponent>(entt);
-
-                    try
-                    {
-                        input(entityId, transform, collideable, renderable, item);
-                        collideable.isStatic = true;
-                    }
-                    catch (const cereal::Exception& e)
-                    {
-                        std::cerr << "ERROR: Serialization error: " << e.what() << std::endl;
-                        break;
-                    }
-                    idMap[entityId.id] = entt;
+                    throw std::runtime_error(source.path + " doesn't match its map bin.");
                 }
+                source.file = std::move(file);
+            }
+            catch (const std::exception& e)
+            {
+                // The map is still playable, its chunks will just fail to stream in.
+                std::cerr << "ERROR: Could not open map chunks: " << e.what() << std::endl;
+            }
+        }
+        destination->ctx().insert_or_assign(std::move(source));
+        if (data.navigation.slices > 0) destination->ctx().insert_or_assign(std::move(data.navigation));
+        data.collisionBvh.Bind(idRemap.ById(), idRemap.Ids());
+        destination->ctx().insert_or_assign(std::move(data.collisionBvh));
 
-                while (stream.peek() != EOF)
-                {
-                    sage::serializer::entity entityId{};
-                    auto entt = destination->create();
-                    auto& transform = destination->emplace<sage::sgTransform>(entt);
-                    auto& collideable = destination->emplace<sage::Collideable>(entt);
-                    auto& renderable = destination->emplace<sage::Renderable>(entt);
+        entityInput.reset();
+        entityStream.reset();
+        data.entities = {};
+    }
 
-                    try
-                    {
-                        input(entityId, transform, collideable, renderable);
-                        collideable.isStatic = true;
-                    }
-                    catch (const cereal::Exception& e)
-                    {
-                        std::cerr << "ERROR: Serialization error: " << e.what() << std::endl;
-                        break;
-                    }
-                    idMap[entityId.id] = entt;
+    void MapLoadCommit::createEntities()
+    {
+        created = createBatch(destination, std::size_t{data.itemCount} + data.staticCount);
+        auto& items = destination->storage<ItemComponent>();
+        items.reserve(items.size() + data.itemCount);
+        entityStream = std::make_unique<MemoryIStream>(data.entities);
+        entityInput = std::make_unique<cereal::BinaryInputArchive>(*entityStream);
+    }
 
-                    if (renderable.GetName().find("_DOOR_") != std::string::npos)
-                    {
-                        destination->emplace<sage::DoorBehaviorComponent>(entt);
-                    }
-                    if (renderable.GetName().find("_INTERACTABLE_") != std::string::npos)
-                    {
-                        destination->emplace<DialogComponent>(entt);
-                    }
-                    if (renderable.GetName().find("_CHEST_") != std::string::npos)
-                    {
-                        destination->emplace<InventoryComponent>(entt);
-                    }
+    bool MapLoadCommit::Step(const std::chrono::steady_clock::duration budget)
+    {
+        // A budget past the clock's range (e.g. duration::max()) means no deadline, rather than one that wrapped.
+        const auto now = std::chrono::steady_clock::now();
+        const auto deadline = budget >= std::chrono::steady_clock::time_point::max() - now
+                                  ? std::chrono::steady_clock::time_point::max()
+                                  : now + budget;
+        // Every step commits something, however small the budget.
+        bool committed = false;
+        const auto outOfTime = [&] { return committed && std::chrono::steady_clock::now() >= deadline; };
+
+        if (stage == Stage::Resources)
+        {
+            commitResources();
+            committed = true;
+            stage = Stage::Models;
+            next = 0;
+            if (outOfTime()) return false;
+        }
+
+        if (stage == Stage::Models)
+        {
+            auto& models = sage::ResourceManager::GetInstance().modelCopies;
+            for (; next < data.models.size(); ++next)
+            {
+                if (outOfTime()) return false;
+                committed = true;
+                const auto& [key, encoded] = data.models[next];
+                // Models the asset pack already provided are kept, they may be in use.
+                if (models.contains(key)) continue;
+                models.try_emplace(key, packed::DecodeModel(encoded));
+            }
+            data.models.clear();
+            stage = Stage::Entities;
+            next = 0;
+            createEntities();
+        }
+
+        if (stage == Stage::Entities)
+        {
+            for (; next < created.size(); ++next)
+            {
+                if (outOfTime()) return false;
+                committed = true;
+                const auto entity = created[next];
+                const bool loaded = next < data.itemCount ? loadItem(*entityInput, destination, entity, idRemap)
+                                                          : loadStatic(*entityInput, destination, entity, idRemap);
+                if (!loaded)
+                {
+                    // The rest of the blob can't be trusted.
+                    destination->destroy(created.begin() + next, created.end());
+                    created.resize(next);
+                    break;
                 }
-            });
+            }
+            stage = Stage::Finish;
+        }
 
-        for (auto [e, t] : destination->view<sage::sgTransform>().each())
+        if (stage == Stage::Finish)
         {
-            t.ResolveSerializedParent(idMap);
+            finish();
+            stage = Stage::Done;
         }
+        return true;
+    }
 
+    float MapLoadCommit::Progress() const
+    {
+        const std::size_t entityCount = std::size_t{data.itemCount} + data.staticCount;
+        // The resources and the finishing step count as one model/entity each.
+        std::size_t done = 0;
+        switch (stage)
+        {
+        case Stage::Resources:
+            break;
+        case Stage::Models:
+            done = 1 + next;
+            break;
+        case Stage::Entities:
+            done = 1 + modelCount + next;
+            break;
+        case Stage::Finish:
+            done = 1 + modelCount + entityCount;
+            break;
+        case Stage::Done:
+            return 1.0f;
+        }
+        return static_cast<float>(done) / static_cast<float>(2 + modelCount + entityCount);
+    }
+
+    void LoadMap(entt::registry* destination, const char* path)
+    {
+        assert(destination != nullptr);
+        std::cout << "START: Loading map data from file." << std::endl;
+        MapLoadCommit commit(destination, ReadMapBin(path));
+        while (!commit.Step(std::chrono::steady_clock::duration::max()))
+        {
+        }
         std::cout << "FINISH: Loading map data from file." << std::endl;
     }
+
+    MapChunkData ReadMapChunk(
+        const std::shared_ptr<const MappedFile>& file,
+        const MapChunkInfo& chunk,
+        const std::vector<MapChunkModel>& models)
+    {
+        const auto where = "chunk " + std::to_string(chunk.cellX) + "," + std::to_string(chunk.cellZ);
+        MapChunkData out;
+        if (chunk.compressed)
+        {
+            out.decompressed = readBlob(file, chunk.offset, chunk.size, true, where);
+        }
+        else
+        {
+            readBlob(file, chunk.offset, chunk.size, false, where);
+            out.file = file;
+            out.stored = {reinterpret_cast<const char*>(file->Data() + chunk.offset), chunk.size};
+        }
+
+        out.models.reserve(models.size());
+        for (const auto& model : models)
+        {
+            out.models.emplace_back(model.key, readChunkModel(file, model));
+        }
+        return out;
+    }
+
+    void CommitMapChunkModels(MapChunkData& data)
+    {
+        auto& models = sage::ResourceManager::GetInstance().modelCopies;
+        for (const auto& [key, encoded] : data.models)
+        {
+            // Another chunk may have loaded it while this one was being read.
+            if (models.contains(key)) continue;
+            models.try_emplace(key, packed::DecodeModel(encoded));
+        }
+        data.models.clear();
+    }
+
+    void LoadMapChunkModel(const MapChunkSource& source, const std::uint32_t model)
+    {
+        const auto& chunkModel = source.index.models.at(model);
+        auto& models = sage::ResourceManager::GetInstance().modelCopies;
+        if (models.contains(chunkModel.key)) return;
+        models.try_emplace(chunkModel.key, packed::DecodeModel(readChunkModel(source.file, chunkModel)));
+    }
+
+    void ReleaseMapChunkModel(const MapChunkSource& source, const std::uint32_t model)
+    {
+        auto& models = sage::ResourceManager::GetInstance().modelCopies;
+        const auto it = models.find(source.index.models.at(model).key);
+        if (it == models.end()) return;
+        ReleaseModel(it->second.model);
+        models.erase(it);
+    }
+
+    std::vector<entt::entity> InstantiateMapChunk(entt::registry* destination, const std::string_view chunkData)
+    {
+        MemoryIStream stream(chunkData);
+        cereal::BinaryInputArchive input(stream);
+
+        std::uint32_t count = 0;
+        input(count);
+        auto out = createBatch(destination, count);
+        MapIdRemap idRemap;
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            if (loadStatic(input, destination, out[i], idRemap)) continue;
+            destination->destroy(out.begin() + i, out.end());
+            out.resize(i);
+            break;
+        }
+
+        resolveParents(destination, idRemap);
+        if (auto* bvh = destination->ctx().find<StaticCollisionBvh>()) bvh->Bind(idRemap.ById(), idRemap.Ids());
+        return out;
+    }
+
+    void LoadAllMapChunkModels(entt::registry* destination)
+    {
+        const auto* source = destination->ctx().find<MapChunkSource>();
+        if (source == nullptr) return;
+        for (std::uint32_t i = 0; i < source->index.models.size(); ++i)
+        {
+            LoadMapChunkModel(*source, i);
+        }
+    }
+
+    void LoadAllMapChunks(entt::registry* destination)
+    {
+        const auto* source = destination->ctx().find<MapChunkSource>();
+        if (source == nullptr) return;
+        LoadAllMapChunkModels(destination);
+        for (const auto& chunk : source->index.chunks)
+        {
+            InstantiateMapChunk(destination, ReadMapChunk(source->file, chunk).View());
+        }
+    }
 } // namespace lq::maploader
@@ -4,10 +4,267 @@
 
 #pragma once
 
+#include "MappedFile.hpp"
+#include "NavigationGridBake.hpp"
+#include "StaticCollisionBvh.hpp"
+
+#include "engine/ResourceManager.hpp"
+
 #include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cereal
+{
+    class BinaryInputArchive;
+}
 
 namespace lq::maploader
 {
-    void SaveMap(entt::registry& source, const char* path);
+    // Written at the start of every map bin. Bump whenever SaveMap's layout changes; bins of another version
+    // are rejected and have to be rebuilt with respacker.
+    // 2: per-entity MapObjectTags
+    // 3: static geometry split into streamable chunks (<map>.chunks), resident/static entity counts
+    // 4: chunks may be stored uncompressed
+    // 5: models stored through the asset pack model codec (optionally quantized), after the ResourceManager
+    // 6: static entities may be static batch members instead of having a Renderable
+    // 7: baked navigation grid (NavigationGridBake.hpp) at the end
+    // 8: static collision BVH (StaticCollisionBvh.hpp) after the navigation grid
+    // 9: map bin compressed as independent blocks (FramedCompression.hpp) instead of one stream
+    // 10: registry/ResourceManager sections and entities stored as length-prefixed blobs, so a worker thread
+    //     can parse everything else (see ReadMapBin)
+    // 11: models only chunked entities use stored in the ".chunks" file (MapChunkModel)
+    // 12: each entity's transform parent stored as a map id after its transform, resolved through MapIdRemap
+    inline constexpr std::uint32_t kMapFormatVersion = 12;
+
+    // A model only chunked entities use (LOD levels included). It's stored once, as its own blob in the
+    // ".chunks" file, and is only in the ResourceManager while a chunk listing it is loaded.
+    struct MapChunkModel
+    {
+        std::string key;
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0; // As stored in the file
+        bool compressed = true;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(key, offset, size, compressed);
+        }
+    };
+
+    // A square cell of static geometry, stored as one (optionally compressed) blob in the map's ".chunks" file.
+    struct MapChunkInfo
+    {
+        int cellX = 0;
+        int cellZ = 0;
+        BoundingBox bounds{}; // Union of every member's world bounding box (can extend past the cell)
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0; // As stored in the file
+        bool compressed = true;
+        std::uint32_t entityCount = 0;
+        // Boxes of members that block navigation, so the grid can be marked before the chunk is ever loaded.
+        std::vector<BoundingBox> obstacles;
+        // Indices into MapChunkIndex::models of the models the members are drawn with.
+        std::vector<std::uint32_t> models;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(cellX, cellZ, bounds, offset, size, compressed, entityCount, obstacles, models);
+        }
+    };
+
+    struct MapChunkIndex
+    {
+        float cellSize = 0; // 0 if the map wasn't chunked
+        std::vector<MapChunkInfo> chunks;
+        // Also holds models no chunk lists (only static batch members were placed with them), for tools.
+        std::vector<MapChunkModel> models;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(cellSize, chunks, models);
+        }
+    };
+
+    // Stored in the registry context by LoadMap.
+    struct MapChunkSource
+    {
+        std::string path; // The ".chunks" file
+        MapChunkIndex index;
+        std::shared_ptr<const MappedFile> file; // Mapping of 'path', null if the map has no chunks
+    };
+
+    // The bytes of one chunk. Uncompressed chunks are a view into the mapped ".chunks" file (kept alive by
+    // 'file'), compressed ones are decompressed into 'decompressed'.
+    struct MapChunkData
+    {
+        std::shared_ptr<const MappedFile> file;
+        std::string_view stored;
+        std::string decompressed;
+        // Models ReadMapChunk was asked to read, still encoded (see PackedModel.hpp). CommitMapChunkModels
+        // decodes them into the ResourceManager.
+        std::vector<std::pair<std::string, std::string>> models;
+
+        [[nodiscard]] std::string_view View() const
+        {
+            return file ? stored : std::string_view(decompressed);
+        }
+    };
+
+    struct MapSaveOptions
+    {
+        // Edge length of a chunk cell in world units, 0 keeps every entity resident (no ".chunks" file).
+        float chunkSize = 0;
+        // Entities that must stay resident (e.g. referenced by name from dialog). Doors, chests, interactables,
+        // items and the map base always are.
+        std::function<bool(entt::entity)> keepResident;
+        // Uncompressed chunks are instantiated straight out of the mapped ".chunks" file.
+        bool compressChunks = true;
+        // Store model vertex attributes quantized (see VertexQuantization.hpp).
+        bool quantizeMeshes = false;
+        // Threads compressing the map bin's blocks, see ParallelFor.hpp. LoadMap decompresses on every core.
+        unsigned int jobs = 1;
+    };
+
+    // Entity ids as stored in a map bin or chunk, to the entities created for them. The ids are the source
+    // registry's entity indices, so they're dense enough for a flat array.
+    class MapIdRemap
+    {
+        std::vector<entt::entity> byId;
+        std::vector<std::uint32_t> ids; // Set so far, in order
+        std::vector<std::pair<entt::entity, std::uint32_t>> children; // By their parent's stored id
+
+      public:
+        void Set(const std::uint32_t id, const entt::entity entity)
+        {
+            if (id >= byId.size()) byId.resize(std::max<std::size_t>(id + 1, byId.size() * 2), entt::null);
+            byId[id] = entity;
+            ids.push_back(id);
+        }
+
+        [[nodiscard]] std::span<const entt::entity> ById() const
+        {
+            return byId;
+        }
+
+        [[nodiscard]] std::span<const std::uint32_t> Ids() const
+        {
+            return ids;
+        }
+
+        [[nodiscard]] entt::entity Find(const std::uint32_t id) const
+        {
+            return id < byId.size() ? byId[id] : entt::null;
+        }
+
+        // An entity whose transform had a parent when it was saved.
+        void AddChild(const entt::entity entity, const std::uint32_t parentId)
+        {
+            children.emplace_back(entity, parentId);
+        }
+
+        [[nodiscard]] std::span<const std::pair<entt::entity, std::uint32_t>> Children() const
+        {
+            return children;
+        }
+    };
+
+    // A map bin as ReadMapBin leaves it: read, decompressed and decoded, but not yet in any registry.
+    struct MapBinData
+    {
+        std::string path;
+        std::string resources; // Spawners, lights and the ResourceManager, still archived
+        // Still encoded: decoding builds sage::ModelInfo, which isn't safe off the main thread (see
+        // packed::DecodeModel).
+        std::vector<std::pair<std::string, std::string>> models;
+        std::uint32_t itemCount = 0;
+        std::uint32_t staticCount = 0;
+        std::string entities; // Items then resident statics, still archived
+        MapChunkIndex chunkIndex;
+        BakedNavigationGrid navigation;
+        StaticCollisionBvh collisionBvh;
+    };
+
+    // Commits a MapBinData into a registry and the ResourceManager, a slice at a time. Main thread only.
+    class MapLoadCommit
+    {
+        enum class Stage
+        {
+            Resources,
+            Models,
+            Entities,
+            Finish,
+            Done
+        };
+
+        entt::registry* destination;
+        MapBinData data;
+        std::size_t modelCount; // data.models is emptied once they're committed
+        Stage stage = Stage::Resources;
+        std::size_t next = 0; // Model or entity within the current stage
+        std::unique_ptr<std::istream> entityStream; // Reads data.entities in place
+        std::unique_ptr<cereal::BinaryInputArchive> entityInput;
+        std::vector<entt::entity> created; // Items then resident statics, created in one batch
+        MapIdRemap idRemap;
+
+        void commitResources();
+        void createEntities();
+        void finish();
+
+      public:
+        // Commits until 'budget' has passed (checked between models and entities, so a slice can run over by
+        // one of them). Returns true once the whole map is in. duration::max() commits everything in one step.
+        bool Step(std::chrono::steady_clock::duration budget);
+        // 0 to 1, by models and entities committed.
+        [[nodiscard]] float Progress() const;
+
+        MapLoadCommit(entt::registry* destination, MapBinData data);
+        MapLoadCommit(const MapLoadCommit&) = delete;
+        MapLoadCommit& operator=(const MapLoadCommit&) = delete;
+    };
+
+    void SaveMap(entt::registry& source, const char* path, const MapSaveOptions& options = {});
+    // Reads a map bin up to what needs the registry or the ResourceManager: file I/O, decompression, chunk
+    // index, navigation grid and BVH. Models are left encoded for MapLoadCommit to decode. Thread-safe, meant to
+    // be called off the main thread.
+    // Throws std::runtime_error if the bin can't be read or is of another format version.
+    [[nodiscard]] MapBinData ReadMapBin(const char* path, unsigned int jobs = 0);
+    // ReadMapBin and MapLoadCommit in one go, blocking.
     void LoadMap(entt::registry* destination, const char* path);
+
+    // Reads (and, if needed, decompresses) one chunk and 'models' (normally those of the chunk's models that
+    // aren't loaded yet). Thread-safe, meant to be called off the main thread.
+    [[nodiscard]] MapChunkData ReadMapChunk(
+        const std::shared_ptr<const MappedFile>& file,
+        const MapChunkInfo& chunk,
+        const std::vector<MapChunkModel>& models = {});
+    // Decodes the models ReadMapChunk read into the ResourceManager, skipping any that are already there.
+    // Main thread only.
+    void CommitMapChunkModels(MapChunkData& data);
+    // Puts one of source.index.models into the ResourceManager (reading it now) unless it's there already, or
+    // takes it out and frees it. The caller keeps track of which chunks still need it. Main thread only.
+    void LoadMapChunkModel(const MapChunkSource& source, std::uint32_t model);
+    void ReleaseMapChunkModel(const MapChunkSource& source, std::uint32_t model);
+    // Creates the entities of a chunk read by ReadMapChunk. Its models have to be loaded. Main thread only.
+    std::vector<entt::entity> InstantiateMapChunk(entt::registry* destination, std::string_view chunkData);
+    // Loads every chunk model of the loaded map, then instantiates every chunk, for tools that need the whole
+    // map in the registry.
+    void LoadAllMapChunkModels(entt::registry* destination);
+    void LoadAllMapChunks(entt::registry* destination);
 } // namespace lq::maploader
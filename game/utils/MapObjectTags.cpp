@@ -0,0 +1,58 @@
+#include "MapObjectTags.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace lq
+{
+    namespace
+    {
+        using TagEntry = std::pair<std::string_view, MapObjectTag>;
+
+        // Sorted by name so lookups are a binary search.
+        constexpr std::array<TagEntry, 13> tagTable = [] {
+            std::array<TagEntry, 13> table{{
+                {"BLD", MapObjectTag::BLD},
+                {"WALL", MapObjectTag::WALL},
+                {"HOLE", MapObjectTag::HOLE},
+                {"BG", MapObjectTag::BG},
+                {"FLOORSIMPLE", MapObjectTag::FLOORSIMPLE},
+                {"FLOORCOMPLEX", MapObjectTag::FLOORCOMPLEX},
+                {"PROP", MapObjectTag::PROP},
+                {"STAIRS", MapObjectTag::STAIRS},
+                {"MAPBASE", MapObjectTag::MAPBASE},
+                {"ITEM", MapObjectTag::ITEM},
+                {"DOOR", MapObjectTag::DOOR},
+                {"INTERACTABLE", MapObjectTag::INTERACTABLE},
+                {"CHEST", MapObjectTag::CHEST},
+            }};
+            std::ranges::sort(table, {}, &TagEntry::first);
+            return table;
+        }();
+
+        constexpr std::size_t longestTag = std::ranges::max(tagTable, {}, [](const TagEntry& entry) {
+                                               return entry.first.size();
+                                           }).first.size();
+    } // namespace
+
+    MapObjectTag ClassifyMapObjectName(const std::string_view name)
+    {
+        auto out = MapObjectTag::NONE;
+        auto start = name.find('_');
+        while (start != std::string_view::npos)
+        {
+            const auto end = name.find('_', start + 1);
+            if (end == std::string_view::npos) break;
+
+            const auto token = name.substr(start + 1, end - start - 1);
+            if (!token.empty() && token.size() <= longestTag)
+            {
+                const auto it = std::ranges::lower_bound(tagTable, token, {}, &TagEntry::first);
+                if (it != tagTable.end() && it->first == token) out |= it->second;
+            }
+            start = end;
+        }
+        return out;
+    }
+} // namespace lq
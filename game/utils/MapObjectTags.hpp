@@ -0,0 +1,63 @@
+#pragma once
+
+#include "enum_flag_operators.hpp"
+
+#include <string_view>
+
+namespace lq
+{
+    // Tags the Blender exporter embeds in object names as "_TAG_" (e.g. "SM_PROP_Barrel_01").
+    enum class MapObjectTag : unsigned int
+    {
+        NONE = 0,
+        BLD = 1 << 0,
+        WALL = 1 << 1,
+        HOLE = 1 << 2,
+        BG = 1 << 3,
+        FLOORSIMPLE = 1 << 4,
+        FLOORCOMPLEX = 1 << 5,
+        PROP = 1 << 6,
+        STAIRS = 1 << 7,
+        MAPBASE = 1 << 8,
+        ITEM = 1 << 9,
+        DOOR = 1 << 10,
+        INTERACTABLE = 1 << 11,
+        CHEST = 1 << 12,
+        // Not an exporter tag, set by respacker: the object's vertex colours hold its static lighting
+        // ("--bake-lighting"), so it is drawn unlit.
+        BAKEDLIGHT = 1 << 13,
+    };
+
+    template <>
+    struct EnableBitMaskOperators<MapObjectTag>
+    {
+        static const bool enable = true;
+    };
+
+    // Objects the editor can place as plain scenery.
+    constexpr auto EDITOR_PLACEABLE_TAGS = MapObjectTag::BG | MapObjectTag::FLOORSIMPLE |
+                                           MapObjectTag::FLOORCOMPLEX | MapObjectTag::PROP | MapObjectTag::BLD |
+                                           MapObjectTag::WALL | MapObjectTag::HOLE | MapObjectTag::STAIRS;
+
+    // Every tag in 'name', found in one pass over its underscores. Matches the same names as searching for each
+    // "_TAG_" substring (shared underscores included, so "SM_BLD_WALL_01" is BLD | WALL).
+    [[nodiscard]] MapObjectTag ClassifyMapObjectName(std::string_view name);
+
+    // Tags of a static map object. Resolved by respacker and stored in the map bin, so nothing at runtime has to
+    // search renderable names.
+    struct MapObjectTags
+    {
+        MapObjectTag tags = MapObjectTag::NONE;
+
+        [[nodiscard]] bool HasAnyTag(MapObjectTag tagSet) const
+        {
+            return (static_cast<unsigned int>(tags) & static_cast<unsigned int>(tagSet)) != 0;
+        }
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(tags);
+        }
+    };
+} // namespace lq
@@ -0,0 +1,174 @@
+#include "MappedFile.hpp"
+
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lq
+{
+    void MappedFile::release() noexcept
+    {
+#if defined(_WIN32)
+        if (mapped) UnmapViewOfFile(data);
+        if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+        if (fileHandle != nullptr) CloseHandle(fileHandle);
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+        buffer = {};
+        mapped = false;
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data(std::exchange(other.data, nullptr)),
+          size(std::exchange(other.size, 0)),
+          buffer(std::move(other.buffer)),
+          mapped(std::exchange(other.mapped, false))
+#if defined(_WIN32)
+          ,
+          fileHandle(std::exchange(other.fileHandle, nullptr)),
+          mappingHandle(std::exchange(other.mappingHandle, nullptr))
+#endif
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+            buffer = std::move(other.buffer);
+            mapped = std::exchange(other.mapped, false);
+#if defined(_WIN32)
+            fileHandle = std::exchange(other.fileHandle, nullptr);
+            mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        const auto fail = [this, &path](const char* what) {
+            const auto error = static_cast<int>(GetLastError());
+            release();
+            throw std::system_error(error, std::system_category(), std::string(what) + " " + path.string());
+        };
+
+        fileHandle = CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            fileHandle = nullptr;
+            fail("Could not open");
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(fileHandle, &fileSize)) fail("Could not stat");
+        if (fileSize.QuadPart == 0) return;
+
+        if (static_cast<std::size_t>(fileSize.QuadPart) < kMinMappedSize)
+        {
+            buffer.resize(static_cast<std::size_t>(fileSize.QuadPart));
+            DWORD read = 0;
+            if (!ReadFile(fileHandle, buffer.data(), static_cast<DWORD>(buffer.size()), &read, nullptr) ||
+                read != buffer.size())
+            {
+                fail("Could not read");
+            }
+            CloseHandle(fileHandle);
+            fileHandle = nullptr;
+            data = buffer.data();
+            size = buffer.size();
+            return;
+        }
+
+        mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) fail("Could not map");
+        data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (data == nullptr) fail("Could not map");
+        mapped = true;
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Could not open " + path.string());
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "Could not stat " + path.string());
+        }
+
+        const auto fileSize = static_cast<std::size_t>(info.st_size);
+        if (fileSize > 0 && fileSize < kMinMappedSize)
+        {
+            buffer.resize(fileSize);
+            std::size_t offset = 0;
+            while (offset < fileSize)
+            {
+                const auto count = read(fd, buffer.data() + offset, fileSize - offset);
+                if (count <= 0)
+                {
+                    const int error = count < 0 ? errno : EIO;
+                    close(fd);
+                    buffer = {};
+                    throw std::system_error(error, std::generic_category(), "Could not read " + path.string());
+                }
+                offset += static_cast<std::size_t>(count);
+            }
+            data = buffer.data();
+            size = fileSize;
+        }
+        else if (fileSize > 0)
+        {
+            void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                const int error = errno;
+                close(fd);
+                throw std::system_error(error, std::generic_category(), "Could not map " + path.string());
+            }
+            madvise(mapping, fileSize, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+            size = fileSize;
+            mapped = true;
+        }
+        close(fd); // The mapping keeps its own reference to the file.
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        release();
+    }
+} // namespace lq
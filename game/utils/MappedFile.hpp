@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace lq
+{
+    // Read-only memory mapping of a whole file. The view stays valid until the MappedFile is destroyed.
+    // Files under kMinMappedSize are read into an owned buffer instead, as for those the extra syscalls and
+    // page faults of a mapping cost more than the copy. Empty files give an empty view.
+    // Throws std::system_error if the file can't be opened, read or mapped.
+    class MappedFile
+    {
+        const char* data = nullptr;
+        std::size_t size = 0;
+        std::vector<char> buffer; // Only used for small files
+        bool mapped = false;
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+        void release() noexcept;
+
+      public:
+        static constexpr std::size_t kMinMappedSize = 64 * 1024;
+
+        [[nodiscard]] std::string_view View() const
+        {
+            return {data, size};
+        }
+
+        [[nodiscard]] const unsigned char* Data() const
+        {
+            return reinterpret_cast<const unsigned char*>(data);
+        }
+
+        [[nodiscard]] std::size_t Size() const
+        {
+            return size;
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+    };
+} // namespace lq
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <istream>
+#include <streambuf>
+#include <string_view>
+
+namespace lq
+{
+    // Read-only std::istream over bytes owned by someone else (e.g. a MappedFile), so cereal archives can
+    // deserialize straight out of a mapping instead of a std::string copy of it.
+    // The bytes must outlive the stream.
+    class MemoryStreamBuf : public std::streambuf
+    {
+      protected:
+        pos_type seekoff(
+            const off_type off, const std::ios_base::seekdir dir, const std::ios_base::openmode which) override
+        {
+            if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+            const off_type base = dir == std::ios_base::beg ? 0
+                                  : dir == std::ios_base::cur ? gptr() - eback()
+                                                              : egptr() - eback();
+            const off_type target = base + off;
+            if (target < 0 || target > egptr() - eback()) return pos_type(off_type(-1));
+            setg(eback(), eback() + target, egptr());
+            return pos_type(target);
+        }
+
+        pos_type seekpos(const pos_type pos, const std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+
+      public:
+        explicit MemoryStreamBuf(const std::string_view data)
+        {
+            // std::streambuf's get area is non-const, but nothing here ever writes through it.
+            auto* begin = const_cast<char*>(data.data());
+            setg(begin, begin, begin + data.size());
+        }
+    };
+
+    class MemoryIStream : private MemoryStreamBuf, public std::istream
+    {
+      public:
+        explicit MemoryIStream(const std::string_view data)
+            : MemoryStreamBuf(data), std::istream(static_cast<MemoryStreamBuf*>(this))
+        {
+        }
+    };
+} // namespace lq
@@ -0,0 +1,35 @@
+#include "ModelRelease.hpp"
+
+#include <initializer_list>
+
+namespace lq
+{
+    void ReleaseModel(Model& model)
+    {
+        for (int m = 0; m < model.meshCount; ++m)
+        {
+            auto& mesh = model.meshes[m];
+            if (mesh.vaoId != 0)
+            {
+                UnloadMesh(mesh);
+                continue;
+            }
+            for (auto* buffer : {static_cast<void*>(mesh.vertices), static_cast<void*>(mesh.texcoords),
+                                 static_cast<void*>(mesh.texcoords2), static_cast<void*>(mesh.normals),
+                                 static_cast<void*>(mesh.tangents), static_cast<void*>(mesh.colors),
+                                 static_cast<void*>(mesh.indices), static_cast<void*>(mesh.animVertices),
+                                 static_cast<void*>(mesh.animNormals), static_cast<void*>(mesh.boneIds),
+                                 static_cast<void*>(mesh.boneWeights), static_cast<void*>(mesh.boneMatrices),
+                                 static_cast<void*>(mesh.vboId)})
+            {
+                RL_FREE(buffer);
+            }
+        }
+        RL_FREE(model.meshes);
+        RL_FREE(model.materials);
+        RL_FREE(model.meshMaterial);
+        RL_FREE(model.bones);
+        RL_FREE(model.bindPose);
+        model = {};
+    }
+} // namespace lq
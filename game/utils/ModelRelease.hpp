@@ -0,0 +1,12 @@
+#pragma once
+
+#include "raylib.h"
+
+namespace lq
+{
+    // Frees a model built outside the ResourceManager: its meshes (and their GPU buffers, if they were uploaded),
+    // bones, bind pose and its arrays of materials. The materials themselves are shared through the
+    // ResourceManager's material pool and stay. Leaves 'model' empty.
+    // Safe on a worker thread as long as none of the meshes were uploaded.
+    void ReleaseModel(Model& model);
+} // namespace lq
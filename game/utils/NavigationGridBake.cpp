@@ -0,0 +1,73 @@
+#include "NavigationGridBake.hpp"
+
+#include "engine/components/NavigationGridSquare.hpp"
+#include "engine/systems/NavigationGridSystem.hpp"
+
+#include "collision/RpgCollisionLayers.hpp"
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+
+namespace lq::maploader
+{
+    bool IsNavigationObstacle(const sage::Collideable& collideable)
+    {
+        return collideable.blocksNavigation || collideable.collisionLayer == collision_layers::Building;
+    }
+
+    BakedNavigationGrid BakeNavigationGrid(
+        sage::NavigationGridSystem& grid, const int slices, const float spacing, const entt::registry& registry)
+    {
+        BakedNavigationGrid baked;
+        baked.slices = slices;
+        baked.spacing = spacing;
+        const auto squares = static_cast<std::size_t>(slices) * static_cast<std::size_t>(slices);
+        baked.heights.reserve(squares);
+        baked.normals.reserve(squares * 2);
+        baked.occupied.assign((squares + 63) / 64, 0);
+
+        for (int row = 0; row < slices; ++row)
+        {
+            for (int col = 0; col < slices; ++col)
+            {
+                const auto* square = grid.GetGridSquare(row, col);
+                baked.heights.push_back(packed::FloatToHalf(square->heightMap.GetHeight()));
+                const auto normal = packed::OctEncode(square->normalMap.GetNormal());
+                baked.normals.insert(baked.normals.end(), normal.begin(), normal.end());
+            }
+        }
+
+        for (const auto [entity, collideable] : registry.view<sage::Collideable>().each())
+        {
+            if (!collideable.isStatic || !IsNavigationObstacle(collideable)) continue;
+            sage::GridSquare first{};
+            sage::GridSquare last{};
+            grid.WorldToGridSpace(collideable.worldBoundingBox.min, first);
+            grid.WorldToGridSpace(collideable.worldBoundingBox.max, last);
+            for (int row = std::max(0, first.row); row <= std::min(slices - 1, last.row); ++row)
+            {
+                for (int col = std::max(0, first.col); col <= std::min(slices - 1, last.col); ++col)
+                {
+                    const auto i = static_cast<std::size_t>(row) * slices + col;
+                    baked.occupied[i / 64] |= std::uint64_t{1} << (i % 64);
+                }
+            }
+        }
+        return baked;
+    }
+
+    void ApplyBakedNavigationGrid(const BakedNavigationGrid& baked, sage::NavigationGridSystem& grid)
+    {
+        std::size_t i = 0;
+        for (int row = 0; row < baked.slices; ++row)
+        {
+            for (int col = 0; col < baked.slices; ++col, ++i)
+            {
+                auto* square = grid.GetGridSquare(row, col);
+                square->heightMap.SetHeight(packed::HalfToFloat(baked.heights[i]));
+                square->normalMap.SetNormal(packed::OctDecode(baked.normals[i * 2], baked.normals[i * 2 + 1]));
+                square->occupied = (baked.occupied[i / 64] >> (i % 64) & 1) != 0;
+            }
+        }
+    }
+} // namespace lq::maploader
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "engine/components/Collideable.hpp"
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/vector.hpp"
+#include "entt/entt.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sage
+{
+    class NavigationGridSystem;
+}
+
+namespace lq::maploader
+{
+    // The navigation grid as respacker computed it, stored in the map bin and copied back into the grid square
+    // by square when the scene loads. Replaces the HEIGHT_MAP/NORMAL_MAP images the grid used to be rebuilt
+    // from, which quantised heights to 8 bits and had to be decoded pixel by pixel.
+    // Stored in the registry context by LoadMap (absent if the bin has no grid).
+    struct BakedNavigationGrid
+    {
+        int slices = 0; // Squares per side
+        float spacing = 1.0f;
+        std::vector<std::uint16_t> heights;  // Half floats, row major
+        std::vector<std::int16_t> normals;   // 2 per square, octahedral (see VertexQuantization.hpp)
+        std::vector<std::uint64_t> occupied; // One bit per square blocked by static geometry
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(slices, spacing, heights, normals, occupied);
+        }
+    };
+
+    // Static geometry pathfinding has to go around.
+    [[nodiscard]] bool IsNavigationObstacle(const sage::Collideable& collideable);
+
+    // Reads heights and normals from 'grid' (after Init and InitGridHeightAndNormals) and marks the squares
+    // under every static obstacle in 'registry' (collideables that block navigation, buildings).
+    [[nodiscard]] BakedNavigationGrid BakeNavigationGrid(
+        sage::NavigationGridSystem& grid, int slices, float spacing, const entt::registry& registry);
+    // 'grid' must have been initialised with baked.slices and baked.spacing.
+    void ApplyBakedNavigationGrid(const BakedNavigationGrid& baked, sage::NavigationGridSystem& grid);
+} // namespace lq::maploader
@@ -0,0 +1,118 @@
+#include "PackedModel.hpp"
+
+#include "AnimationSerializer.hpp"
+#include "MemoryStream.hpp"
+
+#include "engine/raylib-cereal.hpp"
+#include "engine/ResourceManager.hpp"
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace lq::packed
+{
+    std::string EncodeModel(const sage::ModelInfo& info, const bool quantize, VertexBytes* vertexBytes)
+    {
+        std::ostringstream stream(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive archive(stream);
+            archive(quantize);
+            if (!quantize)
+            {
+                archive(info);
+            }
+            else
+            {
+                // The float attributes are left out of the model itself and follow it in their quantized form.
+                std::vector<Mesh> meshes(info.model.meshes, info.model.meshes + info.model.meshCount);
+                std::vector<QuantizedAttributes> attributes;
+                attributes.reserve(meshes.size());
+                for (auto& mesh : meshes)
+                {
+                    attributes.push_back(QuantizeAttributes(mesh));
+                    if (vertexBytes != nullptr) *vertexBytes += MeasureVertexBytes(mesh, attributes.back());
+                    mesh.vertices = mesh.normals = mesh.tangents = mesh.texcoords = mesh.texcoords2 = nullptr;
+                }
+                auto stripped = info;
+                stripped.model.meshes = meshes.data();
+                archive(stripped, attributes);
+            }
+        }
+        return std::move(stream).str();
+    }
+
+    sage::ModelInfo DecodeModel(const std::string_view data)
+    {
+        MemoryIStream stream(data);
+        cereal::BinaryInputArchive archive(stream);
+        bool quantized = false;
+        archive(quantized);
+        sage::ModelInfo info{};
+        archive(info);
+        if (quantized)
+        {
+            std::vector<QuantizedAttributes> attributes;
+            archive(attributes);
+            for (int m = 0; m < info.model.meshCount && m < static_cast<int>(attributes.size()); ++m)
+            {
+                DequantizeAttributes(attributes[m], info.model.meshes[m]);
+            }
+        }
+        return info;
+    }
+
+    std::string EncodeAnimations(
+        const ModelAnimation* animations,
+        const int count,
+        const bool compress,
+        const AnimationTolerances& tolerances)
+    {
+        const bool compressed =
+            compress && std::all_of(animations, animations + count, [](const ModelAnimation& animation) {
+                return CanCompressClip(animation);
+            });
+        std::ostringstream stream(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive archive(stream);
+            archive(compressed);
+            if (!compressed)
+            {
+                serializer::SaveModelAnimations(archive, animations, count);
+            }
+            else
+            {
+                std::vector<CompressedClip> clips;
+                clips.reserve(count);
+                for (int i = 0; i < count; ++i)
+                {
+                    clips.push_back(CompressClip(animations[i], tolerances));
+                }
+                archive(clips);
+            }
+        }
+        return std::move(stream).str();
+    }
+
+    std::pair<ModelAnimation*, int> DecodeAnimations(const std::string_view data)
+    {
+        MemoryIStream stream(data);
+        cereal::BinaryInputArchive archive(stream);
+        bool compressed = false;
+        archive(compressed);
+        if (!compressed) return serializer::LoadModelAnimations(archive);
+
+        std::vector<CompressedClip> clips;
+        archive(clips);
+        const auto count = static_cast<int>(clips.size());
+        auto* animations = static_cast<ModelAnimation*>(RL_CALLOC(count, sizeof(ModelAnimation)));
+        for (int i = 0; i < count; ++i)
+        {
+            DecompressClip(clips[i], animations[i]);
+        }
+        return {animations, count};
+    }
+} // namespace lq::packed
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "AnimationCompression.hpp"
+#include "VertexQuantization.hpp"
+
+#include "raylib.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sage
+{
+    struct ModelInfo;
+}
+
+// Encoding of the individual model/animation entries stored in an asset pack (see AssetPack.hpp).
+// Every entry is self-contained so it can be decoded without touching the rest of the pack.
+namespace lq::packed
+{
+    // With 'quantize', positions, normals, tangents and UVs are stored in the formats of VertexQuantization.hpp
+    // instead of as floats. DecodeModel reads both.
+    [[nodiscard]] std::string EncodeModel(
+        const sage::ModelInfo& info, bool quantize = false, VertexBytes* vertexBytes = nullptr);
+    // Main thread only: sage::ModelInfo's deserialization is the engine's, and isn't guaranteed to stay clear of
+    // the ResourceManager or GL. Read entries on a worker and decode them here (see MapLoadCommit).
+    [[nodiscard]] sage::ModelInfo DecodeModel(std::string_view data);
+
+    // With 'compress', clips go through CompressClip (see AnimationCompression.hpp). DecodeAnimations reads
+    // both.
+    [[nodiscard]] std::string EncodeAnimations(
+        const ModelAnimation* animations,
+        int count,
+        bool compress = false,
+        const AnimationTolerances& tolerances = {});
+    // Buffers are allocated with RL_MALLOC, release with UnloadModelAnimations.
+    [[nodiscard]] std::pair<ModelAnimation*, int> DecodeAnimations(std::string_view data);
+} // namespace lq::packed
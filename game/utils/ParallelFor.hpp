@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lq
+{
+    // Resolves a user supplied job count. 0 means "one worker per hardware thread".
+    [[nodiscard]] inline unsigned int ResolveJobCount(const unsigned int jobs)
+    {
+        if (jobs > 0) return jobs;
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Calls fn(i) for every i in [0, count), spread over 'jobs' threads (the calling thread is one of them).
+    // Indices are handed out dynamically, so uneven work (e.g. a huge model next to a tiny icon) balances out.
+    // The first exception thrown by fn is rethrown on the calling thread once every worker has stopped.
+    template <typename Fn>
+    void ParallelFor(const std::size_t count, const unsigned int jobs, Fn&& fn)
+    {
+        const auto workerCount = static_cast<std::size_t>(std::min<std::size_t>(ResolveJobCount(jobs), count));
+        if (workerCount <= 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                fn(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next{0};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        auto work = [&]() {
+            for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            {
+                try
+                {
+                    fn(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(errorMutex);
+                    if (!error) error = std::current_exception();
+                    next.store(count); // Stop handing out work
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount - 1);
+        for (std::size_t i = 1; i < workerCount; ++i)
+        {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        if (error) std::rethrow_exception(error);
+    }
+} // namespace lq
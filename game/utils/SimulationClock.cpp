@@ -0,0 +1,34 @@
+#include "SimulationClock.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace lq
+{
+    int SimulationClock::Advance(const float frameSeconds)
+    {
+        frameTime = std::clamp(frameSeconds, 0.0f, maxFrameTime);
+        accumulator += frameTime;
+        auto steps = static_cast<int>(accumulator / step);
+        accumulator -= static_cast<float>(steps) * step;
+        if (steps > maxStepsPerFrame)
+        {
+            droppedSteps += static_cast<std::uint64_t>(steps - maxStepsPerFrame);
+            steps = maxStepsPerFrame;
+        }
+        return steps;
+    }
+
+    void SimulationClock::Tick()
+    {
+        time += step;
+        ++ticks;
+    }
+
+    SimulationClock::SimulationClock(
+        const float stepsPerSecond, const int _maxStepsPerFrame, const float _maxFrameTime)
+        : step(1.0f / stepsPerSecond), maxStepsPerFrame(_maxStepsPerFrame), maxFrameTime(_maxFrameTime)
+    {
+        assert(stepsPerSecond > 0 && maxStepsPerFrame > 0);
+    }
+} // namespace lq
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lq
+{
+    // Fixed-step simulation time, decoupled from the render rate. Each rendered frame, the main loop passes the
+    // frame's duration to Advance and runs the simulation as many steps as it returns, each DeltaTime() long.
+    // Time that doesn't make up a whole step carries over to the next frame.
+    //
+    // A long frame (a GPU stall, the window being dragged) is clamped to maxFrameTime, and no more than
+    // maxStepsPerFrame steps are run for it: the simulation skips ahead instead of taking one huge step or
+    // spiralling into ever longer catch-up frames.
+    //
+    // Stored in the registry context by Application. Systems that run per rendered frame use FrameTime().
+    //
+    // Only game logic is stepped so far: the state machines and ability timers. Engine movement, collision and
+    // animation still run once per rendered frame on raylib's frame time (they take no dt), so AI decides at
+    // the step rate while the movement it starts advances at the frame rate. Nothing drawn is simulated per
+    // step yet, so there are no transforms to interpolate; that needs those engine systems to take a dt first.
+    class SimulationClock
+    {
+        float step;
+        int maxStepsPerFrame;
+        float maxFrameTime;
+        float frameTime = 0;
+        float accumulator = 0;
+        double time = 0;
+        std::uint64_t ticks = 0;
+        std::uint64_t droppedSteps = 0;
+
+      public:
+        // Adds a rendered frame and returns how many steps to simulate for it.
+        int Advance(float frameSeconds);
+        // Marks one simulated step as done.
+        void Tick();
+
+        // Length of one simulation step, in seconds.
+        [[nodiscard]] float DeltaTime() const
+        {
+            return step;
+        }
+
+        // The last rendered frame's duration after clamping, for per-frame (presentation) systems.
+        [[nodiscard]] float FrameTime() const
+        {
+            return frameTime;
+        }
+
+        // Simulated seconds since start.
+        [[nodiscard]] double Time() const
+        {
+            return time;
+        }
+
+        [[nodiscard]] std::uint64_t Ticks() const
+        {
+            return ticks;
+        }
+
+        // Steps skipped because a frame needed more than maxStepsPerFrame.
+        [[nodiscard]] std::uint64_t DroppedSteps() const
+        {
+            return droppedSteps;
+        }
+
+        explicit SimulationClock(float stepsPerSecond = 60, int maxStepsPerFrame = 4, float maxFrameTime = 0.25f);
+    };
+} // namespace lq
@@ -0,0 +1,328 @@
+#include "StaticCollisionBvh.hpp"
+
+#include "engine/components/Collideable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace lq
+{
+    namespace
+    {
+        constexpr int kBins = 16;
+        constexpr std::size_t kMaxLeafPrimitives = 8;
+        // Bounds the traversal stack. Deeper subtrees are split at the median, which can't go this deep.
+        constexpr int kMaxSahDepth = 40;
+        constexpr std::size_t kStackSize = 64;
+        // Cost of visiting a node relative to testing one primitive.
+        constexpr float kTraversalCost = 1.0f;
+        constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+        BoundingBox emptyBox()
+        {
+            return {{kInfinity, kInfinity, kInfinity}, {-kInfinity, -kInfinity, -kInfinity}};
+        }
+
+        void grow(BoundingBox& box, const Vector3& point)
+        {
+            box.min = {std::min(box.min.x, point.x), std::min(box.min.y, point.y), std::min(box.min.z, point.z)};
+            box.max = {std::max(box.max.x, point.x), std::max(box.max.y, point.y), std::max(box.max.z, point.z)};
+        }
+
+        void grow(BoundingBox& box, const BoundingBox& other)
+        {
+            grow(box, other.min);
+            grow(box, other.max);
+        }
+
+        float surfaceArea(const BoundingBox& box)
+        {
+            const float x = box.max.x - box.min.x;
+            const float y = box.max.y - box.min.y;
+            const float z = box.max.z - box.min.z;
+            if (x < 0 || y < 0 || z < 0) return 0;
+            return 2.0f * (x * y + y * z + z * x);
+        }
+
+        float axis(const Vector3& v, const int a)
+        {
+            return a == 0 ? v.x : a == 1 ? v.y : v.z;
+        }
+
+        float centroid(const BoundingBox& box, const int a)
+        {
+            return (axis(box.min, a) + axis(box.max, a)) * 0.5f;
+        }
+
+        // Slab test. Gives the distance at which the ray enters the box (0 if it starts inside).
+        bool intersect(
+            const BoundingBox& box,
+            const Vector3& origin,
+            const Vector3& inverse,
+            const float maxDistance,
+            float& entry)
+        {
+            float tMin = 0.0f;
+            float tMax = maxDistance;
+            for (int a = 0; a < 3; ++a)
+            {
+                const float t0 = (axis(box.min, a) - axis(origin, a)) * axis(inverse, a);
+                const float t1 = (axis(box.max, a) - axis(origin, a)) * axis(inverse, a);
+                // fmin/fmax drop the NaN of a ray running exactly along a slab plane.
+                tMin = std::fmax(tMin, std::fmin(t0, t1));
+                tMax = std::fmin(tMax, std::fmax(t0, t1));
+            }
+            entry = tMin;
+            return tMin <= tMax;
+        }
+    } // namespace
+
+    StaticCollisionBvh StaticCollisionBvh::Build(std::vector<Primitive> primitives)
+    {
+        StaticCollisionBvh bvh;
+        if (!primitives.empty())
+        {
+            bvh.nodes.reserve(primitives.size() * 2);
+            bvh.build(primitives, 0, primitives.size(), 0);
+        }
+        bvh.primitives = std::move(primitives);
+        bvh.idOrder.resize(bvh.primitives.size());
+        for (std::uint32_t i = 0; i < bvh.idOrder.size(); ++i)
+        {
+            bvh.idOrder[i] = i;
+        }
+        std::ranges::sort(bvh.idOrder, [&bvh](const std::uint32_t a, const std::uint32_t b) {
+            return bvh.primitives[a].mapId < bvh.primitives[b].mapId;
+        });
+        return bvh;
+    }
+
+    std::uint32_t StaticCollisionBvh::build(
+        std::vector<Primitive>& items, const std::size_t begin, const std::size_t end, const int depth)
+    {
+        const auto nodeIndex = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back();
+
+        auto bounds = emptyBox();
+        auto centroids = emptyBox();
+        for (auto i = begin; i < end; ++i)
+        {
+            grow(bounds, items[i].bounds);
+            const auto& box = items[i].bounds;
+            grow(centroids, Vector3{centroid(box, 0), centroid(box, 1), centroid(box, 2)});
+        }
+        nodes[nodeIndex].bounds = bounds;
+
+        const auto count = end - begin;
+        const auto makeLeaf = [&] {
+            nodes[nodeIndex].index = static_cast<std::uint32_t>(begin);
+            nodes[nodeIndex].count = static_cast<std::uint32_t>(count);
+            return nodeIndex;
+        };
+        if (count <= 2) return makeLeaf();
+
+        // Binned SAH (Wald, "On fast Construction of SAH-based Bounding Volume Hierarchies"): primitives are
+        // sorted into kBins slabs by centroid along each axis and every boundary between slabs is scored.
+        struct Bin
+        {
+            BoundingBox bounds = emptyBox();
+            std::size_t count = 0;
+        };
+        float bestCost = kInfinity;
+        int bestAxis = -1;
+        int bestSplit = 0;
+        for (int a = 0; a < 3 && depth < kMaxSahDepth; ++a)
+        {
+            const float lo = axis(centroids.min, a);
+            const float extent = axis(centroids.max, a) - lo;
+            if (extent <= 0.0f) continue;
+            const float scale = kBins / extent;
+
+            std::array<Bin, kBins> bins{};
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto bin =
+                    std::min(kBins - 1, static_cast<int>((centroid(items[i].bounds, a) - lo) * scale));
+                grow(bins[bin].bounds, items[i].bounds);
+                ++bins[bin].count;
+            }
+
+            // Right to left sweep for the areas/counts right of each boundary, then left to right to score.
+            std::array<float, kBins> rightArea{};
+            std::array<std::size_t, kBins> rightCount{};
+            auto right = emptyBox();
+            std::size_t rightSum = 0;
+            for (int b = kBins - 1; b > 0; --b)
+            {
+                grow(right, bins[b].bounds);
+                rightSum += bins[b].count;
+                rightArea[b] = surfaceArea(right);
+                rightCount[b] = rightSum;
+            }
+            auto left = emptyBox();
+            std::size_t leftSum = 0;
+            for (int b = 0; b < kBins - 1; ++b)
+            {
+                grow(left, bins[b].bounds);
+                leftSum += bins[b].count;
+                if (leftSum == 0 || rightCount[b + 1] == 0) continue;
+                const float cost = surfaceArea(left) * static_cast<float>(leftSum) +
+                                   rightArea[b + 1] * static_cast<float>(rightCount[b + 1]);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = a;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        const float area = surfaceArea(bounds);
+        const float splitCost = kTraversalCost + (area > 0.0f ? bestCost / area : 0.0f);
+        const bool splitPays = bestAxis >= 0 && splitCost < static_cast<float>(count);
+        if (!splitPays && (count <= kMaxLeafPrimitives || depth >= static_cast<int>(kStackSize) - 2))
+        {
+            return makeLeaf();
+        }
+
+        std::size_t middle;
+        if (bestAxis >= 0)
+        {
+            const float lo = axis(centroids.min, bestAxis);
+            const float scale = kBins / (axis(centroids.max, bestAxis) - lo);
+            const auto inLeftHalf = [&](const Primitive& p) {
+                return std::min(kBins - 1, static_cast<int>((centroid(p.bounds, bestAxis) - lo) * scale)) <=
+                       bestSplit;
+            };
+            const auto split = std::partition(items.begin() + begin, items.begin() + end, inLeftHalf);
+            middle = split - items.begin();
+        }
+        else
+        {
+            // Centroids all in one place (stacked copies of an object), or too deep for SAH: halve the list.
+            middle = begin + count / 2;
+        }
+
+        build(items, begin, middle, depth + 1);
+        const auto second = build(items, middle, end, depth + 1);
+        nodes[nodeIndex].index = second;
+        nodes[nodeIndex].count = 0;
+        return nodeIndex;
+    }
+
+    void StaticCollisionBvh::Bind(
+        const std::span<const entt::entity> byMapId, const std::span<const std::uint32_t> mapIds)
+    {
+        entities.resize(primitives.size(), entt::null);
+        for (const auto mapId : mapIds)
+        {
+            const auto entity = mapId < byMapId.size() ? byMapId[mapId] : entt::null;
+            if (entity == entt::null) continue;
+            const auto it = std::ranges::lower_bound(
+                idOrder, mapId, {}, [this](const std::uint32_t i) { return primitives[i].mapId; });
+            if (it != idOrder.end() && primitives[*it].mapId == mapId) entities[*it] = entity;
+        }
+    }
+
+    template <typename Visit>
+    void StaticCollisionBvh::traverse(const Ray& ray, float& maxDistance, Visit&& visit) const
+    {
+        if (nodes.empty()) return;
+        const Vector3 inverse{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+
+        // Node and the distance the ray enters it at, so subtrees behind a closer hit found meanwhile are skipped.
+        std::array<std::pair<std::uint32_t, float>, kStackSize> stack{};
+        std::size_t size = 0;
+        float entry = 0;
+        if (!intersect(nodes[0].bounds, ray.position, inverse, maxDistance, entry)) return;
+        stack[size++] = {0, entry};
+        while (size > 0)
+        {
+            const auto [index, nodeEntry] = stack[--size];
+            if (nodeEntry > maxDistance) continue;
+            const auto& node = nodes[index];
+            if (node.count > 0)
+            {
+                for (auto p = node.index; p < node.index + node.count; ++p)
+                {
+                    visit(p);
+                }
+                continue;
+            }
+
+            const auto first = index + 1;
+            const auto second = node.index;
+            float firstEntry = 0;
+            float secondEntry = 0;
+            const bool hitFirst = intersect(nodes[first].bounds, ray.position, inverse, maxDistance, firstEntry);
+            const bool hitSecond =
+                intersect(nodes[second].bounds, ray.position, inverse, maxDistance, secondEntry);
+            // Push the farther child first, so the nearer one is visited first.
+            if (hitFirst && hitSecond)
+            {
+                const bool firstNearer = firstEntry <= secondEntry;
+                stack[size++] = firstNearer ? std::pair{second, secondEntry} : std::pair{first, firstEntry};
+                stack[size++] = firstNearer ? std::pair{first, firstEntry} : std::pair{second, secondEntry};
+            }
+            else if (hitFirst)
+            {
+                stack[size++] = {first, firstEntry};
+            }
+            else if (hitSecond)
+            {
+                stack[size++] = {second, secondEntry};
+            }
+        }
+    }
+
+    std::pair<BoundingBox, sage::CollisionLayer> StaticCollisionBvh::current(
+        const entt::registry& registry, const std::size_t primitive, entt::entity& entity) const
+    {
+        entity = primitive < entities.size() ? entities[primitive] : entt::null;
+        if (entity != entt::null && registry.valid(entity))
+        {
+            if (const auto* collideable = registry.try_get<sage::Collideable>(entity))
+            {
+                return {collideable->worldBoundingBox, collideable->collisionLayer};
+            }
+        }
+        entity = entt::null; // Not loaded (or streamed out again)
+        return {primitives[primitive].bounds, primitives[primitive].layer};
+    }
+
+    std::optional<StaticCollisionBvh::RayHit> StaticCollisionBvh::FirstHit(
+        const entt::registry& registry,
+        const Ray& ray,
+        float maxDistance,
+        const std::function<bool(sage::CollisionLayer)>& accept) const
+    {
+        const Vector3 inverse{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+        std::optional<RayHit> best;
+        traverse(ray, maxDistance, [&](const std::uint32_t p) {
+            entt::entity entity;
+            const auto [box, layer] = current(registry, p, entity);
+            float entry = 0;
+            if (!accept(layer) || !intersect(box, ray.position, inverse, maxDistance, entry)) return;
+            best = RayHit{entity, layer, entry};
+            maxDistance = entry;
+        });
+        return best;
+    }
+
+    std::vector<StaticCollisionBvh::RayHit> StaticCollisionBvh::Raycast(
+        const entt::registry& registry, const Ray& ray, float maxDistance) const
+    {
+        const Vector3 inverse{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+        std::vector<RayHit> hits;
+        traverse(ray, maxDistance, [&](const std::uint32_t p) {
+            entt::entity entity;
+            const auto [box, layer] = current(registry, p, entity);
+            float entry = 0;
+            if (intersect(box, ray.position, inverse, maxDistance, entry)) hits.push_back({entity, layer, entry});
+        });
+        std::ranges::sort(hits, {}, &RayHit::distance);
+        return hits;
+    }
+} // namespace lq
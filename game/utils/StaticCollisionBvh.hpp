@@ -0,0 +1,115 @@
+#pragma once
+
+#include "engine/CollisionLayers.hpp"
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/vector.hpp"
+#include "entt/entt.hpp"
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lq
+{
+    // Bounding volume hierarchy over the static colliders of a map (background layer excluded), built by
+    // respacker with a binned surface area heuristic and stored in the map bin. LoadMap only binds the
+    // primitives to the entities it creates (and InstantiateMapChunk to streamed ones); nothing is rebuilt.
+    // Stored in the registry context by LoadMap.
+    //
+    // Only game code queries it (e.g. wavemob line of sight). The cursor's picking happens inside the engine's
+    // Cursor::Update through CollisionSystem, which has no hook for another static geometry query.
+    //
+    // Primitives whose entity is loaded are tested with the entity's current Collideable (so doors that
+    // change layer when opened are seen as they are now). Primitives in unloaded chunks still report their
+    // baked box and layer, with a null entity.
+    class StaticCollisionBvh
+    {
+      public:
+        struct Primitive
+        {
+            BoundingBox bounds{};
+            sage::CollisionLayer layer{};
+            std::uint32_t mapId = 0; // The entity's id in the map bin
+
+            template <class Archive>
+            void serialize(Archive& archive)
+            {
+                archive(bounds, layer, mapId);
+            }
+        };
+
+        struct RayHit
+        {
+            entt::entity entity = entt::null;
+            sage::CollisionLayer layer{};
+            float distance = 0; // Along the (normalised) ray direction. 0 if the ray starts inside the box.
+        };
+
+        [[nodiscard]] static StaticCollisionBvh Build(std::vector<Primitive> primitives);
+
+        // Points the primitives of 'mapIds' (the ids just created, e.g. one chunk's) at their entities. 'byMapId'
+        // is indexed by map id (see maploader::MapIdRemap).
+        void Bind(std::span<const entt::entity> byMapId, std::span<const std::uint32_t> mapIds);
+
+        // Nearest hit within maxDistance whose layer passes 'accept'. 'ray.direction' must be normalised.
+        [[nodiscard]] std::optional<RayHit> FirstHit(
+            const entt::registry& registry,
+            const Ray& ray,
+            float maxDistance,
+            const std::function<bool(sage::CollisionLayer)>& accept) const;
+        // Every hit within maxDistance, nearest first.
+        [[nodiscard]] std::vector<RayHit> Raycast(
+            const entt::registry& registry, const Ray& ray, float maxDistance) const;
+
+        [[nodiscard]] std::size_t PrimitiveCount() const
+        {
+            return primitives.size();
+        }
+
+        [[nodiscard]] std::size_t NodeCount() const
+        {
+            return nodes.size();
+        }
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(nodes, primitives, idOrder);
+        }
+
+      private:
+        // Depth first: an inner node's first child directly follows it.
+        struct Node
+        {
+            BoundingBox bounds{};
+            std::uint32_t index = 0; // Leaf: first primitive. Inner: second child.
+            std::uint32_t count = 0; // Primitives in a leaf, 0 for inner nodes
+
+            template <class Archive>
+            void serialize(Archive& archive)
+            {
+                archive(bounds, index, count);
+            }
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Primitive> primitives;  // In leaf order
+        std::vector<std::uint32_t> idOrder; // Primitive indices sorted by map id, for Bind
+        std::vector<entt::entity> entities; // Per primitive, filled in by Bind
+
+        std::uint32_t build(std::vector<Primitive>& items, std::size_t begin, std::size_t end, int depth);
+        // Calls visit(primitive) for every primitive in a leaf the ray enters within maxDistance, nearer subtrees
+        // first. visit may lower maxDistance to prune the rest.
+        template <typename Visit>
+        void traverse(const Ray& ray, float& maxDistance, Visit&& visit) const;
+        // The box and layer a primitive is tested with, see the class comment.
+        [[nodiscard]] std::pair<BoundingBox, sage::CollisionLayer> current(
+            const entt::registry& registry, std::size_t primitive, entt::entity& entity) const;
+    };
+} // namespace lq
@@ -0,0 +1,171 @@
+#include "SystemScheduler.hpp"
+
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace lq
+{
+    namespace
+    {
+        // Fewer AnyThread systems than this run on the calling thread too.
+        constexpr unsigned int kMinPooledSystems = 2;
+
+        bool overlaps(const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+        {
+            return std::ranges::any_of(
+                a, [&b](const entt::id_type id) { return std::ranges::find(b, id) != b.end(); });
+        }
+    } // namespace
+
+    SystemScheduler::System& SystemScheduler::System::AnyThread()
+    {
+        mainThread = false;
+        return *this;
+    }
+
+    SystemScheduler::System& SystemScheduler::System::Exclusive()
+    {
+        exclusive = true;
+        return *this;
+    }
+
+    SystemScheduler::System& SystemScheduler::Add(std::string name, std::function<void()> update)
+    {
+        built = false;
+        auto& system = systems.emplace_back();
+        system.name = std::move(name);
+        system.update = std::move(update);
+        return system;
+    }
+
+    bool SystemScheduler::conflicts(const System& a, const System& b)
+    {
+        return a.exclusive || b.exclusive || overlaps(a.writes, b.writes) || overlaps(a.writes, b.reads) ||
+               overlaps(a.reads, b.writes);
+    }
+
+    void SystemScheduler::build()
+    {
+        for (auto& system : systems)
+        {
+            system.dependents.clear();
+            system.dependencies = 0;
+        }
+        const auto anyThread = static_cast<unsigned int>(
+            std::ranges::count_if(systems, [](const System& system) { return !system.mainThread; }));
+        const auto workers = anyThread < kMinPooledSystems ? 0 : std::min(maxWorkers, anyThread);
+        if (workers == 0)
+        {
+            pool.reset();
+        }
+        else if (!pool || pool->WorkerCount() != workers)
+        {
+            pool = std::make_unique<WorkStealingPool>(workers);
+        }
+
+        for (std::size_t i = 0; i < systems.size(); ++i)
+        {
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (!conflicts(systems[j], systems[i])) continue;
+                systems[j].dependents.push_back(i);
+                ++systems[i].dependencies;
+            }
+        }
+        remaining = std::make_unique<std::atomic<int>[]>(systems.size());
+        built = true;
+    }
+
+    void SystemScheduler::invoke(const std::size_t index)
+    {
+        try
+        {
+            ProfileScope scope(systems[index].name.c_str());
+            systems[index].update();
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            if (!error) error = std::current_exception();
+            std::cerr << "ERROR: System '" << systems[index].name << "' threw. \n";
+        }
+    }
+
+    void SystemScheduler::execute(const std::size_t index)
+    {
+        invoke(index);
+
+        for (const auto dependent : systems[index].dependents)
+        {
+            if (--remaining[dependent] == 0) dispatch(dependent);
+        }
+        // Notified under the lock: once Run sees the last system finish, the scheduler may be destroyed.
+        std::lock_guard lock(mutex);
+        ++finished;
+        changed.notify_one();
+    }
+
+    void SystemScheduler::dispatch(const std::size_t index)
+    {
+        if (systems[index].mainThread)
+        {
+            std::lock_guard lock(mutex);
+            mainReady.push_back(index);
+            changed.notify_one();
+            return;
+        }
+        pool->Submit([this, index] { execute(index); });
+    }
+
+    void SystemScheduler::Run()
+    {
+        if (!built) build();
+        error = nullptr;
+        if (!pool)
+        {
+            // Systems only depend on ones added before them, so the order added satisfies every dependency.
+            for (std::size_t i = 0; i < systems.size(); ++i)
+            {
+                invoke(i);
+            }
+            if (error) std::rethrow_exception(error);
+            return;
+        }
+
+        finished = 0;
+        for (std::size_t i = 0; i < systems.size(); ++i)
+        {
+            remaining[i] = systems[i].dependencies;
+        }
+        for (std::size_t i = 0; i < systems.size(); ++i)
+        {
+            if (systems[i].dependencies == 0) dispatch(i);
+        }
+
+        std::unique_lock lock(mutex);
+        while (finished < systems.size())
+        {
+            changed.wait(lock, [this] { return !mainReady.empty() || finished == systems.size(); });
+            while (!mainReady.empty())
+            {
+                // Earliest added first, so main thread systems keep their order where nothing else decides it.
+                const auto next = std::ranges::min_element(mainReady);
+                const auto index = *next;
+                mainReady.erase(next);
+                lock.unlock();
+                execute(index);
+                lock.lock();
+            }
+        }
+        lock.unlock();
+        if (error) std::rethrow_exception(error);
+    }
+
+    SystemScheduler::SystemScheduler(const unsigned int _maxWorkers) : maxWorkers(_maxWorkers)
+    {
+    }
+
+    SystemScheduler::~SystemScheduler() = default;
+} // namespace lq
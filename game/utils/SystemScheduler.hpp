@@ -0,0 +1,103 @@
+#pragma once
+
+#include "WorkStealingPool.hpp"
+
+#include "entt/entt.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lq
+{
+    // Runs a frame's systems as a dependency graph instead of one after the other. Each system declares the
+    // components (or other shared state, e.g. the camera) it reads and writes. A system depends on every
+    // system added before it that writes what it reads or writes, or reads what it writes. Systems with nothing
+    // between them run concurrently: main thread systems on the calling thread, the rest on a work-stealing
+    // pool. Anything that touches GL, raylib input or audio, the UI, or creates/destroys entities and
+    // components (entt pools aren't thread-safe for that) has to stay on the main thread.
+    //
+    // Systems are main thread by default. Exclusive systems (e.g. ones whose events can reach anything)
+    // conflict with every other system. Every run of a system is timed under its name (see FrameProfiler).
+    //
+    // The pool is only started once at least two systems are AnyThread, with as many workers as there are such
+    // systems (up to the limit given). Until then a single worker would mostly cost a thread handoff per frame,
+    // so every system runs on the calling thread in the order added, without the graph's bookkeeping.
+    class SystemScheduler
+    {
+      public:
+        class System
+        {
+            friend class SystemScheduler;
+
+            std::string name;
+            std::function<void()> update;
+            std::vector<entt::id_type> reads;
+            std::vector<entt::id_type> writes;
+            bool mainThread = true;
+            bool exclusive = false;
+            std::vector<std::size_t> dependents;
+            int dependencies = 0;
+
+          public:
+            template <typename... T>
+            System& Reads()
+            {
+                (reads.push_back(entt::type_hash<T>::value()), ...);
+                return *this;
+            }
+
+            template <typename... T>
+            System& Writes()
+            {
+                (writes.push_back(entt::type_hash<T>::value()), ...);
+                return *this;
+            }
+
+            // May run on a pool worker.
+            System& AnyThread();
+            System& Exclusive();
+        };
+
+        // Systems run in the order added unless their declarations allow otherwise. The reference is only
+        // valid until the next Add.
+        System& Add(std::string name, std::function<void()> update);
+        // Runs every system once. Rethrows the first exception a system threw, after the rest have run.
+        void Run();
+
+        [[nodiscard]] std::size_t SystemCount() const
+        {
+            return systems.size();
+        }
+
+        // At most 'maxWorkers' worker threads besides the calling thread, 0 runs everything on the calling
+        // thread.
+        explicit SystemScheduler(unsigned int maxWorkers);
+        ~SystemScheduler();
+
+      private:
+        std::vector<System> systems;
+        bool built = false;
+        unsigned int maxWorkers;
+        std::unique_ptr<WorkStealingPool> pool; // Null while no system may run on a worker
+
+        // State of the current Run.
+        std::unique_ptr<std::atomic<int>[]> remaining;
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<std::size_t> mainReady;
+        std::size_t finished = 0;
+        std::exception_ptr error;
+
+        void build();
+        [[nodiscard]] static bool conflicts(const System& a, const System& b);
+        void invoke(std::size_t index);
+        void dispatch(std::size_t index);
+        void execute(std::size_t index);
+    };
+} // namespace lq
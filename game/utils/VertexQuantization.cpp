@@ -0,0 +1,229 @@
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lq::packed
+{
+    namespace
+    {
+        constexpr float kUnorm16Max = 65535.0f;
+        constexpr float kSnorm16Max = 32767.0f;
+
+        std::int16_t toSnorm16(const float value)
+        {
+            return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * kSnorm16Max));
+        }
+
+        float fromSnorm16(const std::int16_t value)
+        {
+            return std::max(static_cast<float>(value) / kSnorm16Max, -1.0f);
+        }
+
+        template <typename T>
+        std::size_t bytesOf(const std::vector<T>& values)
+        {
+            return values.size() * sizeof(T);
+        }
+
+        template <typename T>
+        T* allocate(const std::size_t count)
+        {
+            return static_cast<T*>(RL_MALLOC(count * sizeof(T)));
+        }
+    } // namespace
+
+    std::uint16_t FloatToHalf(const float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+        const std::uint32_t magnitude = bits & 0x7fffffffu;
+
+        if (magnitude >= 0x7f800000u) // Inf and NaN
+        {
+            return sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u : 0u);
+        }
+        if (magnitude >= 0x477ff000u) return sign | 0x7c00u; // Rounds past 65504
+        if (magnitude < 0x38800000u)                         // Below the smallest normal half
+        {
+            float subnormal;
+            std::memcpy(&subnormal, &magnitude, sizeof(subnormal));
+            return sign | static_cast<std::uint16_t>(std::lrint(subnormal * 16777216.0f)); // * 2^24
+        }
+        // Rebias the exponent (127 -> 15) and round the mantissa to 10 bits, ties to even.
+        const std::uint32_t rounded = magnitude + 0x0fffu + ((magnitude >> 13) & 1u);
+        return sign | static_cast<std::uint16_t>((rounded - 0x38000000u) >> 13);
+    }
+
+    float HalfToFloat(const std::uint16_t half)
+    {
+        const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+        const std::uint32_t exponent = (half >> 10) & 0x1fu;
+        const std::uint32_t mantissa = half & 0x03ffu;
+
+        if (exponent == 0)
+        {
+            const float value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign != 0 ? -value : value;
+        }
+        const std::uint32_t bits = exponent == 0x1fu ? sign | 0x7f800000u | (mantissa << 13)
+                                                     : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        float out;
+        std::memcpy(&out, &bits, sizeof(out));
+        return out;
+    }
+
+    std::array<std::int16_t, 2> OctEncode(const Vector3 normal)
+    {
+        const float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+        if (length == 0.0f) return {0, 0};
+        float x = normal.x / length;
+        float y = normal.y / length;
+        if (normal.z < 0.0f)
+        {
+            // Fold the lower hemisphere over the diagonals of the square.
+            const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+        return {toSnorm16(x), toSnorm16(y)};
+    }
+
+    Vector3 OctDecode(const std::int16_t x, const std::int16_t y)
+    {
+        Vector3 out{fromSnorm16(x), fromSnorm16(y), 0.0f};
+        out.z = 1.0f - std::fabs(out.x) - std::fabs(out.y);
+        const float fold = std::max(-out.z, 0.0f);
+        out.x += out.x >= 0.0f ? -fold : fold;
+        out.y += out.y >= 0.0f ? -fold : fold;
+        const float length = std::sqrt(out.x * out.x + out.y * out.y + out.z * out.z);
+        return {out.x / length, out.y / length, out.z / length};
+    }
+
+    QuantizedAttributes QuantizeAttributes(const Mesh& mesh)
+    {
+        QuantizedAttributes out;
+        const auto vertexCount = static_cast<std::size_t>(mesh.vertexCount);
+
+        if (mesh.vertices != nullptr && vertexCount > 0)
+        {
+            out.boundsMin = out.boundsMax = {mesh.vertices[0], mesh.vertices[1], mesh.vertices[2]};
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                const float* p = &mesh.vertices[v * 3];
+                out.boundsMin.x = std::min(out.boundsMin.x, p[0]);
+                out.boundsMin.y = std::min(out.boundsMin.y, p[1]);
+                out.boundsMin.z = std::min(out.boundsMin.z, p[2]);
+                out.boundsMax.x = std::max(out.boundsMax.x, p[0]);
+                out.boundsMax.y = std::max(out.boundsMax.y, p[1]);
+                out.boundsMax.z = std::max(out.boundsMax.z, p[2]);
+            }
+            const float min[3]{out.boundsMin.x, out.boundsMin.y, out.boundsMin.z};
+            const float max[3]{out.boundsMax.x, out.boundsMax.y, out.boundsMax.z};
+            out.positions.resize(vertexCount * 3);
+            for (std::size_t i = 0; i < vertexCount * 3; ++i)
+            {
+                const float extent = max[i % 3] - min[i % 3];
+                const float t = extent > 0.0f ? (mesh.vertices[i] - min[i % 3]) / extent : 0.0f;
+                out.positions[i] =
+                    static_cast<std::uint16_t>(std::lround(std::clamp(t, 0.0f, 1.0f) * kUnorm16Max));
+            }
+        }
+        if (mesh.normals != nullptr)
+        {
+            out.normals.reserve(vertexCount * 2);
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                const float* n = &mesh.normals[v * 3];
+                const auto encoded = OctEncode({n[0], n[1], n[2]});
+                out.normals.insert(out.normals.end(), encoded.begin(), encoded.end());
+            }
+        }
+        if (mesh.tangents != nullptr)
+        {
+            out.tangents.reserve(vertexCount * 3);
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                const float* t = &mesh.tangents[v * 4];
+                const auto encoded = OctEncode({t[0], t[1], t[2]});
+                out.tangents.insert(out.tangents.end(), encoded.begin(), encoded.end());
+                out.tangents.push_back(t[3] < 0.0f ? -32767 : 32767);
+            }
+        }
+        for (auto [from, to] :
+             {std::pair{mesh.texcoords, &out.texcoords}, std::pair{mesh.texcoords2, &out.texcoords2}})
+        {
+            if (from == nullptr) continue;
+            to->resize(vertexCount * 2);
+            std::transform(from, from + vertexCount * 2, to->begin(), FloatToHalf);
+        }
+        return out;
+    }
+
+    void DequantizeAttributes(const QuantizedAttributes& attributes, Mesh& mesh)
+    {
+        const auto vertexCount = static_cast<std::size_t>(mesh.vertexCount);
+
+        if (attributes.positions.size() == vertexCount * 3 && vertexCount > 0)
+        {
+            const float min[3]{attributes.boundsMin.x, attributes.boundsMin.y, attributes.boundsMin.z};
+            const float step[3]{
+                (attributes.boundsMax.x - min[0]) / kUnorm16Max,
+                (attributes.boundsMax.y - min[1]) / kUnorm16Max,
+                (attributes.boundsMax.z - min[2]) / kUnorm16Max};
+            mesh.vertices = allocate<float>(vertexCount * 3);
+            for (std::size_t i = 0; i < vertexCount * 3; ++i)
+            {
+                mesh.vertices[i] = min[i % 3] + static_cast<float>(attributes.positions[i]) * step[i % 3];
+            }
+        }
+        if (attributes.normals.size() == vertexCount * 2 && vertexCount > 0)
+        {
+            mesh.normals = allocate<float>(vertexCount * 3);
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                const auto n = OctDecode(attributes.normals[v * 2], attributes.normals[v * 2 + 1]);
+                mesh.normals[v * 3] = n.x;
+                mesh.normals[v * 3 + 1] = n.y;
+                mesh.normals[v * 3 + 2] = n.z;
+            }
+        }
+        if (attributes.tangents.size() == vertexCount * 3 && vertexCount > 0)
+        {
+            mesh.tangents = allocate<float>(vertexCount * 4);
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                const auto t = OctDecode(attributes.tangents[v * 3], attributes.tangents[v * 3 + 1]);
+                mesh.tangents[v * 4] = t.x;
+                mesh.tangents[v * 4 + 1] = t.y;
+                mesh.tangents[v * 4 + 2] = t.z;
+                mesh.tangents[v * 4 + 3] = attributes.tangents[v * 3 + 2] < 0 ? -1.0f : 1.0f;
+            }
+        }
+        for (auto [from, to] : {
+                 std::pair{&attributes.texcoords, &mesh.texcoords},
+                 std::pair{&attributes.texcoords2, &mesh.texcoords2}})
+        {
+            if (from->size() != vertexCount * 2 || vertexCount == 0) continue;
+            *to = allocate<float>(vertexCount * 2);
+            std::transform(from->begin(), from->end(), *to, HalfToFloat);
+        }
+    }
+
+    VertexBytes MeasureVertexBytes(const Mesh& mesh, const QuantizedAttributes& attributes)
+    {
+        const auto vertexCount = static_cast<std::size_t>(mesh.vertexCount);
+        VertexBytes out;
+        if (mesh.vertices != nullptr) out.original += vertexCount * 3 * sizeof(float);
+        if (mesh.normals != nullptr) out.original += vertexCount * 3 * sizeof(float);
+        if (mesh.tangents != nullptr) out.original += vertexCount * 4 * sizeof(float);
+        if (mesh.texcoords != nullptr) out.original += vertexCount * 2 * sizeof(float);
+        if (mesh.texcoords2 != nullptr) out.original += vertexCount * 2 * sizeof(float);
+        out.stored = sizeof(float) * 6 + bytesOf(attributes.positions) + bytesOf(attributes.normals) +
+                     bytesOf(attributes.tangents) + bytesOf(attributes.texcoords) + bytesOf(attributes.texcoords2);
+        return out;
+    }
+} // namespace lq::packed
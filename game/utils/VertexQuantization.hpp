@@ -0,0 +1,70 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact storage formats for the float vertex attributes of packed meshes (see PackedModel.hpp). raylib only
+// draws float attributes, so meshes are expanded back to floats when they're decoded; the savings are in the
+// pack/map files and the time it takes to read them.
+namespace lq::packed
+{
+    [[nodiscard]] std::uint16_t FloatToHalf(float value);
+    [[nodiscard]] float HalfToFloat(std::uint16_t half);
+
+    // Octahedral unit vector encoding ("A Survey of Efficient Representations for Independent Unit Vectors",
+    // Cigolle et al.) as two snorm16 values. Worst case error is about 0.04 degrees.
+    [[nodiscard]] std::array<std::int16_t, 2> OctEncode(Vector3 normal);
+    [[nodiscard]] Vector3 OctDecode(std::int16_t x, std::int16_t y);
+
+    struct QuantizedAttributes
+    {
+        Vector3 boundsMin{};
+        Vector3 boundsMax{};
+        std::vector<std::uint16_t> positions; // 3 per vertex, unorm16 across the mesh bounds
+        std::vector<std::int16_t> normals;    // 2 per vertex, octahedral
+        std::vector<std::int16_t> tangents;   // 3 per vertex, octahedral xyz and the handedness (w) as +-32767
+        std::vector<std::uint16_t> texcoords; // 2 per vertex, half floats
+        std::vector<std::uint16_t> texcoords2;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(
+                boundsMin.x,
+                boundsMin.y,
+                boundsMin.z,
+                boundsMax.x,
+                boundsMax.y,
+                boundsMax.z,
+                positions,
+                normals,
+                tangents,
+                texcoords,
+                texcoords2);
+        }
+    };
+
+    [[nodiscard]] QuantizedAttributes QuantizeAttributes(const Mesh& mesh);
+    // Allocates (RL_MALLOC) the float attribute arrays of 'mesh' that 'attributes' has data for.
+    void DequantizeAttributes(const QuantizedAttributes& attributes, Mesh& mesh);
+
+    // Size of the attributes covered above, as floats and quantized, for pack reports.
+    struct VertexBytes
+    {
+        std::size_t original = 0;
+        std::size_t stored = 0;
+
+        VertexBytes& operator+=(const VertexBytes& o)
+        {
+            original += o.original;
+            stored += o.stored;
+            return *this;
+        }
+    };
+
+    [[nodiscard]] VertexBytes MeasureVertexBytes(const Mesh& mesh, const QuantizedAttributes& attributes);
+} // namespace lq::packed
@@ -0,0 +1,95 @@
+#include "WorkStealingPool.hpp"
+
+#include <cassert>
+
+namespace lq
+{
+    namespace
+    {
+        // The pool and worker index of the calling thread, if it is a worker.
+        thread_local const WorkStealingPool* currentPool = nullptr;
+        thread_local unsigned int currentWorker = 0;
+    } // namespace
+
+    void WorkStealingPool::Submit(Task task)
+    {
+        assert(!queues.empty());
+        const auto target = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+        {
+            // Counted before it's queued, so taking it can't bring the count below zero.
+            std::lock_guard lock(wakeMutex);
+            ++pending;
+        }
+        {
+            std::lock_guard lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    bool WorkStealingPool::tryRun(const unsigned int self)
+    {
+        Task task;
+        {
+            auto& own = *queues[self];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+        for (std::size_t i = 1; !task && i < queues.size(); ++i)
+        {
+            auto& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        --pending;
+        task();
+        return true;
+    }
+
+    void WorkStealingPool::work(const unsigned int self)
+    {
+        currentPool = this;
+        currentWorker = self;
+        while (true)
+        {
+            if (tryRun(self)) continue;
+            std::unique_lock lock(wakeMutex);
+            wake.wait(lock, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0) return;
+        }
+    }
+
+    WorkStealingPool::WorkStealingPool(const unsigned int workers)
+    {
+        for (unsigned int i = 0; i < workers; ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned int i = 0; i < workers; ++i)
+        {
+            threads.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+} // namespace lq
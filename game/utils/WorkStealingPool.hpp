@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lq
+{
+    // A fixed set of worker threads, each with its own task deque. Workers run their own newest task first (a
+    // task's follow-up work is likely still in cache) and, once out of work, steal the oldest task of another
+    // worker. Tasks submitted from a worker go to its own deque, tasks from outside the pool are spread round
+    // robin.
+    class WorkStealingPool
+    {
+      public:
+        using Task = std::function<void()>;
+
+        // Tasks must not throw; catch inside the task and hand the exception to whoever waits on it.
+        void Submit(Task task);
+
+        [[nodiscard]] unsigned int WorkerCount() const
+        {
+            return static_cast<unsigned int>(threads.size());
+        }
+
+        // 'workers' may be 0, in which case nothing may be submitted.
+        explicit WorkStealingPool(unsigned int workers);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+      private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues; // One per worker
+        std::vector<std::thread> threads;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> pending = 0; // Submitted but not yet taken
+        std::atomic<unsigned int> nextQueue = 0;
+        bool stopping = false;
+
+        bool tryRun(unsigned int self);
+        void work(unsigned int self);
+    };
+} // namespace lq
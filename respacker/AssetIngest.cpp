@@ -0,0 +1,462 @@
+#include "AssetIngest.hpp"
+
+#include "BuildCache.hpp"
+#include "BuildReport.hpp"
+
+#include "engine/raylib-cereal.hpp"
+#include "engine/ResourceManager.hpp"
+#include "engine/slib.hpp"
+
+#include "AnimationSerializer.hpp"
+#include "ParallelFor.hpp"
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace sage
+{
+    namespace
+    {
+        // Files read during the read stage, keyed by normalised path. raylib calls the file callbacks from
+        // whichever thread called the loader, so this is filled before the parse stage starts and only read
+        // until the commit stage is over.
+        std::unordered_map<std::string, const std::vector<unsigned char>*> prefetchedFiles;
+
+        std::string normalisedKey(const fs::path& path)
+        {
+            return path.lexically_normal().generic_string();
+        }
+
+        std::vector<unsigned char> readFile(const fs::path& path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) return {};
+            std::vector<unsigned char> out(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size()));
+            return out;
+        }
+
+        const std::vector<unsigned char>* findPrefetched(const char* fileName)
+        {
+            const auto it = prefetchedFiles.find(normalisedKey(fileName));
+            return it != prefetchedFiles.end() ? it->second : nullptr;
+        }
+
+        // raylib frees the returned buffers with UnloadFileData/UnloadFileText, so they must come from MemAlloc.
+        unsigned char* loadFileDataFromPrefetch(const char* fileName, int* dataSize)
+        {
+            *dataSize = 0;
+            std::vector<unsigned char> fromDisk;
+            const auto* bytes = findPrefetched(fileName);
+            if (bytes == nullptr)
+            {
+                fromDisk = readFile(fileName);
+                if (fromDisk.empty()) return nullptr;
+                bytes = &fromDisk;
+            }
+
+            auto* out = static_cast<unsigned char*>(MemAlloc(static_cast<unsigned int>(bytes->size())));
+            std::memcpy(out, bytes->data(), bytes->size());
+            *dataSize = static_cast<int>(bytes->size());
+            return out;
+        }
+
+        char* loadFileTextFromPrefetch(const char* fileName)
+        {
+            std::vector<unsigned char> fromDisk;
+            const auto* bytes = findPrefetched(fileName);
+            if (bytes == nullptr)
+            {
+                fromDisk = readFile(fileName);
+                if (fromDisk.empty()) return nullptr;
+                bytes = &fromDisk;
+            }
+
+            auto* out = static_cast<char*>(MemAlloc(static_cast<unsigned int>(bytes->size() + 1)));
+            std::memcpy(out, bytes->data(), bytes->size());
+            out[bytes->size()] = '\0';
+            return out;
+        }
+
+        std::string lowercaseExtension(const fs::path& path)
+        {
+            auto extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return std::tolower(c); });
+            return extension;
+        }
+
+        std::string decodeUri(const std::string_view uri)
+        {
+            std::string out;
+            out.reserve(uri.size());
+            for (std::size_t i = 0; i < uri.size(); ++i)
+            {
+                // A malformed escape is kept as written, the path then simply won't be found.
+                unsigned int value = 0;
+                const auto* digits = uri.data() + i + 1;
+                if (uri[i] == '%' && i + 2 < uri.size() &&
+                    std::from_chars(digits, digits + 2, value, 16).ptr == digits + 2)
+                {
+                    out.push_back(static_cast<char>(value));
+                    i += 2;
+                }
+                else
+                {
+                    out.push_back(uri[i]);
+                }
+            }
+            return out;
+        }
+
+        // Files a model pulls in while loading: glTF buffers/images and OBJ material libraries/texture maps.
+        std::vector<fs::path> findDependencies(const fs::path& path, const std::vector<unsigned char>& bytes)
+        {
+            std::vector<fs::path> out;
+            const std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            const auto directory = path.parent_path();
+            const auto extension = lowercaseExtension(path);
+
+            if (extension == ".gltf")
+            {
+                for (auto pos = text.find("\"uri\""); pos != std::string_view::npos;
+                     pos = text.find("\"uri\"", pos + 5))
+                {
+                    const auto open = text.find('"', pos + 5);
+                    const auto close = open == std::string_view::npos ? open : text.find('"', open + 1);
+                    if (close == std::string_view::npos) break;
+                    const auto uri = text.substr(open + 1, close - open - 1);
+                    if (!uri.starts_with("data:")) out.push_back(directory / decodeUri(uri));
+                }
+            }
+            else if (extension == ".obj" || extension == ".mtl")
+            {
+                std::size_t start = 0;
+                while (start < text.size())
+                {
+                    auto end = text.find('\n', start);
+                    if (end == std::string_view::npos) end = text.size();
+                    auto line = text.substr(start, end - start);
+                    start = end + 1;
+
+                    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.remove_suffix(1);
+                    const bool isMaterialLib = line.starts_with("mtllib ");
+                    const bool isTextureMap = line.starts_with("map_") || line.starts_with("bump ") ||
+                                              line.starts_with("disp ") || line.starts_with("norm ");
+                    if (!isMaterialLib && !isTextureMap) continue;
+                    out.push_back(directory / std::string(line.substr(line.find_last_of(' ') + 1)));
+                }
+            }
+            return out;
+        }
+
+        // Hash of a model file plus everything it references, so editing a texture also invalidates the model.
+        std::uint64_t hashWithDependencies(const fs::path& path, const std::vector<unsigned char>& bytes)
+        {
+            auto hash = BuildCache::Hash(bytes.data(), bytes.size());
+            auto pending = findDependencies(path, bytes);
+            std::unordered_set<std::string> seen;
+            while (!pending.empty())
+            {
+                const auto dependency = pending.back();
+                pending.pop_back();
+                const auto key = normalisedKey(dependency);
+                if (!seen.insert(key).second) continue;
+
+                const auto depBytes = readFile(dependency);
+                hash = BuildCache::Hash(key.data(), key.size(), hash);
+                hash = BuildCache::Hash(depBytes.data(), depBytes.size(), hash);
+                if (lowercaseExtension(dependency) == ".mtl")
+                {
+                    const auto nested = findDependencies(dependency, depBytes);
+                    pending.insert(pending.end(), nested.begin(), nested.end());
+                }
+            }
+            return hash;
+        }
+
+        bool isModel(const AssetIngest::Kind kind)
+        {
+            return kind == AssetIngest::Kind::Model || kind == AssetIngest::Kind::AnimatedModel;
+        }
+    } // namespace
+
+    void AssetIngest::decode(Entry& entry) const
+    {
+        const auto start = Clock::now();
+        entry.data = readFile(entry.path);
+        entry.fileSize = entry.data.size();
+        if (entry.data.empty()) return;
+
+        if (cache != nullptr && isModel(entry.kind))
+        {
+            entry.hash = hashWithDependencies(entry.path, entry.data);
+            entry.fromCache = cache->Lookup(normalisedKey(entry.path), entry.hash, entry.cachedBlob);
+            if (entry.fromCache) entry.data = {};
+        }
+
+        if (entry.kind != Kind::Image)
+        {
+            entry.importMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            return;
+        }
+
+        const auto extension = entry.path.extension().string();
+        entry.image = LoadImageFromMemory(
+            extension.c_str(), entry.data.data(), static_cast<int>(entry.data.size()));
+        entry.data = {}; // Decoded pixels are all we need from here on.
+        entry.decodedSize = GetPixelDataSize(entry.image.width, entry.image.height, entry.image.format);
+        entry.importMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void AssetIngest::parse(Entry& entry)
+    {
+        if (!isModel(entry.kind) || entry.fromCache || entry.fileSize == 0) return;
+        const auto start = Clock::now();
+        entry.model = DecodeModelFile(entry.path);
+        if (entry.kind == Kind::AnimatedModel)
+        {
+            entry.animations = DecodeModelAnimationsFile(entry.path, &entry.animationCount);
+        }
+        entry.importMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Registers a parsed model the way ResourceManager::ModelLoadFromFile/ModelAnimationLoadFromFile would.
+    void AssetIngest::importModel(Entry& entry)
+    {
+        auto& rm = ResourceManager::GetInstance();
+        const auto sourcePath = entry.path.string();
+        const auto key = StripPath(sourcePath);
+        if (entry.fileSize == 0)
+        {
+            std::cout << "WARNING: AssetIngest -> Failed to read model " << entry.path << std::endl;
+            return;
+        }
+
+        if (rm.modelCopies.contains(key))
+        {
+            UnloadDecodedModel(std::move(entry.model));
+        }
+        else
+        {
+            auto model = FinishDecodedModel(std::move(entry.model));
+            std::vector<std::string> materialNames;
+            rm.dedupeAndShareMaterials(model, materialNames, sourcePath);
+            rm.StoreModel(ModelInfo{model, std::move(materialNames), sourcePath, /*privateMaterials=*/false}, key);
+        }
+        if (entry.animations != nullptr &&
+            !rm.modelAnimations.try_emplace(key, entry.animations, entry.animationCount).second)
+        {
+            UnloadModelAnimations(entry.animations, entry.animationCount);
+        }
+        entry.animations = nullptr;
+
+        if (cache != nullptr)
+        {
+            cache->Store(normalisedKey(entry.path), entry.hash, captureNewModelEntries());
+        }
+    }
+
+    // Serializes the models (plus the materials they reference) and animations added to the ResourceManager
+    // since the last call.
+    std::string AssetIngest::captureNewModelEntries()
+    {
+        auto& rm = ResourceManager::GetInstance();
+        std::vector<std::string> modelKeys;
+        std::vector<std::string> animationKeys;
+        for (const auto& [key, info] : rm.modelCopies)
+        {
+            if (knownModels.insert(key).second) modelKeys.push_back(key);
+        }
+        for (const auto& [key, animations] : rm.modelAnimations)
+        {
+            if (knownAnimations.insert(key).second) animationKeys.push_back(key);
+        }
+
+        std::vector<std::string> materialNames;
+        for (const auto& key : modelKeys)
+        {
+            for (const auto& name : rm.modelCopies.at(key).materialNames)
+            {
+                if (rm.materialMap.contains(name) && std::ranges::find(materialNames, name) == materialNames.end())
+                {
+                    materialNames.push_back(name);
+                }
+            }
+        }
+
+        std::ostringstream stream(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive archive(stream);
+            archive(materialNames);
+            for (const auto& name : materialNames)
+            {
+                archive(rm.materialMap.at(name));
+            }
+            archive(modelKeys);
+            for (const auto& key : modelKeys)
+            {
+                archive(rm.modelCopies.at(key));
+            }
+            archive(animationKeys);
+            for (const auto& key : animationKeys)
+            {
+                const auto& [animations, count] = rm.modelAnimations.at(key);
+                lq::serializer::SaveModelAnimations(archive, animations, count);
+            }
+        }
+        return std::move(stream).str();
+    }
+
+    void AssetIngest::spliceModelEntries(const std::string& blob)
+    {
+        auto& rm = ResourceManager::GetInstance();
+        std::istringstream stream(blob, std::ios::binary);
+        cereal::BinaryInputArchive archive(stream);
+
+        std::vector<std::string> materialNames;
+        archive(materialNames);
+        for (const auto& name : materialNames)
+        {
+            Material material{};
+            archive(material);
+            rm.materialMap.try_emplace(name, material);
+        }
+
+        std::vector<std::string> modelKeys;
+        archive(modelKeys);
+        for (const auto& key : modelKeys)
+        {
+            ModelInfo info{};
+            archive(info);
+            rm.modelCopies.try_emplace(key, std::move(info));
+        }
+
+        std::vector<std::string> animationKeys;
+        archive(animationKeys);
+        for (const auto& key : animationKeys)
+        {
+            rm.modelAnimations.try_emplace(key, lq::serializer::LoadModelAnimations(archive));
+        }
+    }
+
+    void AssetIngest::commit(Entry& entry)
+    {
+        auto& rm = ResourceManager::GetInstance();
+        switch (entry.kind)
+        {
+        case Kind::Image:
+            if (entry.image.data == nullptr)
+            {
+                std::cout << "WARNING: AssetIngest -> Failed to decode image " << entry.path << std::endl;
+                return;
+            }
+            rm.ImageLoadFromFile(entry.path.string(), entry.image);
+            entry.image = {};
+            break;
+        case Kind::Font:
+            rm.FontLoadFromFile(entry.path);
+            break;
+        case Kind::Model:
+        case Kind::AnimatedModel:
+            if (entry.fromCache)
+            {
+                spliceModelEntries(entry.cachedBlob);
+                entry.cachedBlob = {};
+                break;
+            }
+            importModel(entry);
+            break;
+        case Kind::Dependency:
+            break;
+        }
+    }
+
+    void AssetIngest::record(const Entry& entry) const
+    {
+        BuildReport::Category category;
+        switch (entry.kind)
+        {
+        case Kind::Image:
+            category = BuildReport::ImageCategory(entry.path);
+            break;
+        case Kind::Font:
+            category = BuildReport::Category::Font;
+            break;
+        case Kind::Model:
+        case Kind::AnimatedModel:
+            category = BuildReport::Category::Model;
+            break;
+        case Kind::Dependency:
+        default:
+            return; // Counted in the model that reads it
+        }
+        // Models are keyed by the path the ResourceManager records as their source.
+        auto& asset = report->Find(category, entry.path.string());
+        asset.fileSize = entry.fileSize;
+        if (entry.kind == Kind::Image) asset.rawSize = entry.decodedSize;
+        asset.importMs = entry.importMs;
+        asset.cached = entry.fromCache;
+    }
+
+    void AssetIngest::Add(const Kind kind, const fs::path& path)
+    {
+        entries.push_back(Entry{.kind = kind, .path = path});
+    }
+
+    void AssetIngest::Run(const unsigned int jobs)
+    {
+        if (cache != nullptr)
+        {
+            const auto& rm = ResourceManager::GetInstance();
+            for (const auto& [key, info] : rm.modelCopies)
+                knownModels.insert(key);
+            for (const auto& [key, animations] : rm.modelAnimations)
+                knownAnimations.insert(key);
+        }
+
+        lq::ParallelFor(entries.size(), jobs, [this](const std::size_t i) { decode(entries[i]); });
+
+        for (const auto& entry : entries)
+        {
+            if (!entry.data.empty()) prefetchedFiles.emplace(normalisedKey(entry.path), &entry.data);
+        }
+        SetLoadFileDataCallback(loadFileDataFromPrefetch);
+        SetLoadFileTextCallback(loadFileTextFromPrefetch);
+
+        lq::ParallelFor(entries.size(), jobs, [this](const std::size_t i) { parse(entries[i]); });
+
+        for (auto& entry : entries)
+        {
+            const auto start = Clock::now();
+            commit(entry);
+            entry.importMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (report != nullptr) record(entry);
+        }
+
+        SetLoadFileDataCallback(nullptr);
+        SetLoadFileTextCallback(nullptr);
+        prefetchedFiles.clear();
+        entries.clear();
+    }
+
+    AssetIngest::AssetIngest(BuildCache* _cache, BuildReport* _report) : cache(_cache), report(_report)
+    {
+    }
+} // namespace sage
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ModelDecoder.hpp"
+
+#include "raylib.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace sage
+{
+    class BuildCache;
+    class BuildReport;
+
+    // Imports a list of asset files into the ResourceManager in three stages:
+    //   1. Read: every queued file is read from disk (and images are fully decoded) on a pool of workers.
+    //   2. Parse: models and their animations are decoded on the workers into CPU-side raylib structures (see
+    //      ModelDecoder), with their file reads served from the bytes read in stage 1.
+    //   3. Commit: entries are handed to the ResourceManager on the calling thread, in the order they were
+    //      queued. Only GPU uploads and registration happen here for models; fonts still go through the
+    //      ResourceManager's own loader, reading from the stage 1 bytes.
+    // The ResourceManager sees the same calls in the same order regardless of the job count, so the packed
+    // output of "--jobs 1" and "--jobs N" is byte-identical.
+    //
+    // If a BuildCache is supplied, models whose file (and referenced buffers/textures) hash the same as last
+    // run skip the import entirely and have their cached ResourceManager entries spliced back in.
+    // If a BuildReport is supplied, every imported file is recorded in it with its size and import time.
+    class AssetIngest
+    {
+      public:
+        enum class Kind
+        {
+            Image,
+            Font,
+            Model,
+            AnimatedModel, // Model that also has its animations loaded (glTF/GLB)
+            Dependency     // Only prefetched (e.g. glTF buffers, textures, .mtl) so model loads don't hit disk
+        };
+
+      private:
+        struct Entry
+        {
+            Kind kind;
+            std::filesystem::path path;
+            std::vector<unsigned char> data;
+            Image image{};
+            std::uint64_t hash = 0;
+            std::string cachedBlob;
+            bool fromCache = false;
+            std::uint64_t fileSize = 0;
+            std::uint64_t decodedSize = 0; // Images only
+            DecodedModel model;
+            ModelAnimation* animations = nullptr;
+            int animationCount = 0;
+            double importMs = 0;
+        };
+
+        BuildCache* cache;
+        BuildReport* report;
+        std::vector<Entry> entries;
+        std::unordered_set<std::string> knownModels;
+        std::unordered_set<std::string> knownAnimations;
+
+        void decode(Entry& entry) const;
+        static void parse(Entry& entry);
+        void commit(Entry& entry);
+        void record(const Entry& entry) const;
+        void importModel(Entry& entry);
+        [[nodiscard]] std::string captureNewModelEntries();
+        static void spliceModelEntries(const std::string& blob);
+
+      public:
+        void Add(Kind kind, const std::filesystem::path& path);
+        void Run(unsigned int jobs);
+
+        explicit AssetIngest(BuildCache* _cache = nullptr, BuildReport* _report = nullptr);
+    };
+} // namespace sage
@@ -0,0 +1,145 @@
+#include "AssetPackWriter.hpp"
+
+#include "engine/raylib-cereal.hpp"
+#include "engine/ResourceManager.hpp"
+
+#include "game/utils/FramedCompression.hpp"
+#include "game/utils/PackedModel.hpp"
+#include "game/utils/ParallelFor.hpp"
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <tuple>
+
+namespace sage
+{
+    void AssetPackWriter::Add(std::string key, const lq::AssetPackEntry::Kind kind, std::string data)
+    {
+        lq::AssetPackEntry entry;
+        entry.key = std::move(key);
+        entry.kind = kind;
+        entry.rawSize = static_cast<std::uint32_t>(data.size());
+        pending.push_back({std::move(entry), std::move(data)});
+    }
+
+    void AssetPackWriter::AddResourceManager(const bool quantizeMeshes, const bool compressAnimations)
+    {
+        using Kind = lq::AssetPackEntry::Kind;
+        auto& rm = ResourceManager::GetInstance();
+        lq::packed::VertexBytes vertexBytes;
+        for (const auto& [key, info] : rm.modelCopies)
+        {
+            Add(key, Kind::Model, lq::packed::EncodeModel(info, quantizeMeshes, &vertexBytes));
+        }
+        if (quantizeMeshes)
+        {
+            const auto saved = vertexBytes.original - std::min(vertexBytes.stored, vertexBytes.original);
+            std::cout << "Vertex attributes: " << vertexBytes.original / 1024 << " KiB as floats, "
+                      << vertexBytes.stored / 1024 << " KiB quantized (" << saved / 1024 << " KiB saved). \n";
+        }
+        std::size_t rawAnimationBytes = 0;
+        std::size_t storedAnimationBytes = 0;
+        for (const auto& [key, animations] : rm.modelAnimations)
+        {
+            auto data = lq::packed::EncodeAnimations(animations.first, animations.second, compressAnimations);
+            rawAnimationBytes += lq::packed::RawAnimationBytes(animations.first, animations.second);
+            storedAnimationBytes += data.size();
+            Add(key, Kind::Animation, std::move(data));
+        }
+        if (compressAnimations)
+        {
+            std::cout << "Animations: " << rawAnimationBytes / 1024 << " KiB of poses, "
+                      << storedAnimationBytes / 1024 << " KiB compressed. \n";
+        }
+
+        // Temporarily take the models/animations out so they aren't serialized into Core a second time.
+        auto models = std::move(rm.modelCopies);
+        auto animations = std::move(rm.modelAnimations);
+        rm.modelCopies.clear();
+        rm.modelAnimations.clear();
+        std::ostringstream stream(std::ios::binary);
+        {
+            cereal::BinaryOutputArchive archive(stream);
+            archive(rm);
+        }
+        rm.modelCopies = std::move(models);
+        rm.modelAnimations = std::move(animations);
+        Add("", Kind::Core, std::move(stream).str());
+    }
+
+    std::vector<lq::AssetPackEntry> AssetPackWriter::Write(
+        const std::string& path, const unsigned int jobs, const bool compress)
+    {
+        std::ranges::sort(pending, [](const Pending& a, const Pending& b) {
+            return std::tie(a.entry.kind, a.entry.key) < std::tie(b.entry.kind, b.entry.key);
+        });
+
+        const auto compressEntry = [this, compress](const std::size_t i, const unsigned int blockJobs) {
+            auto& [entry, data] = pending[i];
+            if (compress)
+            {
+                data = lq::framed::Compress(data, blockJobs);
+                entry.compression = lq::AssetPackEntry::Compression::Framed;
+            }
+            else
+            {
+                entry.compression = lq::AssetPackEntry::Compression::None;
+            }
+            entry.size = static_cast<std::uint32_t>(data.size());
+        };
+        // Entries of one block are spread over the workers, larger ones (Core, big models) over their blocks.
+        std::vector<std::size_t> small;
+        std::vector<std::size_t> large;
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            (pending[i].data.size() <= lq::framed::kBlockSize ? small : large).push_back(i);
+        }
+        lq::ParallelFor(small.size(), jobs, [&](const std::size_t i) { compressEntry(small[i], 1); });
+        for (const auto i : large)
+        {
+            compressEntry(i, jobs);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        lq::AssetPackHeader header;
+        header.entryCount = static_cast<std::uint32_t>(pending.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<lq::AssetPackEntry> toc;
+        toc.reserve(pending.size());
+        std::uint64_t offset = sizeof(header);
+        std::uint64_t rawTotal = 0;
+        for (auto& [entry, data] : pending)
+        {
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            entry.offset = offset;
+            offset += entry.size;
+            rawTotal += entry.rawSize;
+            toc.push_back(entry);
+        }
+
+        header.tocOffset = offset;
+        {
+            cereal::BinaryOutputArchive archive(file);
+            archive(toc);
+        }
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!file)
+        {
+            std::cout << "ERROR: AssetPackWriter -> Could not write " << path << std::endl;
+            exit(1);
+        }
+
+        std::cout << "AssetPack: " << toc.size() << " entries, " << rawTotal << " bytes -> " << offset
+                  << " bytes compressed. \n";
+        pending.clear();
+        return toc;
+    }
+} // namespace sage
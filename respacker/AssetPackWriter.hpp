@@ -0,0 +1,33 @@
+#pragma once
+
+#include "game/utils/AssetPack.hpp"
+
+#include <string>
+#include <vector>
+
+namespace sage
+{
+    // Builds an asset pack (see game/utils/AssetPack.hpp). Entries are compressed independently, so Write can
+    // spread them over several jobs; the output only depends on what was added, not on the job count.
+    class AssetPackWriter
+    {
+        struct Pending
+        {
+            lq::AssetPackEntry entry;
+            std::string data;
+        };
+
+        std::vector<Pending> pending;
+
+      public:
+        void Add(std::string key, lq::AssetPackEntry::Kind kind, std::string data);
+        // Entries are written Core first, then ordered by kind and key. Uncompressed packs are bigger on disk but
+        // are read straight out of the memory mapping at runtime. Returns the table of contents written.
+        std::vector<lq::AssetPackEntry> Write(const std::string& path, unsigned int jobs, bool compress = true);
+
+        // Splits the ResourceManager's models and animations into their own entries and packs the rest as Core.
+        // 'quantizeMeshes' stores model vertex attributes quantized (see game/utils/VertexQuantization.hpp),
+        // 'compressAnimations' stores animation clips compressed (see game/utils/AnimationCompression.hpp).
+        void AddResourceManager(bool quantizeMeshes = false, bool compressAnimations = false);
+    };
+} // namespace sage
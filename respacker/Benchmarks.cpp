@@ -0,0 +1,653 @@
+#include "Benchmarks.hpp"
+
+#include "MapDescriptor.hpp"
+#include "ModelDecoder.hpp"
+
+#include "engine/components/Collideable.hpp"
+#include "engine/components/DoorBehaviorComponent.hpp"
+#include "engine/components/Renderable.hpp"
+#include "engine/components/sgTransform.hpp"
+#include "engine/ResourceManager.hpp"
+#include "engine/Serializer.hpp"
+
+#include "game/src/components/DialogComponent.hpp"
+#include "game/src/components/InventoryComponent.hpp"
+#include "game/src/components/StaticBatchMember.hpp"
+#include "game/utils/FramedCompression.hpp"
+#include "game/utils/MapLoader.hpp"
+#include "game/utils/MapObjectTags.hpp"
+#include "game/utils/MemoryStream.hpp"
+#include "game/utils/ParallelFor.hpp"
+#include "game/utils/StaticCollisionBvh.hpp"
+
+#include "cereal/archives/binary.hpp"
+
+#include "raymath.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace sage::bench
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // The parser ConstructMap used before MapDescriptor, kept only as a baseline.
+        namespace legacy
+        {
+            std::string readLine(std::ifstream& infile, const std::string& key)
+            {
+                std::string line;
+                std::getline(infile, line);
+                if (line.substr(0, key.length()) != key)
+                {
+                    throw std::runtime_error("Expected key '" + key + "' not found");
+                }
+                std::erase(line, '\r');
+                return line.substr(key.length() + 2);
+            }
+
+            MapDescriptor parse(const fs::path& path)
+            {
+                MapDescriptor out;
+                std::ifstream infile(path);
+                const auto typeName = readLine(infile, "type");
+                if (typeName.find("spawner") != std::string::npos)
+                {
+                    out.type = MapDescriptor::Type::Spawner;
+                    out.name = readLine(infile, "name");
+                    std::istringstream locStream(readLine(infile, "location"));
+                    locStream >> out.location.x >> out.location.y >> out.location.z;
+                    std::istringstream rotStream(readLine(infile, "rotation"));
+                    rotStream >> out.rotation.x >> out.rotation.y >> out.rotation.z;
+                    const auto spawnerType = readLine(infile, "spawner_type");
+                    out.spawnerName = readLine(infile, "spawner_name");
+                    std::unordered_map<std::string, SpawnerType> spawnerMap{
+                        {"ENEMY", SpawnerType::ENEMY},
+                        {"PLAYER", SpawnerType::PLAYER},
+                        {"NPC", SpawnerType::NPC},
+                        {"DIALOG_CUTSCENE", SpawnerType::DIALOG_CUTSCENE}};
+                    out.spawnerType = spawnerMap.at(spawnerType);
+                }
+                else if (typeName.find("light") != std::string::npos)
+                {
+                    out.type = MapDescriptor::Type::Light;
+                    out.lightType = readLine(infile, "light_type");
+                    out.name = readLine(infile, "name");
+                    std::istringstream locStream(readLine(infile, "location"));
+                    locStream >> out.location.x >> out.location.y >> out.location.z;
+                    std::istringstream rgbStream(readLine(infile, "color"));
+                    rgbStream >> out.color[0] >> out.color[1] >> out.color[2];
+                    std::istringstream strStream(readLine(infile, "strength"));
+                    strStream >> out.strength;
+                }
+                else
+                {
+                    out.type = typeName.find("item") != std::string::npos ? MapDescriptor::Type::Item
+                                                                          : MapDescriptor::Type::Mesh;
+                    out.name = readLine(infile, "name");
+                    out.mesh = readLine(infile, "mesh");
+                    std::istringstream locStream(readLine(infile, "location"));
+                    locStream >> out.location.x >> out.location.y >> out.location.z;
+                    std::istringstream rotStream(readLine(infile, "rotation"));
+                    rotStream >> out.rotation.x >> out.rotation.y >> out.rotation.z;
+                    std::istringstream scaleStream(readLine(infile, "scale"));
+                    scaleStream >> out.scale.x >> out.scale.y >> out.scale.z;
+                }
+                return out;
+            }
+
+            // How map entities were instantiated before they were created in batches: one create and a handful
+            // of emplaces per entity, ids remapped through a hash map.
+            std::size_t instantiateChunk(entt::registry& registry, const std::string_view chunkData)
+            {
+                lq::MemoryIStream stream(chunkData);
+                cereal::BinaryInputArchive input(stream);
+                std::uint32_t count = 0;
+                input(count);
+                std::unordered_map<std::uint32_t, entt::entity> idMap;
+                std::vector<entt::entity> created;
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    serializer::entity entityId{};
+                    const auto entity = registry.create();
+                    auto& transform = registry.emplace<sgTransform>(entity);
+                    auto& collideable = registry.emplace<Collideable>(entity);
+                    bool rendered = true;
+                    std::uint32_t parentId = 0; // Resolved through the transform's own serialized parent below
+                    input(entityId, transform, parentId, collideable, rendered);
+                    if (rendered)
+                    {
+                        input(registry.emplace<Renderable>(entity));
+                    }
+                    else
+                    {
+                        input(registry.emplace<lq::StaticBatchMember>(entity));
+                    }
+                    auto& tags = registry.emplace<lq::MapObjectTags>(entity);
+                    input(tags);
+                    collideable.isStatic = true;
+                    idMap[entityId.id] = entity;
+                    created.push_back(entity);
+
+                    if (tags.HasAnyTag(lq::MapObjectTag::DOOR)) registry.emplace<DoorBehaviorComponent>(entity);
+                    if (tags.HasAnyTag(lq::MapObjectTag::INTERACTABLE))
+                        registry.emplace<lq::DialogComponent>(entity);
+                    if (tags.HasAnyTag(lq::MapObjectTag::CHEST)) registry.emplace<lq::InventoryComponent>(entity);
+                }
+                for (const auto entity : created)
+                {
+                    registry.get<sgTransform>(entity).ResolveSerializedParent(idMap);
+                }
+                return created.size();
+            }
+        } // namespace legacy
+
+        template <typename Fn>
+        double timeIterations(const unsigned int iterations, Fn&& fn)
+        {
+            const auto start = Clock::now();
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                fn();
+            }
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+        }
+
+        void report(const char* label, const double ms, const std::size_t count, const char* unit = "files")
+        {
+            std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << ms << " ms" << std::setw(12)
+                      << static_cast<std::size_t>(count / (ms / 1000.0)) << " " << unit << "/s \n";
+        }
+
+        template <typename T>
+        bool sameArray(const T* a, const T* b, const std::size_t count)
+        {
+            if ((a == nullptr) != (b == nullptr)) return false;
+            return a == nullptr || count == 0 || std::memcmp(a, b, count * sizeof(T)) == 0;
+        }
+
+        bool sameTexture(const Texture2D& a, const Texture2D& b)
+        {
+            return a.width == b.width && a.height == b.height && a.mipmaps == b.mipmaps && a.format == b.format;
+        }
+
+        // First difference between two models' CPU data and materials, empty if there's none. GPU handles
+        // (vao/vbo and texture ids) differ between any two loads and aren't compared.
+        std::string modelDifference(const Model& expected, const Model& actual)
+        {
+            if (expected.meshCount != actual.meshCount) return "mesh count";
+            if (expected.materialCount != actual.materialCount) return "material count";
+            if (expected.boneCount != actual.boneCount) return "bone count";
+            if (std::memcmp(&expected.transform, &actual.transform, sizeof(Matrix)) != 0) return "transform";
+            if (!sameArray(expected.meshMaterial, actual.meshMaterial, expected.meshCount)) return "mesh material";
+            if (!sameArray(expected.bones, actual.bones, expected.boneCount)) return "bones";
+            if (!sameArray(expected.bindPose, actual.bindPose, expected.boneCount)) return "bind pose";
+            for (int m = 0; m < expected.meshCount; ++m)
+            {
+                const auto& a = expected.meshes[m];
+                const auto& b = actual.meshes[m];
+                const auto prefix = "mesh " + std::to_string(m) + " ";
+                if (a.vertexCount != b.vertexCount || a.triangleCount != b.triangleCount) return prefix + "counts";
+                const auto vertices = static_cast<std::size_t>(a.vertexCount);
+                const auto triangles = static_cast<std::size_t>(a.triangleCount);
+                if (!sameArray(a.vertices, b.vertices, vertices * 3)) return prefix + "positions";
+                if (!sameArray(a.normals, b.normals, vertices * 3)) return prefix + "normals";
+                if (!sameArray(a.tangents, b.tangents, vertices * 4)) return prefix + "tangents";
+                if (!sameArray(a.texcoords, b.texcoords, vertices * 2)) return prefix + "texcoords";
+                if (!sameArray(a.texcoords2, b.texcoords2, vertices * 2)) return prefix + "texcoords2";
+                if (!sameArray(a.colors, b.colors, vertices * 4)) return prefix + "colors";
+                if (!sameArray(a.indices, b.indices, triangles * 3)) return prefix + "indices";
+                if (!sameArray(a.boneIds, b.boneIds, vertices * 4)) return prefix + "bone ids";
+                if (!sameArray(a.boneWeights, b.boneWeights, vertices * 4)) return prefix + "bone weights";
+                if (!sameArray(a.animVertices, b.animVertices, vertices * 3)) return prefix + "anim positions";
+                if (!sameArray(a.animNormals, b.animNormals, vertices * 3)) return prefix + "anim normals";
+            }
+            for (int i = 0; i < expected.materialCount; ++i)
+            {
+                const auto& a = expected.materials[i];
+                const auto& b = actual.materials[i];
+                const auto prefix = "material " + std::to_string(i) + " ";
+                if ((a.maps == nullptr) != (b.maps == nullptr)) return prefix + "maps";
+                for (int map = 0; a.maps != nullptr && map < MAX_MATERIAL_MAPS; ++map)
+                {
+                    const auto& mapA = a.maps[map];
+                    const auto& mapB = b.maps[map];
+                    if (std::memcmp(&mapA.color, &mapB.color, sizeof(Color)) != 0 || mapA.value != mapB.value ||
+                        !sameTexture(mapA.texture, mapB.texture))
+                    {
+                        return prefix + "map " + std::to_string(map);
+                    }
+                }
+            }
+            return {};
+        }
+
+        std::string animationDifference(
+            const ModelAnimation* expected, const int expectedCount, const ModelAnimation* actual, const int count)
+        {
+            if (expectedCount != count) return "animation count";
+            for (int i = 0; i < count; ++i)
+            {
+                const auto& a = expected[i];
+                const auto& b = actual[i];
+                const auto prefix = "animation " + std::to_string(i) + " ";
+                if (std::strncmp(a.name, b.name, sizeof(a.name)) != 0) return prefix + "name";
+                if (a.boneCount != b.boneCount || a.frameCount != b.frameCount) return prefix + "counts";
+                if (!sameArray(a.bones, b.bones, a.boneCount)) return prefix + "bones";
+                for (int frame = 0; frame < a.frameCount; ++frame)
+                {
+                    if (!sameArray(a.framePoses[frame], b.framePoses[frame], a.boneCount))
+                        return prefix + "frame " + std::to_string(frame);
+                }
+            }
+            return {};
+        }
+
+        // UnloadModel leaves material textures alone (they may be shared), these ones aren't.
+        void unloadModelAndTextures(Model& model)
+        {
+            for (int i = 0; i < model.materialCount; ++i)
+            {
+                UnloadMaterial(model.materials[i]);
+            }
+            model.materialCount = 0;
+            UnloadModel(model);
+        }
+
+        void reportThroughput(const char* label, const double ms, const std::size_t bytes)
+        {
+            std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << ms << " ms" << std::setw(12)
+                      << std::setprecision(1) << bytes / (1024.0 * 1024.0) / (ms / 1000.0) << " MB/s \n";
+        }
+    } // namespace
+
+    void MapParser(const char* input, unsigned int iterations, const PackOptions& options)
+    {
+        std::vector<fs::path> files;
+        if (fs::is_directory(input))
+        {
+            for (const auto& entry : fs::directory_iterator(input))
+            {
+                if (entry.path().extension() == ".txt") files.push_back(entry.path());
+            }
+        }
+        if (files.empty())
+        {
+            std::cerr << "ERROR: No map descriptors (.txt) found in " << input << std::endl;
+            exit(1);
+        }
+        iterations = std::max(1u, iterations);
+
+        // Also warms the page cache, so neither parser pays for the first read from disk.
+        std::size_t mismatches = 0;
+        for (const auto& file : files)
+        {
+            if (legacy::parse(file) == ParseMapDescriptorFile(file)) continue;
+            std::cerr << "WARNING: Parsers disagree on " << file << std::endl;
+            ++mismatches;
+        }
+
+        std::vector<MapDescriptor> sink(files.size());
+        const auto legacyMs = timeIterations(iterations, [&] {
+            for (std::size_t i = 0; i < files.size(); ++i)
+                sink[i] = legacy::parse(files[i]);
+        });
+        const auto singleMs = timeIterations(iterations, [&] { sink = ParseMapDescriptorFiles(files, 1); });
+        const auto parallelMs =
+            timeIterations(iterations, [&] { sink = ParseMapDescriptorFiles(files, options.jobs); });
+
+        std::cout << "Map descriptor parser: " << files.size() << " file(s), " << iterations
+                  << " iteration(s), mean per iteration \n";
+        report("legacy (getline/istream)", legacyMs, files.size());
+        report("mapped, 1 job", singleMs, files.size());
+        const auto parallelLabel = "mapped, " + std::to_string(lq::ResolveJobCount(options.jobs)) + " jobs";
+        report(parallelLabel.c_str(), parallelMs, files.size());
+        std::cout << "  speedup: " << std::setprecision(2) << legacyMs / singleMs << "x (1 job), "
+                  << legacyMs / parallelMs << "x (" << lq::ResolveJobCount(options.jobs) << " jobs) \n";
+        if (mismatches > 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " descriptor(s) parsed differently." << std::endl;
+            exit(1);
+        }
+    }
+
+    void ModelDecoder(const char* input, unsigned int iterations, const PackOptions& options)
+    {
+        std::vector<fs::path> files;
+        if (fs::is_directory(input))
+        {
+            for (const auto& entry : fs::recursive_directory_iterator(input))
+            {
+                if (!entry.is_regular_file()) continue;
+                auto extension = entry.path().extension().string();
+                std::ranges::transform(
+                    extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+                if (extension == ".obj" || extension == ".glb" || extension == ".gltf")
+                {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        if (files.empty())
+        {
+            std::cerr << "ERROR: No models (.glb, .gltf, .obj) found in " << input << std::endl;
+            exit(1);
+        }
+        std::ranges::sort(files);
+        iterations = std::max(1u, iterations);
+
+        // Also warms the page cache, so neither loader pays for the first read from disk.
+        std::size_t mismatches = 0;
+        for (const auto& file : files)
+        {
+            const auto path = file.string();
+            auto expected = LoadModel(path.c_str());
+            auto actual = FinishDecodedModel(DecodeModelFile(file));
+            auto difference = modelDifference(expected, actual);
+            unloadModelAndTextures(expected);
+            unloadModelAndTextures(actual);
+
+            int expectedCount = 0;
+            int actualCount = 0;
+            auto* expectedAnimations = LoadModelAnimations(path.c_str(), &expectedCount);
+            auto* actualAnimations = DecodeModelAnimationsFile(file, &actualCount);
+            // LoadModelAnimations also reads animations out of unskinned glTFs and IQM/M3D files, which
+            // AssetIngest never asks the decoder for.
+            if (difference.empty() && actualAnimations != nullptr)
+            {
+                difference = animationDifference(expectedAnimations, expectedCount, actualAnimations, actualCount);
+            }
+            UnloadModelAnimations(expectedAnimations, expectedCount);
+            UnloadModelAnimations(actualAnimations, actualCount);
+
+            if (difference.empty()) continue;
+            std::cerr << "WARNING: ModelDecoder and LoadModel disagree on " << file << " (" << difference << ")"
+                      << std::endl;
+            ++mismatches;
+        }
+
+        const auto raylibMs = timeIterations(iterations, [&] {
+            for (const auto& file : files)
+            {
+                auto model = LoadModel(file.string().c_str());
+                unloadModelAndTextures(model);
+            }
+        });
+        const auto timeDecoder = [&](const unsigned int jobs) {
+            return timeIterations(iterations, [&] {
+                std::vector<DecodedModel> decoded(files.size());
+                lq::ParallelFor(
+                    files.size(), jobs, [&](const std::size_t i) { decoded[i] = DecodeModelFile(files[i]); });
+                for (auto& model : decoded)
+                {
+                    auto finished = FinishDecodedModel(std::move(model));
+                    unloadModelAndTextures(finished);
+                }
+            });
+        };
+        const auto singleMs = timeDecoder(1);
+        const auto parallelMs = timeDecoder(options.jobs);
+
+        std::cout << "Model decoder: " << files.size() << " model(s), " << iterations
+                  << " iteration(s), mean per iteration \n";
+        report("raylib LoadModel", raylibMs, files.size(), "models");
+        report("decode + finish, 1 job", singleMs, files.size(), "models");
+        const auto jobs = lq::ResolveJobCount(options.jobs);
+        const auto parallelLabel = "decode + finish, " + std::to_string(jobs) + " jobs";
+        report(parallelLabel.c_str(), parallelMs, files.size(), "models");
+        std::cout << "  speedup: " << std::setprecision(2) << raylibMs / singleMs << "x (1 job), "
+                  << raylibMs / parallelMs << "x (" << jobs << " jobs) \n";
+        if (mismatches > 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " model(s) decoded differently from raylib's LoadModel."
+                      << std::endl;
+            exit(1);
+        }
+    }
+
+    void RayQueries(entt::registry* registry, const char* mapBin, unsigned int iterations)
+    {
+        constexpr std::size_t kRays = 10000;
+        constexpr unsigned int kSeed = 1234;
+
+        registry->clear();
+        ResourceManager::GetInstance().Reset();
+        lq::maploader::LoadMap(registry, mapBin);
+        lq::maploader::LoadAllMapChunks(registry);
+        const auto* bvh = registry->ctx().find<lq::StaticCollisionBvh>();
+        if (bvh == nullptr || bvh->PrimitiveCount() == 0)
+        {
+            std::cerr << "ERROR: " << mapBin << " has no static collision BVH (rebuild it with --construct-map)"
+                      << std::endl;
+            exit(1);
+        }
+        iterations = std::max(1u, iterations);
+
+        // The colliders the BVH was built from, as the brute force pass sees them.
+        std::vector<BoundingBox> boxes;
+        BoundingBox bounds{{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::max()},
+                           {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                            std::numeric_limits<float>::lowest()}};
+        for (const auto [entity, collideable] : registry->view<Collideable>().each())
+        {
+            if (!collideable.isStatic || collideable.collisionLayer == collision_layers::Background) continue;
+            boxes.push_back(collideable.worldBoundingBox);
+            bounds.min = Vector3Min(bounds.min, collideable.worldBoundingBox.min);
+            bounds.max = Vector3Max(bounds.max, collideable.worldBoundingBox.max);
+        }
+        const float maxDistance = Vector3Distance(bounds.min, bounds.max);
+
+        std::mt19937 rng(kSeed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Ray> rays(kRays);
+        for (auto& ray : rays)
+        {
+            ray.position = {
+                bounds.min.x + unit(rng) * (bounds.max.x - bounds.min.x),
+                bounds.min.y + unit(rng) * (bounds.max.y - bounds.min.y),
+                bounds.min.z + unit(rng) * (bounds.max.z - bounds.min.z)};
+            ray.direction = Vector3Normalize({unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f});
+        }
+
+        const auto bruteForce = [&](const Ray& ray) {
+            float nearest = -1.0f;
+            for (const auto& box : boxes)
+            {
+                const auto collision = GetRayCollisionBox(ray, box);
+                if (!collision.hit || collision.distance > maxDistance) continue;
+                if (nearest < 0.0f || collision.distance < nearest) nearest = collision.distance;
+            }
+            return nearest;
+        };
+        const auto accept = [](CollisionLayer) { return true; };
+        const auto throughBvh = [&](const Ray& ray) {
+            const auto hit = bvh->FirstHit(*registry, ray, maxDistance, accept);
+            return hit ? hit->distance : -1.0f;
+        };
+
+        // Rays starting inside a collider are left out of the comparison: raylib measures those to where they
+        // leave the box, the BVH reports 0.
+        std::size_t compared = 0;
+        std::size_t mismatches = 0;
+        for (const auto& ray : rays)
+        {
+            const float expected = bruteForce(ray);
+            const float actual = throughBvh(ray);
+            if (actual == 0.0f) continue;
+            ++compared;
+            if ((expected < 0.0f) != (actual < 0.0f) ||
+                std::abs(expected - actual) > 1e-3f * std::max(1.0f, expected))
+            {
+                ++mismatches;
+            }
+        }
+
+        float sink = 0;
+        const auto bruteMs = timeIterations(iterations, [&] {
+            for (const auto& ray : rays)
+                sink += bruteForce(ray);
+        });
+        const auto bvhMs = timeIterations(iterations, [&] {
+            for (const auto& ray : rays)
+                sink += throughBvh(ray);
+        });
+
+        std::cout << "Static ray queries: " << kRays << " ray(s) against " << boxes.size() << " collider(s), "
+                  << bvh->NodeCount() << " BVH node(s), " << iterations << " iteration(s), mean per iteration \n";
+        report("brute force", bruteMs, kRays, "rays");
+        report("static collision BVH", bvhMs, kRays, "rays");
+        std::cout << "  speedup: " << std::setprecision(2) << bruteMs / bvhMs << "x (checksum " << sink << ") \n";
+        if (mismatches > 0)
+        {
+            std::cerr << "ERROR: " << mismatches << " of " << compared << " ray(s) hit differently." << std::endl;
+            exit(1);
+        }
+    }
+
+    void MapInstantiation(
+        entt::registry* registry, const char* mapBin, unsigned int iterations, const std::size_t entities)
+    {
+        // Loading the map fills the ResourceManager, which Renderable looks its model up in.
+        registry->clear();
+        ResourceManager::GetInstance().Reset();
+        lq::maploader::LoadMap(registry, mapBin);
+        lq::maploader::LoadAllMapChunkModels(registry);
+        const auto* source = registry->ctx().find<lq::maploader::MapChunkSource>();
+        if (source == nullptr || source->index.chunks.empty())
+        {
+            std::cerr << "ERROR: " << mapBin << " has no chunks (rebuild it with --construct-map --chunk-size)"
+                      << std::endl;
+            exit(1);
+        }
+        iterations = std::max(1u, iterations);
+
+        std::vector<lq::maploader::MapChunkData> chunks;
+        std::size_t perPass = 0;
+        for (const auto& chunk : source->index.chunks)
+        {
+            chunks.push_back(lq::maploader::ReadMapChunk(source->file, chunk));
+            perPass += chunk.entityCount;
+        }
+        // The map's chunks are instantiated as many times over as it takes to reach 'entities'.
+        const auto passes = std::max<std::size_t>(1, (entities + perPass - 1) / std::max<std::size_t>(1, perPass));
+
+        // Each iteration starts from an empty registry. Clearing it again isn't timed.
+        std::size_t created = 0;
+        const auto timeInstantiation = [&](auto&& instantiate) {
+            double ms = 0;
+            for (unsigned int i = 0; i < iterations; ++i)
+            {
+                entt::registry scratch;
+                created = 0;
+                const auto start = Clock::now();
+                for (std::size_t pass = 0; pass < passes; ++pass)
+                {
+                    for (const auto& chunk : chunks)
+                        created += instantiate(scratch, chunk.View());
+                }
+                ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+            return ms / iterations;
+        };
+        const auto legacyMs = timeInstantiation(legacy::instantiateChunk);
+        const auto legacyCreated = created;
+        const auto batchedMs = timeInstantiation([](entt::registry& scratch, const std::string_view data) {
+            return lq::maploader::InstantiateMapChunk(&scratch, data).size();
+        });
+
+        std::cout << "Map instantiation: " << created << " static entities (" << chunks.size() << " chunk(s) x "
+                  << passes << "), " << iterations << " iteration(s), mean per iteration \n";
+        report("per entity (legacy)", legacyMs, legacyCreated, "entities");
+        report("batched", batchedMs, created, "entities");
+        std::cout << "  speedup: " << std::setprecision(2) << legacyMs / batchedMs << "x \n";
+        if (legacyCreated != created)
+        {
+            std::cerr << "ERROR: " << legacyCreated << " entities created per entity, " << created << " batched."
+                      << std::endl;
+            exit(1);
+        }
+    }
+
+    void Compression(const char* mapBin, unsigned int iterations, const PackOptions& options)
+    {
+        std::string raw;
+        try
+        {
+            raw = lq::framed::ReadPayload(mapBin, serializer::kMapBinMagic, options.jobs);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            exit(1);
+        }
+        iterations = std::max(1u, iterations);
+        const auto jobs = lq::ResolveJobCount(options.jobs);
+        const auto* rawBytes = reinterpret_cast<const unsigned char*>(raw.data());
+
+        // The previous map bin layout: the whole payload as one stream, one thread each way.
+        int streamSize = 0;
+        auto* stream = CompressData(rawBytes, static_cast<int>(raw.size()), &streamSize);
+        int roundTripSize = 0;
+        auto* roundTrip = DecompressData(stream, streamSize, &roundTripSize);
+        const bool streamValid = roundTrip != nullptr && static_cast<std::size_t>(roundTripSize) == raw.size() &&
+                                 std::memcmp(roundTrip, raw.data(), raw.size()) == 0;
+        MemFree(roundTrip);
+        const auto frame = lq::framed::Compress(raw, options.jobs);
+        const bool frameValid = lq::framed::Decompress(frame, options.jobs) == raw;
+
+        const auto streamCompressMs = timeIterations(iterations, [&] {
+            int size = 0;
+            MemFree(CompressData(rawBytes, static_cast<int>(raw.size()), &size));
+        });
+        const auto streamDecompressMs = timeIterations(iterations, [&] {
+            int size = 0;
+            MemFree(DecompressData(stream, streamSize, &size));
+        });
+        const auto frameCompressMs = timeIterations(iterations, [&] { (void)lq::framed::Compress(raw, 1); });
+        const auto frameCompressParallelMs =
+            timeIterations(iterations, [&] { (void)lq::framed::Compress(raw, options.jobs); });
+        const auto frameDecompressMs = timeIterations(iterations, [&] { (void)lq::framed::Decompress(frame, 1); });
+        const auto frameDecompressParallelMs =
+            timeIterations(iterations, [&] { (void)lq::framed::Decompress(frame, options.jobs); });
+        MemFree(stream);
+
+        std::cout << "Map bin compression: " << raw.size() / 1024 << " KiB payload, " << streamSize / 1024
+                  << " KiB as one stream, " << frame.size() / 1024 << " KiB framed, " << iterations
+                  << " iteration(s), mean per iteration \n";
+        const auto parallel = std::to_string(jobs) + " jobs";
+        reportThroughput("stream compress", streamCompressMs, raw.size());
+        reportThroughput("framed compress, 1 job", frameCompressMs, raw.size());
+        reportThroughput(("framed compress, " + parallel).c_str(), frameCompressParallelMs, raw.size());
+        reportThroughput("stream decompress", streamDecompressMs, raw.size());
+        reportThroughput("framed decompress, 1 job", frameDecompressMs, raw.size());
+        reportThroughput(("framed decompress, " + parallel).c_str(), frameDecompressParallelMs, raw.size());
+        std::cout << "  speedup: " << std::setprecision(2) << streamCompressMs / frameCompressParallelMs
+                  << "x compress, " << streamDecompressMs / frameDecompressParallelMs << "x decompress (" << jobs
+                  << " jobs) \n";
+        if (!streamValid || !frameValid)
+        {
+            std::cerr << "ERROR: Round trip through the " << (frameValid ? "stream" : "frame")
+                      << " didn't give the payload back." << std::endl;
+            exit(1);
+        }
+    }
+} // namespace sage::bench
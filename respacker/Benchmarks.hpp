@@ -0,0 +1,28 @@
+#pragma once
+
+#include "PackOptions.hpp"
+
+#include "entt/entt.hpp"
+
+#include <cstddef>
+
+namespace sage::bench
+{
+    // Times the map descriptor parser against the previous getline/istringstream based one over every .txt in
+    // 'input' and checks both produce the same descriptors.
+    void MapParser(const char* input, unsigned int iterations, const PackOptions& options);
+    // Loads every model under 'input' through raylib's LoadModel/LoadModelAnimations and through
+    // DecodeModelFile + FinishDecodedModel (on 1 and options.jobs threads), checks both give the same meshes,
+    // materials, bones and animations, and times them.
+    void ModelDecoder(const char* input, unsigned int iterations, const PackOptions& options);
+    // Loads 'mapBin' (all chunks) and casts random rays through it, nearest hit against every static collider
+    // in turn versus through the map's StaticCollisionBvh, and checks both find the same hits.
+    void RayQueries(entt::registry* registry, const char* mapBin, unsigned int iterations);
+    // Instantiates the static entities of 'mapBin's chunks (repeated until there are at least 'entities') one
+    // at a time the way LoadMap used to, and in batches as InstantiateMapChunk does now.
+    void MapInstantiation(
+        entt::registry* registry, const char* mapBin, unsigned int iterations, std::size_t entities);
+    // Compresses and decompresses the payload of 'mapBin' as one DEFLATE stream (how map bins were stored
+    // before) and as a block frame (FramedCompression.hpp) on 1 and options.jobs threads, and reports MB/s.
+    void Compression(const char* mapBin, unsigned int iterations, const PackOptions& options);
+} // namespace sage::bench
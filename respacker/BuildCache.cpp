@@ -0,0 +1,139 @@
+#include "BuildCache.hpp"
+
+#include "cereal/archives/json.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace sage
+{
+    fs::path BuildCache::blobPath(const std::string& blob) const
+    {
+        return directory / "blobs" / blob;
+    }
+
+    std::uint64_t BuildCache::Hash(const void* data, const std::size_t size, std::uint64_t seed)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            seed ^= bytes[i];
+            seed *= 1099511628211ull;
+        }
+        return seed;
+    }
+
+    bool BuildCache::Lookup(const std::string& source, const std::uint64_t hash, std::string& blob)
+    {
+        std::string blobName;
+        {
+            std::lock_guard lock(mutex);
+            visited.insert(source);
+            const auto it = entries.find(source);
+            if (it == entries.end() || it->second.hash != hash)
+            {
+                ++misses;
+                return false;
+            }
+            blobName = it->second.blob;
+        }
+
+        std::ifstream file(blobPath(blobName), std::ios::binary);
+        if (!file)
+        {
+            std::lock_guard lock(mutex);
+            ++misses;
+            return false;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        blob = std::move(contents).str();
+
+        std::lock_guard lock(mutex);
+        ++hits;
+        return true;
+    }
+
+    void BuildCache::Store(const std::string& source, const std::uint64_t hash, const std::string& blob)
+    {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << Hash(source.data(), source.size(), hash)
+             << ".bin";
+
+        fs::create_directories(directory / "blobs");
+        std::ofstream file(blobPath(name.str()), std::ios::binary | std::ios::trunc);
+        file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        if (!file)
+        {
+            std::cout << "WARNING: BuildCache -> Could not write blob for " << source << std::endl;
+            return;
+        }
+
+        std::lock_guard lock(mutex);
+        visited.insert(source);
+        entries[source] = Entry{.source = source, .hash = hash, .blob = name.str()};
+    }
+
+    void BuildCache::Save()
+    {
+        std::lock_guard lock(mutex);
+        std::vector<Entry> kept;
+        std::unordered_set<std::string> keptBlobs;
+        for (auto& [source, entry] : entries)
+        {
+            if (!visited.contains(source)) continue;
+            keptBlobs.insert(entry.blob);
+            kept.push_back(entry);
+        }
+
+        fs::create_directories(directory);
+        {
+            std::ofstream file(directory / "manifest.json");
+            cereal::JSONOutputArchive archive(file);
+            archive(cereal::make_nvp("version", kVersion), cereal::make_nvp("entries", kept));
+        }
+
+        if (fs::is_directory(directory / "blobs"))
+        {
+            for (const auto& blob : fs::directory_iterator(directory / "blobs"))
+            {
+                if (!keptBlobs.contains(blob.path().filename().string())) fs::remove(blob.path());
+            }
+        }
+
+        std::cout << "BuildCache: " << hits << " source(s) reused, " << misses << " re-imported. \n";
+    }
+
+    BuildCache::BuildCache(fs::path _directory) : directory(std::move(_directory))
+    {
+        std::ifstream file(directory / "manifest.json");
+        if (!file) return;
+
+        try
+        {
+            cereal::JSONInputArchive archive(file);
+            std::uint32_t version = 0;
+            std::vector<Entry> loaded;
+            archive(cereal::make_nvp("version", version));
+            if (version != kVersion) return;
+            archive(cereal::make_nvp("entries", loaded));
+            for (auto& entry : loaded)
+            {
+                auto source = entry.source;
+                entries.emplace(std::move(source), std::move(entry));
+            }
+        }
+        catch (const cereal::Exception& e)
+        {
+            std::cout << "WARNING: BuildCache -> Ignoring unreadable manifest: " << e.what() << std::endl;
+            entries.clear();
+        }
+    }
+} // namespace sage
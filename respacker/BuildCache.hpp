@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cereal/cereal.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sage
+{
+    // Sidecar cache that lets respacker skip re-importing sources that haven't changed since the last run.
+    // <directory>/manifest.json maps every source path to the content hash it was imported from, and to a blob
+    // (in <directory>/blobs) holding the serialized ResourceManager entries that import produced.
+    class BuildCache
+    {
+        // Bump whenever the blob layout (or anything feeding it) changes; it invalidates every entry.
+        static constexpr std::uint32_t kVersion = 2;
+
+        struct Entry
+        {
+            std::string source;
+            std::uint64_t hash = 0;
+            std::string blob;
+
+            template <class Archive>
+            void serialize(Archive& archive)
+            {
+                archive(
+                    cereal::make_nvp("source", source),
+                    cereal::make_nvp("hash", hash),
+                    cereal::make_nvp("blob", blob));
+            }
+        };
+
+        std::filesystem::path directory;
+        std::unordered_map<std::string, Entry> entries;
+        std::unordered_set<std::string> visited; // Sources seen this run, anything else is pruned on Save.
+        mutable std::mutex mutex;
+        unsigned int hits = 0;
+        unsigned int misses = 0;
+
+        [[nodiscard]] std::filesystem::path blobPath(const std::string& blob) const;
+
+      public:
+        static constexpr std::uint64_t kHashSeed = 14695981039346656037ull;
+
+        // 64-bit FNV-1a. Chain calls by passing the previous result as the seed.
+        [[nodiscard]] static std::uint64_t Hash(
+            const void* data, std::size_t size, std::uint64_t seed = kHashSeed);
+
+        // Thread-safe. Returns true and fills 'blob' if 'source' was last imported from content hashing to 'hash'.
+        [[nodiscard]] bool Lookup(const std::string& source, std::uint64_t hash, std::string& blob);
+        void Store(const std::string& source, std::uint64_t hash, const std::string& blob);
+
+        // Writes the manifest and deletes blobs belonging to sources that weren't visited this run.
+        void Save();
+
+        explicit BuildCache(std::filesystem::path _directory);
+    };
+} // namespace sage
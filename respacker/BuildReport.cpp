@@ -0,0 +1,203 @@
+#include "BuildReport.hpp"
+
+#include "engine/ResourceManager.hpp"
+
+#include "cereal/archives/json.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace sage
+{
+    namespace
+    {
+        constexpr std::array<const char*, static_cast<std::size_t>(BuildReport::Category::Count)> kCategoryNames{
+            "textures", "icons", "fonts", "models", "animations"};
+
+        const char* nameOf(const BuildReport::Category category)
+        {
+            return kCategoryNames[static_cast<std::size_t>(category)];
+        }
+
+        std::uint64_t meshBytes(const Mesh& mesh)
+        {
+            const auto vertexCount = static_cast<std::uint64_t>(mesh.vertexCount);
+            std::uint64_t floats = 3;
+            if (mesh.normals != nullptr) floats += 3;
+            if (mesh.texcoords != nullptr) floats += 2;
+            if (mesh.texcoords2 != nullptr) floats += 2;
+            if (mesh.tangents != nullptr) floats += 4;
+            std::uint64_t bytes = vertexCount * floats * sizeof(float);
+            if (mesh.colors != nullptr) bytes += vertexCount * 4;
+            if (mesh.boneIds != nullptr) bytes += vertexCount * 4;
+            if (mesh.boneWeights != nullptr) bytes += vertexCount * 4 * sizeof(float);
+            if (mesh.indices != nullptr) bytes += static_cast<std::uint64_t>(mesh.triangleCount) * 3 * 2;
+            return bytes;
+        }
+
+        std::string sourceOf(const ModelInfo& info, const std::string& key)
+        {
+            return info.sourcePath.empty() ? key : info.sourcePath;
+        }
+    } // namespace
+
+    template <class Archive>
+    void BuildReport::Asset::save(Archive& archive) const
+    {
+        archive(
+            cereal::make_nvp("category", std::string(nameOf(category))),
+            cereal::make_nvp("source", source),
+            cereal::make_nvp("key", key),
+            cereal::make_nvp("fileSize", fileSize),
+            cereal::make_nvp("rawSize", rawSize),
+            cereal::make_nvp("storedSize", storedSize),
+            cereal::make_nvp("vertices", vertices),
+            cereal::make_nvp("triangles", triangles),
+            cereal::make_nvp("materials", materials),
+            cereal::make_nvp("importMs", importMs),
+            cereal::make_nvp("cached", cached),
+            cereal::make_nvp("dedupeHits", dedupeHits));
+    }
+
+    template <class Archive>
+    void BuildReport::Totals::save(Archive& archive) const
+    {
+        archive(
+            cereal::make_nvp("assets", assets),
+            cereal::make_nvp("fileSize", fileSize),
+            cereal::make_nvp("rawSize", rawSize),
+            cereal::make_nvp("storedSize", storedSize),
+            cereal::make_nvp("vertices", vertices),
+            cereal::make_nvp("triangles", triangles),
+            cereal::make_nvp("importMs", importMs),
+            cereal::make_nvp("dedupeHits", dedupeHits));
+    }
+
+    // An object with one member per category.
+    struct BuildReport::TotalsByCategory
+    {
+        const std::array<Totals, static_cast<std::size_t>(Category::Count)>& totals;
+
+        template <class Archive>
+        void save(Archive& archive) const
+        {
+            for (std::size_t c = 0; c < totals.size(); ++c)
+            {
+                archive(cereal::make_nvp(kCategoryNames[c], totals[c]));
+            }
+        }
+    };
+
+    BuildReport::Category BuildReport::ImageCategory(const fs::path& path)
+    {
+        for (const auto& part : path)
+        {
+            if (part == "icons") return Category::Icon;
+        }
+        return Category::Texture;
+    }
+
+    BuildReport::Asset& BuildReport::Find(const Category category, const std::string& source)
+    {
+        const auto id = std::string(nameOf(category)) + ":" + source;
+        const auto [it, added] = index.try_emplace(id, assets.size());
+        if (added)
+        {
+            auto& asset = assets.emplace_back();
+            asset.category = category;
+            asset.source = source;
+        }
+        return assets[it->second];
+    }
+
+    void BuildReport::AddResourceManagerModels(const meshopt::ModelAliases& aliases)
+    {
+        const auto& models = ResourceManager::GetInstance().modelCopies;
+        for (const auto& [key, info] : models)
+        {
+            auto& asset = Find(Category::Model, sourceOf(info, key));
+            asset.key = key;
+            asset.materials = info.materialNames.size();
+            asset.vertices = 0;
+            asset.triangles = 0;
+            asset.rawSize = 0;
+            for (int m = 0; m < info.model.meshCount; ++m)
+            {
+                asset.vertices += info.model.meshes[m].vertexCount;
+                asset.triangles += info.model.meshes[m].triangleCount;
+                asset.rawSize += meshBytes(info.model.meshes[m]);
+            }
+        }
+        for (const auto& [duplicate, kept] : aliases)
+        {
+            if (const auto it = models.find(kept); it != models.end())
+            {
+                ++Find(Category::Model, sourceOf(it->second, kept)).dedupeHits;
+            }
+        }
+    }
+
+    void BuildReport::AddPackEntries(const std::vector<lq::AssetPackEntry>& toc)
+    {
+        const auto& models = ResourceManager::GetInstance().modelCopies;
+        for (const auto& entry : toc)
+        {
+            if (entry.kind == lq::AssetPackEntry::Kind::Core) continue; // Shared, only in the output's size
+            const auto model = models.find(entry.key);
+            const auto source = model != models.end() ? sourceOf(model->second, entry.key) : entry.key;
+            const auto category =
+                entry.kind == lq::AssetPackEntry::Kind::Model ? Category::Model : Category::Animation;
+            auto& asset = Find(category, source);
+            asset.key = entry.key;
+            if (category == Category::Animation) asset.rawSize = entry.rawSize;
+            asset.storedSize = entry.size;
+        }
+    }
+
+    void BuildReport::AddOutput(const fs::path& path)
+    {
+        std::error_code error;
+        const auto size = fs::file_size(path, error);
+        if (!error) outputs.push_back({path.generic_string(), size});
+    }
+
+    void BuildReport::Write(const fs::path& output) const
+    {
+        std::array<Totals, static_cast<std::size_t>(Category::Count)> totals{};
+        for (const auto& asset : assets)
+        {
+            auto& total = totals[static_cast<std::size_t>(asset.category)];
+            ++total.assets;
+            total.fileSize += asset.fileSize;
+            total.rawSize += asset.rawSize;
+            total.storedSize += asset.storedSize;
+            total.vertices += asset.vertices;
+            total.triangles += asset.triangles;
+            total.importMs += asset.importMs;
+            total.dedupeHits += asset.dedupeHits;
+        }
+
+        auto path = output;
+        path += ".report.json";
+        {
+            std::ofstream file(path);
+            cereal::JSONOutputArchive archive(file);
+            archive(
+                cereal::make_nvp("command", command),
+                cereal::make_nvp("upToDate", upToDate),
+                cereal::make_nvp("outputs", outputs),
+                cereal::make_nvp("totals", TotalsByCategory{totals}),
+                cereal::make_nvp("assets", assets));
+        }
+        std::cout << "Build report: " << assets.size() << " asset(s) written to " << path.generic_string()
+                  << " \n";
+    }
+
+    BuildReport::BuildReport(std::string _command) : command(std::move(_command))
+    {
+    }
+} // namespace sage
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "MeshDeduplicator.hpp"
+
+#include "game/utils/AssetPack.hpp"
+
+#include "cereal/cereal.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sage
+{
+    // Machine readable summary of a respacker command: every asset it imported or wrote with its sizes, mesh
+    // counts, import time and deduplication hits, plus totals per category. Written as JSON next to the
+    // command's output ("<output>.report.json") so builds can be compared between releases.
+    class BuildReport
+    {
+      public:
+        enum class Category
+        {
+            Texture,
+            Icon,
+            Font,
+            Model,
+            Animation,
+            Count
+        };
+
+        struct Asset
+        {
+            Category category = Category::Texture;
+            std::string source; // File it was imported from, empty for generated assets (primitives)
+            std::string key;    // ResourceManager/asset pack key, where there is one
+            std::uint64_t fileSize = 0;
+            // Decoded pixels, vertex/index data or an asset pack entry before compression.
+            std::uint64_t rawSize = 0;
+            // Bytes in the output. 0 if the asset is part of a shared entry (images and fonts are in Core).
+            std::uint64_t storedSize = 0;
+            std::uint64_t vertices = 0;
+            std::uint64_t triangles = 0;
+            std::uint64_t materials = 0;
+            // Reading and decoding (on a worker) plus committing to the ResourceManager.
+            double importMs = 0;
+            bool cached = false;          // Imported from the BuildCache
+            std::uint32_t dedupeHits = 0; // Identical models replaced by this one
+
+            template <class Archive>
+            void save(Archive& archive) const;
+        };
+
+        struct Totals
+        {
+            std::uint64_t assets = 0;
+            std::uint64_t fileSize = 0;
+            std::uint64_t rawSize = 0;
+            std::uint64_t storedSize = 0;
+            std::uint64_t vertices = 0;
+            std::uint64_t triangles = 0;
+            double importMs = 0;
+            std::uint32_t dedupeHits = 0;
+
+            template <class Archive>
+            void save(Archive& archive) const;
+        };
+
+        struct Output
+        {
+            std::string path;
+            std::uint64_t size = 0;
+
+            template <class Archive>
+            void save(Archive& archive) const
+            {
+                archive(cereal::make_nvp("path", path), cereal::make_nvp("size", size));
+            }
+        };
+
+      private:
+        struct TotalsByCategory;
+
+        std::string command;
+        std::vector<Asset> assets;
+        std::unordered_map<std::string, std::size_t> index; // Category + source (or key) -> assets
+        std::vector<Output> outputs;
+
+      public:
+        // The command kept outputs of an earlier run whose inputs haven't changed, so nothing was imported.
+        bool upToDate = false;
+
+        // Images under an "icons" directory are icons, the rest textures.
+        [[nodiscard]] static Category ImageCategory(const std::filesystem::path& path);
+
+        // The asset imported from 'source' (or, for generated assets, with key 'source'), added on first use.
+        Asset& Find(Category category, const std::string& source);
+        // Counts and vertex/index bytes of every ResourceManager model. Keys in 'aliases' count as a hit for the
+        // model they were replaced by.
+        void AddResourceManagerModels(const meshopt::ModelAliases& aliases = {});
+        // Sizes of the entries AssetPackWriter::Write wrote.
+        void AddPackEntries(const std::vector<lq::AssetPackEntry>& toc);
+        // A file the command wrote, if it exists.
+        void AddOutput(const std::filesystem::path& path);
+        // Writes the report to "<output>.report.json".
+        void Write(const std::filesystem::path& output) const;
+
+        explicit BuildReport(std::string _command);
+    };
+} // namespace sage
@@ -0,0 +1,149 @@
+#include "LightBaker.hpp"
+
+#include "engine/components/Renderable.hpp"
+#include "engine/Light.hpp"
+#include "engine/ResourceManager.hpp"
+
+#include "game/utils/MapObjectTags.hpp"
+#include "game/utils/ParallelFor.hpp"
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace sage
+{
+    namespace
+    {
+        // The lit path adds texel * ambient / 10 and gamma corrects the result. The unlit path baked geometry is
+        // drawn with does neither, so both go into the baked colour (the gamma only exactly for white texels).
+        constexpr float kAmbient = 0.02f;
+        constexpr float kGamma = 2.2f;
+        constexpr std::size_t kVerticesPerJob = 4096;
+
+        // A light as the shader sees it.
+        struct BakeLight
+        {
+            bool directional = false;
+            Vector3 position{};
+            Vector3 direction{}; // Towards the light, directional lights only
+            Vector3 color{};     // Colour times brightness
+            float constant = 0;
+            float linear = 0;
+            float quadratic = 0;
+        };
+
+        struct VertexRange
+        {
+            Mesh* mesh;
+            std::size_t first;
+            std::size_t last;
+        };
+
+        Vector3 lightVertex(const std::vector<BakeLight>& lights, const Vector3& position, const Vector3& normal)
+        {
+            Vector3 sum{kAmbient, kAmbient, kAmbient};
+            for (const auto& light : lights)
+            {
+                Vector3 direction = light.direction;
+                float attenuation = 1.0f;
+                if (!light.directional)
+                {
+                    const auto toLight = Vector3Subtract(light.position, position);
+                    const float distance = std::max(Vector3Length(toLight), 1e-4f);
+                    direction = Vector3Scale(toLight, 1.0f / distance);
+                    // Same falloff as lighting.fs (quadratic is per 100 units squared).
+                    attenuation = light.constant + light.linear / distance +
+                                  light.quadratic * 100.0f / (distance * distance);
+                }
+                const float nDotL = std::max(Vector3DotProduct(normal, direction), 0.0f);
+                sum = Vector3Add(sum, Vector3Scale(light.color, nDotL * attenuation));
+            }
+            return sum;
+        }
+
+        void bakeRange(const std::vector<BakeLight>& lights, const VertexRange& range)
+        {
+            auto& mesh = *range.mesh;
+            for (auto v = range.first; v < range.last; ++v)
+            {
+                const Vector3 position{mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]};
+                const Vector3 normal{mesh.normals[v * 3], mesh.normals[v * 3 + 1], mesh.normals[v * 3 + 2]};
+                const auto light = lightVertex(lights, position, normal);
+                const float channels[3] = {light.x, light.y, light.z};
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float value = std::pow(std::clamp(channels[c], 0.0f, 1.0f), 1.0f / kGamma);
+                    const auto original = static_cast<float>(mesh.colors[v * 4 + c]);
+                    mesh.colors[v * 4 + c] = static_cast<unsigned char>(std::lround(original * value));
+                }
+            }
+        }
+    } // namespace
+
+    void BakeStaticLighting(
+        entt::registry* registry, const std::vector<entt::entity>& batches, const unsigned int jobs)
+    {
+        std::cout << "START: Baking static lighting. \n";
+        std::vector<BakeLight> lights;
+        for (const auto [entity, light] : registry->view<Light>().each())
+        {
+            BakeLight baked;
+            baked.directional = light.type == LIGHT_DIRECTIONAL;
+            baked.position = light.position;
+            baked.direction = Vector3Normalize(Vector3Subtract(light.position, light.target));
+            baked.color = Vector3Scale(
+                {light.color.r / 255.0f, light.color.g / 255.0f, light.color.b / 255.0f}, light.brightness);
+            baked.constant = light.constant;
+            baked.linear = light.linear;
+            baked.quadratic = light.quadratic;
+            lights.push_back(baked);
+        }
+
+        auto& rm = ResourceManager::GetInstance();
+        std::vector<VertexRange> ranges;
+        std::size_t vertexCount = 0;
+        std::size_t baked = 0;
+        for (const auto entity : batches)
+        {
+            const auto& key = registry->get<Renderable>(entity).GetModel()->GetKey();
+            auto& model = rm.modelCopies.at(key).model;
+            bool hasNormals = true;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                hasNormals &= model.meshes[m].normals != nullptr;
+            }
+            // Without normals the lit path has nothing sensible to light either.
+            if (!hasNormals) continue;
+
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                auto& mesh = model.meshes[m];
+                const auto count = static_cast<std::size_t>(mesh.vertexCount);
+                if (mesh.colors == nullptr)
+                {
+                    mesh.colors = static_cast<unsigned char*>(RL_MALLOC(count * 4));
+                    std::memset(mesh.colors, 255, count * 4);
+                }
+                for (std::size_t first = 0; first < count; first += kVerticesPerJob)
+                {
+                    ranges.push_back({&mesh, first, std::min(count, first + kVerticesPerJob)});
+                }
+                vertexCount += count;
+            }
+            registry->get<lq::MapObjectTags>(entity).tags |= lq::MapObjectTag::BAKEDLIGHT;
+            ++baked;
+        }
+
+        lq::ParallelFor(ranges.size(), jobs, [&](const std::size_t i) { bakeRange(lights, ranges[i]); });
+
+        std::cout << "Static lighting: " << lights.size() << " light(s) baked into " << vertexCount
+                  << " vertices of " << baked << " of " << batches.size() << " batch model(s). \n";
+        std::cout << "FINISH: Baking static lighting. \n";
+    }
+} // namespace sage
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "entt/entt.hpp"
+
+#include <vector>
+
+namespace sage
+{
+    // Bakes the direct lighting of the map's Light entities into the vertex colours of the static batch models
+    // (see BatchStaticGeometry, their vertices are already in world space and not shared with anything else).
+    // Uses the uber shader's diffuse terms, attenuation included; specular depends on the view and is left out.
+    // The batches are tagged MapObjectTag::BAKEDLIGHT so the game draws them without the per-pixel light loop.
+    void BakeStaticLighting(entt::registry* registry, const std::vector<entt::entity>& batches, unsigned int jobs);
+} // namespace sage
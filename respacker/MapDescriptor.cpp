@@ -0,0 +1,306 @@
+#include "MapDescriptor.hpp"
+
+#include "game/utils/MappedFile.hpp"
+#include "game/utils/ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace sage
+{
+    namespace
+    {
+        enum Key : std::uint32_t
+        {
+            KeyType = 1u << 0,
+            KeyName = 1u << 1,
+            KeyMesh = 1u << 2,
+            KeyLocation = 1u << 3,
+            KeyRotation = 1u << 4,
+            KeyScale = 1u << 5,
+            KeySpawnerType = 1u << 6,
+            KeySpawnerName = 1u << 7,
+            KeyLightType = 1u << 8,
+            KeyColor = 1u << 9,
+            KeyStrength = 1u << 10
+        };
+
+        constexpr std::array<std::pair<std::string_view, Key>, 11> keyTable{{
+            {"type", KeyType},
+            {"name", KeyName},
+            {"mesh", KeyMesh},
+            {"location", KeyLocation},
+            {"rotation", KeyRotation},
+            {"scale", KeyScale},
+            {"spawner_type", KeySpawnerType},
+            {"spawner_name", KeySpawnerName},
+            {"light_type", KeyLightType},
+            {"color", KeyColor},
+            {"strength", KeyStrength},
+        }};
+
+        constexpr std::array<std::pair<std::string_view, SpawnerType>, 4> spawnerTypeTable{{
+            {"ENEMY", SpawnerType::ENEMY},
+            {"PLAYER", SpawnerType::PLAYER},
+            {"NPC", SpawnerType::NPC},
+            {"DIALOG_CUTSCENE", SpawnerType::DIALOG_CUTSCENE},
+        }};
+
+        constexpr std::uint32_t requiredKeys(const MapDescriptor::Type type)
+        {
+            switch (type)
+            {
+            case MapDescriptor::Type::Spawner:
+                return KeyType | KeyName | KeyLocation | KeyRotation | KeySpawnerType | KeySpawnerName;
+            case MapDescriptor::Type::Light:
+                return KeyType | KeyName | KeyLocation | KeyLightType | KeyColor | KeyStrength;
+            case MapDescriptor::Type::Mesh:
+            case MapDescriptor::Type::Item:
+                break;
+            }
+            return KeyType | KeyName | KeyMesh | KeyLocation | KeyRotation | KeyScale;
+        }
+
+        bool isSpace(const char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        std::string_view trim(std::string_view value)
+        {
+            while (!value.empty() && isSpace(value.front()))
+                value.remove_prefix(1);
+            while (!value.empty() && isSpace(value.back()))
+                value.remove_suffix(1);
+            return value;
+        }
+
+        // Parses the next number in 'text' and advances past it. Returns false if there isn't one.
+        bool nextFloat(std::string_view& text, float& out)
+        {
+            text = trim(text);
+            if (text.empty()) return false;
+            if (text.front() == '+') text.remove_prefix(1);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (ec != std::errc{}) return false;
+            text.remove_prefix(static_cast<std::size_t>(ptr - text.data()));
+#else
+            // Floating point from_chars is missing from some standard libraries (e.g. older libc++).
+            char buffer[64];
+            const auto length = std::min(text.size(), sizeof(buffer) - 1);
+            std::memcpy(buffer, text.data(), length);
+            buffer[length] = '\0';
+            char* end = nullptr;
+            out = std::strtof(buffer, &end);
+            if (end == buffer) return false;
+            text.remove_prefix(static_cast<std::size_t>(end - buffer));
+#endif
+            return true;
+        }
+    } // namespace
+
+    bool MapDescriptor::operator==(const MapDescriptor& other) const
+    {
+        const auto sameVector = [](const Vector3& a, const Vector3& b) {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        };
+        return type == other.type && name == other.name && sameVector(location, other.location) &&
+               sameVector(rotation, other.rotation) && mesh == other.mesh && sameVector(scale, other.scale) &&
+               spawnerType == other.spawnerType && spawnerName == other.spawnerName &&
+               lightType == other.lightType && std::equal(std::begin(color), std::end(color), other.color) &&
+               strength == other.strength;
+    }
+
+    MapParseError::MapParseError(fs::path _file, const std::size_t _line, const std::string& message)
+        : std::runtime_error(
+              _file.string() + (_line > 0 ? ":" + std::to_string(_line) : std::string{}) + ": " + message),
+          file(std::move(_file)),
+          line(_line)
+    {
+    }
+
+    MapDescriptor ParseMapDescriptor(const std::string_view text, const fs::path& file)
+    {
+        MapDescriptor out;
+        std::uint32_t seen = 0;
+        std::size_t lineNumber = 0;
+
+        auto floats = [&](const std::string_view value, float* dest, const std::size_t count) {
+            auto rest = value;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (nextFloat(rest, dest[i])) continue;
+                throw MapParseError(
+                    file,
+                    lineNumber,
+                    "expected " + std::to_string(count) + " number(s), got '" + std::string(value) + "'");
+            }
+            if (!trim(rest).empty())
+            {
+                throw MapParseError(file, lineNumber, "unexpected trailing text '" + std::string(rest) + "'");
+            }
+        };
+        auto vector3 = [&](const std::string_view value, Vector3& dest) {
+            float xyz[3];
+            floats(value, xyz, 3);
+            dest = {xyz[0], xyz[1], xyz[2]};
+        };
+
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            auto end = text.find('\n', pos);
+            if (end == std::string_view::npos) end = text.size();
+            const auto line = trim(text.substr(pos, end - pos));
+            pos = end + 1;
+            ++lineNumber;
+            if (line.empty()) continue;
+
+            const auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+            {
+                throw MapParseError(file, lineNumber, "expected 'key: value', got '" + std::string(line) + "'");
+            }
+            const auto keyName = trim(line.substr(0, colon));
+            const auto value = trim(line.substr(colon + 1));
+
+            const auto keyIt = std::ranges::find(keyTable, keyName, &std::pair<std::string_view, Key>::first);
+            if (keyIt == keyTable.end()) continue; // Unknown keys are ignored, so the exporter can add fields.
+            const Key key = keyIt->second;
+            if (seen & key)
+            {
+                throw MapParseError(file, lineNumber, "duplicate key '" + std::string(keyName) + "'");
+            }
+            seen |= key;
+
+            switch (key)
+            {
+            case KeyType:
+                // Substring matches, the exporter writes e.g. "spawner" or "light_point".
+                if (value.find("spawner") != std::string_view::npos)
+                    out.type = MapDescriptor::Type::Spawner;
+                else if (value.find("light") != std::string_view::npos)
+                    out.type = MapDescriptor::Type::Light;
+                else if (value.find("item") != std::string_view::npos)
+                    out.type = MapDescriptor::Type::Item;
+                else
+                    out.type = MapDescriptor::Type::Mesh;
+                break;
+            case KeyName:
+                out.name = value;
+                break;
+            case KeyMesh:
+                out.mesh = value;
+                break;
+            case KeyLocation:
+                vector3(value, out.location);
+                break;
+            case KeyRotation:
+                vector3(value, out.rotation);
+                break;
+            case KeyScale:
+                vector3(value, out.scale);
+                break;
+            case KeySpawnerType: {
+                const auto it =
+                    std::ranges::find(spawnerTypeTable, value, &std::pair<std::string_view, SpawnerType>::first);
+                if (it == spawnerTypeTable.end())
+                {
+                    throw MapParseError(file, lineNumber, "unknown spawner_type '" + std::string(value) + "'");
+                }
+                out.spawnerType = it->second;
+                break;
+            }
+            case KeySpawnerName:
+                out.spawnerName = value;
+                break;
+            case KeyLightType:
+                out.lightType = value;
+                break;
+            case KeyColor: {
+                float rgb[3];
+                floats(value, rgb, 3);
+                for (int i = 0; i < 3; ++i)
+                    out.color[i] = static_cast<int>(rgb[i]);
+                break;
+            }
+            case KeyStrength: {
+                float strength;
+                floats(value, &strength, 1);
+                out.strength = static_cast<int>(strength);
+                break;
+            }
+            }
+        }
+
+        if (!(seen & KeyType)) throw MapParseError(file, 0, "missing key 'type'");
+        const auto missing = requiredKeys(out.type) & ~seen;
+        if (missing != 0)
+        {
+            std::string names;
+            for (const auto& [keyName, key] : keyTable)
+            {
+                if (!(missing & key)) continue;
+                if (!names.empty()) names += ", ";
+                names += keyName;
+            }
+            throw MapParseError(file, 0, "missing key(s) " + names);
+        }
+        return out;
+    }
+
+    MapDescriptor ParseMapDescriptorFile(const fs::path& file)
+    {
+        try
+        {
+            const lq::MappedFile mapped(file);
+            return ParseMapDescriptor(mapped.View(), file);
+        }
+        catch (const std::system_error& e)
+        {
+            throw MapParseError(file, 0, e.what());
+        }
+    }
+
+    std::vector<MapDescriptor> ParseMapDescriptorFiles(const std::vector<fs::path>& files, const unsigned int jobs)
+    {
+        std::vector<MapDescriptor> out(files.size());
+        std::vector<std::optional<MapParseError>> errors(files.size());
+        lq::ParallelFor(files.size(), jobs, [&](const std::size_t i) {
+            try
+            {
+                out[i] = ParseMapDescriptorFile(files[i]);
+            }
+            catch (const MapParseError& e)
+            {
+                errors[i] = e;
+            }
+        });
+
+        std::size_t errorCount = 0;
+        for (const auto& error : errors)
+        {
+            if (!error) continue;
+            std::cerr << "ERROR: MapLoader -> " << error->what() << std::endl;
+            ++errorCount;
+        }
+        if (errorCount > 0)
+        {
+            std::cerr << "ERROR: MapLoader -> " << errorCount << " map descriptor(s) could not be parsed."
+                      << std::endl;
+            exit(1);
+        }
+        return out;
+    }
+} // namespace sage
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "engine/components/Spawner.hpp"
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sage
+{
+    // One Blender-exported object descriptor (a "key: value" per line .txt file in a map directory).
+    struct MapDescriptor
+    {
+        enum class Type
+        {
+            Mesh,
+            Item,
+            Spawner,
+            Light
+        };
+
+        Type type = Type::Mesh;
+        std::string name;
+        Vector3 location{};
+        Vector3 rotation{}; // Radians, XYZ euler
+
+        // Mesh/Item
+        std::string mesh; // As exported, may still contain a path
+        Vector3 scale{1.0f, 1.0f, 1.0f};
+
+        // Spawner
+        SpawnerType spawnerType{};
+        std::string spawnerName;
+
+        // Light
+        std::string lightType;
+        int color[3]{};
+        int strength = 0;
+
+        [[nodiscard]] bool operator==(const MapDescriptor& other) const;
+    };
+
+    class MapParseError : public std::runtime_error
+    {
+      public:
+        std::filesystem::path file;
+        std::size_t line; // 1-based, 0 if the error isn't tied to a line (e.g. a missing key)
+
+        MapParseError(std::filesystem::path _file, std::size_t _line, const std::string& message);
+    };
+
+    // Single pass over 'text' with no per-field allocations besides the strings kept in the result.
+    // Keys may come in any order. Throws MapParseError on unknown types/keys, malformed numbers or missing keys.
+    [[nodiscard]] MapDescriptor ParseMapDescriptor(std::string_view text, const std::filesystem::path& file);
+    [[nodiscard]] MapDescriptor ParseMapDescriptorFile(const std::filesystem::path& file);
+
+    // Memory maps and parses every file on 'jobs' threads. Results are in the same order as 'files'.
+    // Every failure is reported (not just the first) before exiting.
+    [[nodiscard]] std::vector<MapDescriptor> ParseMapDescriptorFiles(
+        const std::vector<std::filesystem::path>& files, unsigned int jobs);
+} // namespace sage
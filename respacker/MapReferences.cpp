@@ -0,0 +1,89 @@
+#include "MapReferences.hpp"
+
+#include "game/utils/MappedFile.hpp"
+
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace sage
+{
+    namespace
+    {
+        // Shorter values ("id", numbers, ...) would match half the map.
+        constexpr std::size_t kMinNameLength = 3;
+
+        std::string_view trim(std::string_view value)
+        {
+            const auto first = value.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos) return {};
+            const auto last = value.find_last_not_of(" \t\r");
+            return value.substr(first, last - first + 1);
+        }
+    } // namespace
+
+    bool MapReferences::IsReferenced(const std::string_view objectName) const
+    {
+        return std::ranges::any_of(names, [objectName](const std::string& name) {
+            return objectName.find(name) != std::string_view::npos;
+        });
+    }
+
+    std::size_t MapReferences::Count() const
+    {
+        return names.size();
+    }
+
+    MapReferences::MapReferences(const std::vector<fs::path>& directories)
+    {
+        auto add = [this](std::string_view value) {
+            value = trim(value);
+            if (value.size() < kMinNameLength || value.find_first_of("$\"") != std::string_view::npos) return;
+            names.emplace_back(value);
+        };
+
+        for (const auto& directory : directories)
+        {
+            if (!fs::is_directory(directory)) continue;
+            for (const auto& entry : fs::recursive_directory_iterator(directory))
+            {
+                if (!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
+                const lq::MappedFile file(entry.path());
+                const auto text = file.View();
+
+                std::size_t pos = 0;
+                while (pos < text.size())
+                {
+                    auto end = text.find('\n', pos);
+                    if (end == std::string_view::npos) end = text.size();
+                    auto line = text.substr(pos, end - pos);
+                    pos = end + 1;
+
+                    if (const auto comment = line.find("//"); comment != std::string_view::npos)
+                    {
+                        line = line.substr(0, comment);
+                    }
+
+                    // "key: value", where the value may be followed by "; Command(...)".
+                    if (const auto colon = line.find(": "); colon != std::string_view::npos)
+                    {
+                        add(line.substr(colon + 2, line.find(';', colon) - colon - 2));
+                    }
+
+                    // Function arguments, e.g. OpenDoor(QUEST_DOOR) or quest_in_progress(ArissaQuest).
+                    for (auto open = line.find('('); open != std::string_view::npos;
+                         open = line.find('(', open + 1))
+                    {
+                        const auto close = line.find(')', open);
+                        if (close == std::string_view::npos) break;
+                        add(line.substr(open + 1, close - open - 1));
+                    }
+                }
+            }
+        }
+
+        std::ranges::sort(names);
+        const auto [first, last] = std::ranges::unique(names);
+        names.erase(first, last);
+    }
+} // namespace sage
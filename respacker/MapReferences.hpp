@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sage
+{
+    // Object names the game looks up at runtime (FindRenderable) from dialog, contextual dialog and quest files:
+    // "owner:"/"speaker:"/"dialog:"/... values and function arguments such as OpenDoor(QUEST_DOOR).
+    // Objects matching one must stay individually addressable: resident, unbatched, etc.
+    class MapReferences
+    {
+        std::vector<std::string> names;
+
+      public:
+        // True if 'objectName' contains any referenced name (FindRenderable matches on substrings).
+        [[nodiscard]] bool IsReferenced(std::string_view objectName) const;
+        [[nodiscard]] std::size_t Count() const;
+
+        // Scans every .txt under the given directories (recursively). Missing directories are skipped.
+        explicit MapReferences(const std::vector<std::filesystem::path>& directories);
+    };
+} // namespace sage
@@ -0,0 +1,243 @@
+#include "MeshDeduplicator.hpp"
+
+#include "engine/ResourceManager.hpp"
+
+#include "game/utils/ModelRelease.hpp"
+#include "game/utils/ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sage::meshopt
+{
+    namespace
+    {
+        constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+        constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+        using Words = std::vector<std::uint32_t>;
+
+        void appendFloats(Words& out, const float* values, const int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                // -0 and +0 are the same coordinate.
+                const float value = values[i] == 0.0f ? 0.0f : values[i];
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                out.push_back(bits);
+            }
+        }
+
+        void appendString(Words& out, const std::string& value)
+        {
+            out.push_back(static_cast<std::uint32_t>(value.size()));
+            for (const unsigned char c : value)
+            {
+                out.push_back(c);
+            }
+        }
+
+        // A mesh's material and triangles, each triangle written out as its three full vertex records. Triangles
+        // are rotated to start at their smallest corner (keeping the winding) and then sorted, so only the
+        // surface itself is left.
+        void appendMesh(Words& out, const Mesh& mesh, const std::string& material)
+        {
+            appendString(out, material);
+            const auto layout = static_cast<std::uint32_t>(
+                (mesh.normals != nullptr) | (mesh.texcoords != nullptr) << 1 | (mesh.texcoords2 != nullptr) << 2 |
+                (mesh.tangents != nullptr) << 3 | (mesh.colors != nullptr) << 4);
+            out.push_back(layout);
+
+            Words vertices;
+            for (int v = 0; v < mesh.vertexCount; ++v)
+            {
+                appendFloats(vertices, &mesh.vertices[v * 3], 3);
+                if (mesh.normals != nullptr) appendFloats(vertices, &mesh.normals[v * 3], 3);
+                if (mesh.texcoords != nullptr) appendFloats(vertices, &mesh.texcoords[v * 2], 2);
+                if (mesh.texcoords2 != nullptr) appendFloats(vertices, &mesh.texcoords2[v * 2], 2);
+                if (mesh.tangents != nullptr) appendFloats(vertices, &mesh.tangents[v * 4], 4);
+                if (mesh.colors != nullptr)
+                {
+                    std::uint32_t color;
+                    std::memcpy(&color, &mesh.colors[v * 4], sizeof(color));
+                    vertices.push_back(color);
+                }
+            }
+            const std::size_t stride = mesh.vertexCount > 0 ? vertices.size() / mesh.vertexCount : 0;
+
+            const auto less = [stride](const std::uint32_t* a, const std::uint32_t* b) {
+                return std::lexicographical_compare(a, a + stride, b, b + stride);
+            };
+            using Triangle = std::array<const std::uint32_t*, 3>;
+            std::vector<Triangle> triangles(mesh.triangleCount);
+            for (int t = 0; t < mesh.triangleCount; ++t)
+            {
+                Triangle corners;
+                for (int k = 0; k < 3; ++k)
+                {
+                    const int i = t * 3 + k;
+                    corners[k] = &vertices[(mesh.indices != nullptr ? mesh.indices[i] : i) * stride];
+                }
+                const auto first = std::ranges::min_element(corners, less) - corners.begin();
+                triangles[t] = {corners[first], corners[(first + 1) % 3], corners[(first + 2) % 3]};
+            }
+            std::ranges::sort(triangles, [&less](const Triangle& a, const Triangle& b) {
+                return std::ranges::lexicographical_compare(a, b, less);
+            });
+
+            out.push_back(static_cast<std::uint32_t>(mesh.triangleCount));
+            for (const auto& triangle : triangles)
+            {
+                for (const auto* corner : triangle)
+                {
+                    out.insert(out.end(), corner, corner + stride);
+                }
+            }
+        }
+
+        Words canonicalModel(const ModelInfo& info)
+        {
+            const auto& model = info.model;
+            Words out;
+            appendFloats(out, &model.transform.m0, 16);
+            out.push_back(static_cast<std::uint32_t>(model.meshCount));
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                const auto material = static_cast<std::size_t>(model.meshMaterial[m]);
+                appendMesh(
+                    out,
+                    model.meshes[m],
+                    material < info.materialNames.size() ? info.materialNames[material] : std::string{});
+            }
+            return out;
+        }
+
+        std::uint64_t hashWords(const Words& words)
+        {
+            std::uint64_t hash = kFnvOffset;
+            for (const auto word : words)
+            {
+                hash = (hash ^ word) * kFnvPrime;
+            }
+            return hash;
+        }
+
+        bool canDeduplicate(const ModelInfo& info)
+        {
+            const auto& model = info.model;
+            if (info.privateMaterials || model.boneCount > 0 || model.meshCount == 0) return false;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                if (model.meshes[m].vertices == nullptr) return false;
+            }
+            return true;
+        }
+
+        std::size_t meshBytes(const Mesh& mesh)
+        {
+            const auto vertexCount = static_cast<std::size_t>(mesh.vertexCount);
+            std::size_t floats = 3;
+            if (mesh.normals != nullptr) floats += 3;
+            if (mesh.texcoords != nullptr) floats += 2;
+            if (mesh.texcoords2 != nullptr) floats += 2;
+            if (mesh.tangents != nullptr) floats += 4;
+            std::size_t bytes = vertexCount * floats * sizeof(float);
+            if (mesh.colors != nullptr) bytes += vertexCount * 4;
+            if (mesh.indices != nullptr) bytes += static_cast<std::size_t>(mesh.triangleCount) * 3 * sizeof(short);
+            return bytes;
+        }
+    } // namespace
+
+    ModelAliases DeduplicateResourceManagerModels(
+        const std::unordered_set<std::string>& keep, const unsigned int jobs)
+    {
+        std::cout << "START: Deduplicating meshes \n";
+        auto& rm = ResourceManager::GetInstance();
+        std::vector<const std::string*> keys;
+        for (const auto& [key, info] : rm.modelCopies)
+        {
+            if (canDeduplicate(info)) keys.push_back(&key);
+        }
+        std::ranges::sort(keys, [](const auto* a, const auto* b) { return *a < *b; });
+
+        std::vector<std::uint64_t> hashes(keys.size());
+        lq::ParallelFor(keys.size(), jobs, [&](const std::size_t i) {
+            hashes[i] = hashWords(canonicalModel(rm.modelCopies.at(*keys[i])));
+        });
+
+        // Candidates per hash, in key order.
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> candidates;
+        std::vector<std::uint64_t> order;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            auto& group = candidates[hashes[i]];
+            if (group.size() == 1) order.push_back(hashes[i]);
+            group.push_back(i);
+        }
+
+        ModelAliases aliases;
+        std::size_t savedBytes = 0;
+        std::size_t groups = 0;
+        for (const auto hash : order)
+        {
+            auto remaining = std::move(candidates.at(hash));
+            while (remaining.size() > 1)
+            {
+                // Confirm the hash match. Anything that only collided is compared again among itself.
+                const auto& kept = *keys[remaining.front()];
+                const auto reference = canonicalModel(rm.modelCopies.at(kept));
+                std::vector<std::size_t> different;
+                int duplicates = 0;
+                for (std::size_t i = 1; i < remaining.size(); ++i)
+                {
+                    const auto& key = *keys[remaining[i]];
+                    const auto& info = rm.modelCopies.at(key);
+                    if (canonicalModel(info) != reference)
+                    {
+                        different.push_back(remaining[i]);
+                        continue;
+                    }
+                    ++duplicates;
+                    if (keep.contains(key)) continue;
+                    for (int m = 0; m < info.model.meshCount; ++m)
+                    {
+                        savedBytes += meshBytes(info.model.meshes[m]);
+                    }
+                    aliases.emplace(key, kept);
+                }
+                if (duplicates > 0)
+                {
+                    ++groups;
+                    std::cout << "  " << kept << ": " << duplicates << " duplicate(s) \n";
+                }
+                remaining = std::move(different);
+            }
+        }
+
+        for (const auto& [key, kept] : aliases)
+        {
+            auto it = rm.modelCopies.find(key);
+            lq::ReleaseModel(it->second.model);
+            rm.modelCopies.erase(it);
+        }
+
+        char line[160];
+        std::snprintf(
+            line,
+            sizeof(line),
+            "Meshes: %zu model(s) replaced by %zu shared one(s), %.1f KB of vertex/index data saved \n",
+            aliases.size(),
+            groups,
+            static_cast<double>(savedBytes) / 1024.0);
+        std::cout << line;
+        std::cout << "FINISH: Deduplicating meshes \n";
+        return aliases;
+    }
+} // namespace sage::meshopt
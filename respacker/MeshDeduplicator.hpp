@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sage::meshopt
+{
+    // Key of a removed duplicate model -> key of the identical model that was kept in its place.
+    using ModelAliases = std::unordered_map<std::string, std::string>;
+
+    // Finds ResourceManager models with identical geometry and materials and keeps one of each. Models are
+    // compared by a hash of their canonicalised meshes: vertex attributes by value and triangles in a fixed
+    // order, so vertex order, triangle order and indexed vs. unindexed data don't matter (the same triangles
+    // facing the same way do). Hash matches are confirmed byte for byte.
+    // The smallest key of a group is the one kept. Duplicates in 'keep' aren't removed or aliased (e.g. items,
+    // which are looked up by their own key). Skinned models and models with private materials are left alone.
+    // Prints the groups found and the vertex/index memory saved.
+    [[nodiscard]] ModelAliases DeduplicateResourceManagerModels(
+        const std::unordered_set<std::string>& keep, unsigned int jobs);
+} // namespace sage::meshopt
@@ -0,0 +1,438 @@
+#include "MeshOptimizer.hpp"
+
+#include "engine/ResourceManager.hpp"
+
+#include "game/utils/ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sage::meshopt
+{
+    namespace
+    {
+        constexpr std::uint32_t kUnused = std::numeric_limits<std::uint32_t>::max();
+        // Cache size the vertex cache optimisation scores against. Deliberately larger than kStatsCacheSize, as
+        // in Forsyth's paper: the ordering degrades gracefully on smaller caches.
+        constexpr int kCacheSize = 32;
+
+        struct Attribute
+        {
+            void** data;
+            std::size_t stride; // Bytes per vertex
+        };
+
+        // Every per-vertex array of a raylib Mesh. Absent ones (nullptr) are skipped by the callers.
+        std::array<Attribute, 10> attributesOf(Mesh& mesh)
+        {
+            return {{
+                {reinterpret_cast<void**>(&mesh.vertices), 3 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.texcoords), 2 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.texcoords2), 2 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.normals), 3 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.tangents), 4 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.colors), 4 * sizeof(unsigned char)},
+                {reinterpret_cast<void**>(&mesh.animVertices), 3 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.animNormals), 3 * sizeof(float)},
+                {reinterpret_cast<void**>(&mesh.boneIds), 4 * sizeof(unsigned char)},
+                {reinterpret_cast<void**>(&mesh.boneWeights), 4 * sizeof(float)},
+            }};
+        }
+
+        // Moves vertex v to remap[v] in every attribute (several vertices may map to the same slot if they are
+        // identical). Vertices mapped to kUnused are dropped.
+        void remapVertices(Mesh& mesh, const std::vector<std::uint32_t>& remap, const int newCount)
+        {
+            for (const auto& [data, stride] : attributesOf(mesh))
+            {
+                if (*data == nullptr) continue;
+                const auto* from = static_cast<const unsigned char*>(*data);
+                auto* to = static_cast<unsigned char*>(RL_MALLOC(newCount * stride));
+                for (int v = 0; v < mesh.vertexCount; ++v)
+                {
+                    if (remap[v] == kUnused) continue;
+                    std::memcpy(to + remap[v] * stride, from + v * stride, stride);
+                }
+                RL_FREE(*data);
+                *data = to;
+            }
+            mesh.vertexCount = newCount;
+        }
+
+        float vertexScore(const int cachePosition, const std::uint32_t remainingTriangles)
+        {
+            constexpr float kCacheDecayPower = 1.5f;
+            constexpr float kLastTriangleScore = 0.75f;
+            constexpr float kValenceBoostScale = 2.0f;
+            constexpr float kValenceBoostPower = 0.5f;
+
+            if (remainingTriangles == 0) return -1.0f;
+            float score = 0.0f;
+            if (cachePosition >= 0 && cachePosition < 3)
+            {
+                // The most recent triangle's vertices get a fixed score so the strip doesn't just turn back on
+                // itself.
+                score = kLastTriangleScore;
+            }
+            else if (cachePosition >= 3)
+            {
+                const float scaler = 1.0f / (kCacheSize - 3);
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, kCacheDecayPower);
+            }
+            // Favour finishing off vertices with few triangles left, so they don't linger.
+            return score +
+                   kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+        }
+    } // namespace
+
+    MeshStats Analyse(const Mesh& mesh)
+    {
+        MeshStats stats{.vertexCount = mesh.vertexCount, .triangleCount = mesh.triangleCount};
+        if (mesh.triangleCount == 0 || mesh.vertexCount == 0) return stats;
+        if (mesh.indices == nullptr)
+        {
+            // Every corner is its own vertex.
+            stats.acmr = 3.0f;
+            stats.atvr = 1.0f;
+            return stats;
+        }
+
+        // FIFO simulation: a vertex is still cached if fewer than kStatsCacheSize misses happened since its own.
+        std::vector<std::uint32_t> timestamp(mesh.vertexCount, 0);
+        std::uint32_t time = kStatsCacheSize + 1;
+        unsigned int misses = 0;
+        for (int i = 0; i < mesh.triangleCount * 3; ++i)
+        {
+            const auto v = mesh.indices[i];
+            if (time - timestamp[v] > static_cast<std::uint32_t>(kStatsCacheSize))
+            {
+                timestamp[v] = time++;
+                ++misses;
+            }
+        }
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(mesh.triangleCount);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(mesh.vertexCount);
+        return stats;
+    }
+
+    Mesh CopyMesh(const Mesh& mesh)
+    {
+        Mesh copy = mesh;
+        copy.vaoId = 0;
+        copy.vboId = nullptr;
+        for (const auto& [data, stride] : attributesOf(copy))
+        {
+            if (*data == nullptr) continue;
+            auto* to = RL_MALLOC(mesh.vertexCount * stride);
+            std::memcpy(to, *data, mesh.vertexCount * stride);
+            *data = to;
+        }
+        if (mesh.indices != nullptr)
+        {
+            const auto size = mesh.triangleCount * 3 * sizeof(unsigned short);
+            copy.indices = static_cast<unsigned short*>(RL_MALLOC(size));
+            std::memcpy(copy.indices, mesh.indices, size);
+        }
+        if (mesh.boneMatrices != nullptr)
+        {
+            const auto size = mesh.boneCount * sizeof(Matrix);
+            copy.boneMatrices = static_cast<Matrix*>(RL_MALLOC(size));
+            std::memcpy(copy.boneMatrices, mesh.boneMatrices, size);
+        }
+        return copy;
+    }
+
+    bool WeldVertices(Mesh& mesh)
+    {
+        if (mesh.vertexCount == 0 || mesh.triangleCount == 0) return true;
+        if (mesh.indices == nullptr && mesh.vertexCount != mesh.triangleCount * 3) return false;
+        const auto attributes = attributesOf(mesh);
+
+        std::size_t stride = 0;
+        for (const auto& attribute : attributes)
+        {
+            if (*attribute.data != nullptr) stride += attribute.stride;
+        }
+
+        // Interleave every attribute into one key per vertex so identical vertices compare equal as bytes.
+        std::vector<char> keys(stride * mesh.vertexCount);
+        std::size_t keyOffset = 0;
+        for (const auto& [data, attributeStride] : attributes)
+        {
+            if (*data == nullptr) continue;
+            const auto* from = static_cast<const char*>(*data);
+            for (int v = 0; v < mesh.vertexCount; ++v)
+            {
+                std::memcpy(&keys[v * stride + keyOffset], from + v * attributeStride, attributeStride);
+            }
+            keyOffset += attributeStride;
+        }
+
+        std::unordered_map<std::string_view, std::uint32_t> unique;
+        unique.reserve(mesh.vertexCount);
+        std::vector<std::uint32_t> remap(mesh.vertexCount);
+        for (int v = 0; v < mesh.vertexCount; ++v)
+        {
+            const std::string_view key(&keys[v * stride], stride);
+            remap[v] = unique.try_emplace(key, static_cast<std::uint32_t>(unique.size())).first->second;
+        }
+
+        const auto uniqueCount = static_cast<int>(unique.size());
+        if (uniqueCount > std::numeric_limits<unsigned short>::max() + 1) return false;
+        if (uniqueCount == mesh.vertexCount && mesh.indices != nullptr) return true;
+
+        const int indexCount = mesh.triangleCount * 3;
+        auto* indices = static_cast<unsigned short*>(RL_MALLOC(indexCount * sizeof(unsigned short)));
+        for (int i = 0; i < indexCount; ++i)
+        {
+            const auto original = mesh.indices != nullptr ? mesh.indices[i] : i;
+            indices[i] = static_cast<unsigned short>(remap[original]);
+        }
+        RL_FREE(mesh.indices);
+        mesh.indices = indices;
+
+        remapVertices(mesh, remap, uniqueCount);
+        return true;
+    }
+
+    void OptimizeVertexCache(Mesh& mesh)
+    {
+        if (mesh.indices == nullptr || mesh.triangleCount == 0) return;
+        const auto vertexCount = static_cast<std::size_t>(mesh.vertexCount);
+        const auto triangleCount = static_cast<std::size_t>(mesh.triangleCount);
+        const auto* indices = mesh.indices;
+
+        // Triangles using each vertex. The first 'remaining[v]' entries of a vertex's range are the ones that
+        // haven't been emitted yet.
+        std::vector<std::uint32_t> remaining(vertexCount, 0);
+        for (std::size_t i = 0; i < triangleCount * 3; ++i)
+        {
+            ++remaining[indices[i]];
+        }
+        std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + remaining[v];
+        }
+        std::vector<std::uint32_t> adjacency(triangleCount * 3);
+        {
+            auto fill = offsets;
+            for (std::size_t t = 0; t < triangleCount; ++t)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    adjacency[fill[indices[t * 3 + k]]++] = static_cast<std::uint32_t>(t);
+                }
+            }
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = vertexScore(-1, remaining[v]);
+        }
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<char> emitted(triangleCount, 0);
+        for (std::size_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                vertexScores[indices[t * 3 + 2]];
+        }
+
+        std::vector<unsigned short> out;
+        out.reserve(triangleCount * 3);
+        std::vector<std::uint32_t> cache;
+        std::vector<std::uint32_t> nextCache;
+        cache.reserve(kCacheSize + 3);
+        nextCache.reserve(kCacheSize + 3);
+
+        auto best = static_cast<std::uint32_t>(
+            std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+        std::size_t scanCursor = 0;
+        while (out.size() < triangleCount * 3)
+        {
+            if (best == kUnused)
+            {
+                // Nothing in the cache has triangles left, continue with the next unemitted one.
+                while (emitted[scanCursor])
+                {
+                    ++scanCursor;
+                }
+                best = static_cast<std::uint32_t>(scanCursor);
+            }
+
+            emitted[best] = 1;
+            const std::uint32_t corners[3]{indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+            nextCache.clear();
+            for (const auto v : corners)
+            {
+                out.push_back(static_cast<unsigned short>(v));
+                if (std::ranges::find(nextCache, v) == nextCache.end()) nextCache.push_back(v); // Degenerates
+
+                // Swap the emitted triangle out of the vertex's live range.
+                const auto begin = adjacency.begin() + offsets[v];
+                const auto end = begin + remaining[v];
+                std::iter_swap(std::find(begin, end, best), end - 1);
+                --remaining[v];
+            }
+            for (const auto v : cache)
+            {
+                if (std::find(std::begin(corners), std::end(corners), v) == std::end(corners))
+                {
+                    nextCache.push_back(v);
+                }
+            }
+
+            // Re-score every vertex whose cache position or remaining count changed and push the difference
+            // into its live triangles.
+            for (std::size_t i = 0; i < nextCache.size(); ++i)
+            {
+                const auto v = nextCache[i];
+                cachePosition[v] = i < kCacheSize ? static_cast<int>(i) : -1;
+                const float score = vertexScore(cachePosition[v], remaining[v]);
+                const float delta = score - vertexScores[v];
+                vertexScores[v] = score;
+                for (auto a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                {
+                    triangleScores[adjacency[a]] += delta;
+                }
+            }
+            if (nextCache.size() > kCacheSize) nextCache.resize(kCacheSize);
+            std::swap(cache, nextCache);
+
+            best = kUnused;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (const auto v : cache)
+            {
+                for (auto a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+                {
+                    const auto t = adjacency[a];
+                    if (triangleScores[t] > bestScore)
+                    {
+                        bestScore = triangleScores[t];
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        std::ranges::copy(out, mesh.indices);
+    }
+
+    void OptimizeVertexFetch(Mesh& mesh)
+    {
+        if (mesh.indices == nullptr || mesh.vertexCount == 0) return;
+        std::vector<std::uint32_t> remap(mesh.vertexCount, kUnused);
+        std::uint32_t next = 0;
+        for (int i = 0; i < mesh.triangleCount * 3; ++i)
+        {
+            auto& target = remap[mesh.indices[i]];
+            if (target == kUnused) target = next++;
+            mesh.indices[i] = static_cast<unsigned short>(target);
+        }
+        remapVertices(mesh, remap, static_cast<int>(next));
+    }
+
+    void OptimizeResourceManagerModels(const unsigned int jobs)
+    {
+        struct Job
+        {
+            const std::string* key;
+            int meshIndex;
+            Mesh* mesh;
+            MeshStats before;
+            MeshStats after;
+            bool welded = true;
+        };
+
+        std::cout << "START: Optimizing meshes \n";
+        auto& rm = ResourceManager::GetInstance();
+        std::vector<const std::string*> keys;
+        for (const auto& [key, info] : rm.modelCopies)
+        {
+            keys.push_back(&key);
+        }
+        std::ranges::sort(keys, [](const auto* a, const auto* b) { return *a < *b; });
+
+        // Meshes whose buffers are shared by another model are skipped: rewriting them would leave the other
+        // owner pointing at freed memory.
+        std::unordered_map<const void*, int> bufferUsers;
+        for (const auto* key : keys)
+        {
+            const auto& model = rm.modelCopies.at(*key).model;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                ++bufferUsers[model.meshes[m].vertices];
+            }
+        }
+
+        std::vector<Job> work;
+        for (const auto* key : keys)
+        {
+            auto& model = rm.modelCopies.at(*key).model;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                auto& mesh = model.meshes[m];
+                if (mesh.vertices == nullptr || bufferUsers[mesh.vertices] > 1) continue;
+                work.push_back(Job{.key = key, .meshIndex = m, .mesh = &mesh, .before = {}, .after = {}});
+            }
+        }
+
+        lq::ParallelFor(work.size(), jobs, [&work](const std::size_t i) {
+            auto& job = work[i];
+            job.before = Analyse(*job.mesh);
+            job.welded = WeldVertices(*job.mesh);
+            if (job.welded)
+            {
+                OptimizeVertexCache(*job.mesh);
+                OptimizeVertexFetch(*job.mesh);
+            }
+            job.after = Analyse(*job.mesh);
+        });
+
+        int verticesBefore = 0;
+        int verticesAfter = 0;
+        int triangles = 0;
+        float missesBefore = 0;
+        float missesAfter = 0;
+        for (const auto& job : work)
+        {
+            char line[256];
+            std::snprintf(
+                line,
+                sizeof(line),
+                "  %s[%d]: vertices %d -> %d, ACMR %.2f -> %.2f, ATVR %.2f -> %.2f%s \n",
+                job.key->c_str(),
+                job.meshIndex,
+                job.before.vertexCount,
+                job.after.vertexCount,
+                job.before.acmr,
+                job.after.acmr,
+                job.before.atvr,
+                job.after.atvr,
+                job.welded ? "" : " (too many vertices for 16 bit indices, left as is)");
+            std::cout << line;
+
+            verticesBefore += job.before.vertexCount;
+            verticesAfter += job.after.vertexCount;
+            triangles += job.before.triangleCount;
+            missesBefore += job.before.acmr * static_cast<float>(job.before.triangleCount);
+            missesAfter += job.after.acmr * static_cast<float>(job.after.triangleCount);
+        }
+        const float triangleCount = std::max(1.0f, static_cast<float>(triangles));
+        std::cout << "Meshes: " << work.size() << " optimized, vertices " << verticesBefore << " -> "
+                  << verticesAfter << ", ACMR " << missesBefore / triangleCount << " -> "
+                  << missesAfter / triangleCount << " \n";
+        std::cout << "FINISH: Optimizing meshes \n";
+    }
+} // namespace sage::meshopt
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <string>
+
+namespace sage::meshopt
+{
+    // Post-transform cache simulated for statistics (FIFO, roughly what current GPUs behave like).
+    inline constexpr int kStatsCacheSize = 16;
+
+    struct MeshStats
+    {
+        int vertexCount = 0;
+        int triangleCount = 0;
+        float acmr = 0; // Average cache miss ratio: vertex shader runs per triangle (0.5 - 3, lower is better)
+        float atvr = 0; // Average transformed vertex ratio: invocations per unique vertex (1 is ideal)
+    };
+
+    [[nodiscard]] MeshStats Analyse(const Mesh& mesh);
+
+    // Deep copy of a mesh's CPU data (buffers from RL_MALLOC). The copy isn't uploaded.
+    [[nodiscard]] Mesh CopyMesh(const Mesh& mesh);
+
+    // Merges vertices whose attributes are bitwise identical and turns non-indexed meshes into indexed ones.
+    // Returns false (and leaves the mesh untouched) if the result wouldn't fit raylib's 16 bit indices.
+    bool WeldVertices(Mesh& mesh);
+    // Reorders triangles for post-transform vertex cache hits (Forsyth, "Linear-Speed Vertex Cache
+    // Optimisation"). Indexed meshes only.
+    void OptimizeVertexCache(Mesh& mesh);
+    // Renumbers vertices in the order the index buffer first uses them, so vertex fetch walks memory
+    // linearly. Unreferenced vertices are dropped. Indexed meshes only.
+    void OptimizeVertexFetch(Mesh& mesh);
+
+    // Runs the three passes above over every mesh of every model in the ResourceManager and prints per-mesh
+    // before/after statistics. Only the CPU copies of the meshes are changed (which is what gets packed), any
+    // GPU buffers uploaded while importing are left as they were.
+    void OptimizeResourceManagerModels(unsigned int jobs);
+} // namespace sage::meshopt
@@ -0,0 +1,452 @@
+#include "MeshSimplifier.hpp"
+
+#include "MeshOptimizer.hpp"
+
+#include "engine/ResourceManager.hpp"
+
+#include "game/src/components/MeshLod.hpp"
+#include "game/utils/ModelRelease.hpp"
+#include "game/utils/ParallelFor.hpp"
+
+#include "raymath.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sage::meshopt
+{
+    namespace
+    {
+        // Models below this aren't worth the extra pack entries.
+        constexpr int kMinLodTriangles = 256;
+        // A level has to drop at least this share of the previous level's triangles to be kept.
+        constexpr float kMinLodReduction = 0.2f;
+        // Collapses may turn a triangle's normal by at most acos of this (~75 degrees).
+        constexpr float kMaxNormalTurn = 0.25f;
+        // Allowed surface deviation per level, as a share of the model's bounding box diagonal.
+        constexpr float kLodErrorScale[lq::kMaxLodLevels + 1]{0.0f, 0.01f, 0.025f, 0.05f, 0.1f};
+
+        struct Quadric
+        {
+            double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+            static Quadric FromPlane(const double a, const double b, const double c, const double d)
+            {
+                return {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+            }
+
+            Quadric& operator+=(const Quadric& o)
+            {
+                a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad, b2 += o.b2;
+                bc += o.bc, bd += o.bd, c2 += o.c2, cd += o.cd, d2 += o.d2;
+                return *this;
+            }
+
+            // Sum of squared distances from p to every plane accumulated into the quadric.
+            [[nodiscard]] double Evaluate(const Vector3& p) const
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x + b2 * y * y + 2 * bc * y * z +
+                       2 * bd * y + c2 * z * z + 2 * cd * z + d2;
+            }
+        };
+
+        struct Collapse
+        {
+            double cost;
+            std::uint32_t from;
+            std::uint32_t to;
+            std::uint32_t stamp; // 'from's version when queued, stale entries are skipped
+
+            bool operator>(const Collapse& o) const
+            {
+                return cost > o.cost;
+            }
+        };
+
+        class Simplifier
+        {
+            const Mesh& mesh;
+            std::vector<std::uint32_t> indices;
+            std::vector<Quadric> quadrics;
+            std::vector<std::vector<std::uint32_t>> vertexTriangles;
+            std::vector<char> locked;
+            std::vector<char> removed;
+            std::vector<char> deadTriangles;
+            std::vector<std::uint32_t> versions;
+            std::vector<std::uint32_t> linkScratch;
+            std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> queue;
+
+            [[nodiscard]] Vector3 position(const std::uint32_t v) const
+            {
+                return {mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]};
+            }
+
+            [[nodiscard]] Vector3 normalOf(
+                const std::uint32_t a, const std::uint32_t b, const std::uint32_t c) const
+            {
+                const auto pa = position(a);
+                return Vector3CrossProduct(Vector3Subtract(position(b), pa), Vector3Subtract(position(c), pa));
+            }
+
+            void lockBordersAndSeams()
+            {
+                // Vertices sharing a position but not their other attributes sit on a UV/normal seam.
+                std::unordered_map<std::string_view, std::uint32_t> positionGroups;
+                std::vector<std::uint32_t> group(mesh.vertexCount);
+                std::vector<std::uint32_t> groupSize;
+                for (int v = 0; v < mesh.vertexCount; ++v)
+                {
+                    const std::string_view key(
+                        reinterpret_cast<const char*>(&mesh.vertices[v * 3]), 3 * sizeof(float));
+                    const auto [it, inserted] =
+                        positionGroups.try_emplace(key, static_cast<std::uint32_t>(groupSize.size()));
+                    if (inserted) groupSize.push_back(0);
+                    group[v] = it->second;
+                    ++groupSize[it->second];
+                }
+
+                // Edges (between position groups) used by anything but exactly two triangles are open borders or
+                // non-manifold.
+                std::unordered_map<std::uint64_t, int> edgeUse;
+                const auto edgeKey = [&group](const std::uint32_t a, const std::uint32_t b) {
+                    const auto ga = group[a], gb = group[b];
+                    return ga < gb ? (std::uint64_t{ga} << 32 | gb) : (std::uint64_t{gb} << 32 | ga);
+                };
+                for (std::size_t t = 0; t < indices.size() / 3; ++t)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        ++edgeUse[edgeKey(indices[t * 3 + k], indices[t * 3 + (k + 1) % 3])];
+                    }
+                }
+
+                std::vector<char> lockedGroups(groupSize.size(), 0);
+                for (const auto& [edge, uses] : edgeUse)
+                {
+                    if (uses == 2) continue;
+                    lockedGroups[edge >> 32] = 1;
+                    lockedGroups[edge & 0xffffffffu] = 1;
+                }
+                for (int v = 0; v < mesh.vertexCount; ++v)
+                {
+                    locked[v] = groupSize[group[v]] > 1 || lockedGroups[group[v]];
+                }
+            }
+
+            void queueCollapses(const std::uint32_t from)
+            {
+                if (locked[from] || removed[from]) return;
+                for (const auto t : vertexTriangles[from])
+                {
+                    if (deadTriangles[t]) continue;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const auto to = indices[t * 3 + k];
+                        if (to == from) continue;
+                        auto combined = quadrics[from];
+                        combined += quadrics[to];
+                        queue.push({combined.Evaluate(position(to)), from, to, versions[from]});
+                    }
+                }
+            }
+
+            // Collapsing an edge whose end points share more neighbours than the edge has triangles would fold
+            // the surface onto itself (the "link condition").
+            [[nodiscard]] bool breaksTopology(const std::uint32_t from, const std::uint32_t to)
+            {
+                linkScratch.clear();
+                int sharedTriangles = 0;
+                for (const auto t : vertexTriangles[from])
+                {
+                    if (deadTriangles[t]) continue;
+                    const auto* corners = &indices[t * 3];
+                    if (std::find(corners, corners + 3, to) != corners + 3) ++sharedTriangles;
+                    linkScratch.insert(linkScratch.end(), corners, corners + 3);
+                }
+                std::ranges::sort(linkScratch);
+                linkScratch.erase(std::unique(linkScratch.begin(), linkScratch.end()), linkScratch.end());
+
+                int sharedNeighbours = 0;
+                std::vector<std::uint32_t> seen;
+                for (const auto t : vertexTriangles[to])
+                {
+                    if (deadTriangles[t]) continue;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const auto v = indices[t * 3 + k];
+                        if (v == from || v == to || std::ranges::find(seen, v) != seen.end()) continue;
+                        seen.push_back(v);
+                        if (std::ranges::binary_search(linkScratch, v)) ++sharedNeighbours;
+                    }
+                }
+                return sharedNeighbours > sharedTriangles;
+            }
+
+            // Moving 'from' onto 'to' mustn't turn any of the remaining triangles around.
+            [[nodiscard]] bool flipsTriangles(const std::uint32_t from, const std::uint32_t to) const
+            {
+                for (const auto t : vertexTriangles[from])
+                {
+                    if (deadTriangles[t]) continue;
+                    std::uint32_t corners[3]{indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+                    if (std::ranges::find(corners, to) != std::end(corners)) continue;
+                    const auto before = normalOf(corners[0], corners[1], corners[2]);
+                    std::ranges::replace(corners, from, to);
+                    const auto after = normalOf(corners[0], corners[1], corners[2]);
+                    // Also rejects sharp turns, which is where near-degenerate slivers come from.
+                    const float limit = kMaxNormalTurn * Vector3Length(before) * Vector3Length(after);
+                    if (Vector3DotProduct(before, after) <= limit) return true;
+                }
+                return false;
+            }
+
+          public:
+            explicit Simplifier(const Mesh& _mesh)
+                : mesh(_mesh),
+                  indices(_mesh.indices, _mesh.indices + _mesh.triangleCount * 3),
+                  quadrics(_mesh.vertexCount),
+                  vertexTriangles(_mesh.vertexCount),
+                  locked(_mesh.vertexCount, 0),
+                  removed(_mesh.vertexCount, 0),
+                  deadTriangles(_mesh.triangleCount, 0),
+                  versions(_mesh.vertexCount, 0)
+            {
+                for (std::uint32_t t = 0; t < static_cast<std::uint32_t>(mesh.triangleCount); ++t)
+                {
+                    const auto a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+                    const auto normal = normalOf(a, b, c);
+                    const float length = Vector3Length(normal);
+                    if (length > 0.0f)
+                    {
+                        const auto n = Vector3Scale(normal, 1.0f / length);
+                        const auto plane = Quadric::FromPlane(n.x, n.y, n.z, -Vector3DotProduct(n, position(a)));
+                        quadrics[a] += plane;
+                        quadrics[b] += plane;
+                        quadrics[c] += plane;
+                    }
+                    vertexTriangles[a].push_back(t);
+                    if (b != a) vertexTriangles[b].push_back(t);
+                    if (c != a && c != b) vertexTriangles[c].push_back(t);
+                }
+                lockBordersAndSeams();
+            }
+
+            // Returns the surviving index buffer.
+            std::vector<std::uint32_t> Run(const int targetTriangles, const float maxError)
+            {
+                const double maxCost = static_cast<double>(maxError) * maxError;
+                int liveTriangles = mesh.triangleCount;
+                for (std::uint32_t v = 0; v < static_cast<std::uint32_t>(mesh.vertexCount); ++v)
+                {
+                    queueCollapses(v);
+                }
+
+                std::vector<std::uint32_t> neighbours;
+                while (liveTriangles > targetTriangles && !queue.empty())
+                {
+                    const auto collapse = queue.top();
+                    queue.pop();
+                    const auto from = collapse.from;
+                    const auto to = collapse.to;
+                    if (removed[from] || removed[to] || collapse.stamp != versions[from]) continue;
+                    if (collapse.cost > maxCost) break; // Everything left is more expensive
+                    if (breaksTopology(from, to) || flipsTriangles(from, to)) continue;
+
+                    for (const auto t : vertexTriangles[from])
+                    {
+                        if (deadTriangles[t]) continue;
+                        auto* corners = &indices[t * 3];
+                        if (corners[0] == to || corners[1] == to || corners[2] == to)
+                        {
+                            deadTriangles[t] = 1;
+                            --liveTriangles;
+                            continue;
+                        }
+                        std::replace(corners, corners + 3, from, to);
+                        vertexTriangles[to].push_back(t);
+                    }
+                    removed[from] = 1;
+                    quadrics[to] += quadrics[from];
+                    vertexTriangles[from].clear();
+
+                    // Every collapse into or out of 'to' and its neighbours now has a different cost.
+                    neighbours.clear();
+                    std::erase_if(vertexTriangles[to], [this](const auto t) { return deadTriangles[t] != 0; });
+                    for (const auto t : vertexTriangles[to])
+                    {
+                        neighbours.insert(neighbours.end(), &indices[t * 3], &indices[t * 3] + 3);
+                    }
+                    std::ranges::sort(neighbours);
+                    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+                    for (const auto v : neighbours)
+                    {
+                        ++versions[v];
+                        queueCollapses(v);
+                    }
+                }
+
+                std::vector<std::uint32_t> out;
+                out.reserve(static_cast<std::size_t>(liveTriangles) * 3);
+                for (std::size_t t = 0; t < deadTriangles.size(); ++t)
+                {
+                    if (!deadTriangles[t]) out.insert(out.end(), &indices[t * 3], &indices[t * 3] + 3);
+                }
+                return out;
+            }
+        };
+
+        BoundingBox boundsOf(const Model& model)
+        {
+            BoundingBox box{{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                const auto& mesh = model.meshes[m];
+                for (int v = 0; v < mesh.vertexCount; ++v)
+                {
+                    const Vector3 p{mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]};
+                    box.min = Vector3Min(box.min, p);
+                    box.max = Vector3Max(box.max, p);
+                }
+            }
+            return box;
+        }
+
+        bool isLodKey(const std::string_view key)
+        {
+            const auto suffix = key.rfind("_lod");
+            if (suffix == std::string_view::npos || suffix + 4 == key.size()) return false;
+            return std::all_of(
+                key.begin() + suffix + 4, key.end(), [](const unsigned char c) { return std::isdigit(c) != 0; });
+        }
+
+        int triangleCountOf(const Model& model)
+        {
+            int count = 0;
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                count += model.meshes[m].triangleCount;
+            }
+            return count;
+        }
+
+        template <typename T>
+        T* copyArray(const T* from, const int count)
+        {
+            if (from == nullptr || count <= 0) return nullptr;
+            auto* to = static_cast<T*>(RL_MALLOC(count * sizeof(T)));
+            std::memcpy(to, from, count * sizeof(T));
+            return to;
+        }
+
+        // Same model with every mesh simplified towards 'ratio' of its triangles.
+        Model simplifyModel(const Model& base, const float ratio, const float maxError)
+        {
+            Model lod = base;
+            lod.meshes = static_cast<Mesh*>(RL_CALLOC(base.meshCount, sizeof(Mesh)));
+            for (int m = 0; m < base.meshCount; ++m)
+            {
+                const auto& mesh = base.meshes[m];
+                const auto target = static_cast<int>(std::ceil(static_cast<float>(mesh.triangleCount) * ratio));
+                lod.meshes[m] = SimplifyMesh(mesh, target, maxError);
+            }
+            // Materials are shared through the ResourceManager's material pool (models with private materials
+            // are skipped), so a shallow copy of the array is enough.
+            lod.materials = copyArray(base.materials, base.materialCount);
+            lod.meshMaterial = copyArray(base.meshMaterial, base.meshCount);
+            lod.bones = copyArray(base.bones, base.boneCount);
+            lod.bindPose = copyArray(base.bindPose, base.boneCount);
+            return lod;
+        }
+    } // namespace
+
+    Mesh SimplifyMesh(const Mesh& mesh, const int targetTriangles, const float maxError)
+    {
+        auto out = CopyMesh(mesh);
+        if (mesh.vertices == nullptr || mesh.triangleCount <= targetTriangles || !WeldVertices(out)) return out;
+
+        const auto kept = Simplifier(out).Run(targetTriangles, maxError);
+        out.triangleCount = static_cast<int>(kept.size() / 3);
+        for (std::size_t i = 0; i < kept.size(); ++i)
+        {
+            out.indices[i] = static_cast<unsigned short>(kept[i]);
+        }
+        OptimizeVertexCache(out);
+        OptimizeVertexFetch(out); // Also drops the vertices that were collapsed away
+        return out;
+    }
+
+    void GenerateResourceManagerLods(const int levels, const unsigned int jobs)
+    {
+        struct Job
+        {
+            std::string key;
+            const ModelInfo* info;
+            std::vector<Model> lods;
+            std::vector<int> triangles; // Per level, [0] is the base model
+        };
+
+        std::cout << "START: Generating model LODs \n";
+        auto& rm = ResourceManager::GetInstance();
+        std::vector<Job> work;
+        for (const auto& [key, info] : rm.modelCopies)
+        {
+            // Primitives are regenerated at runtime, private materials can't be shared with a copy.
+            if (info.sourcePath.empty() || info.privateMaterials) continue;
+            if (isLodKey(key)) continue;
+            if (triangleCountOf(info.model) < kMinLodTriangles) continue;
+            work.push_back(Job{.key = key, .info = &info, .lods = {}, .triangles = {triangleCountOf(info.model)}});
+        }
+        std::ranges::sort(work, [](const Job& a, const Job& b) { return a.key < b.key; });
+
+        lq::ParallelFor(work.size(), jobs, [&work, levels](const std::size_t i) {
+            auto& job = work[i];
+            const auto bounds = boundsOf(job.info->model);
+            const float diagonal = Vector3Distance(bounds.min, bounds.max);
+            for (int level = 1; level <= levels; ++level)
+            {
+                auto lod = simplifyModel(
+                    job.info->model, std::pow(0.5f, static_cast<float>(level)), kLodErrorScale[level] * diagonal);
+                const int triangles = triangleCountOf(lod);
+                const auto previous = static_cast<float>(job.triangles.back());
+                if (static_cast<float>(triangles) > previous * (1 - kMinLodReduction))
+                {
+                    lq::ReleaseModel(lod);
+                    break;
+                }
+                job.lods.push_back(lod);
+                job.triangles.push_back(triangles);
+            }
+        });
+
+        unsigned int stored = 0;
+        for (auto& job : work)
+        {
+            std::cout << "  " << job.key << ": triangles";
+            for (const auto triangles : job.triangles)
+            {
+                std::cout << " " << triangles;
+            }
+            std::cout << " \n";
+
+            for (std::size_t level = 0; level < job.lods.size(); ++level)
+            {
+                rm.StoreModel(
+                    ModelInfo{job.lods[level], job.info->materialNames, job.info->sourcePath, false},
+                    lq::LodModelKey(job.key, static_cast<int>(level) + 1));
+                ++stored;
+            }
+        }
+        std::cout << "LODs: " << stored << " level(s) for " << work.size() << " model(s). \n";
+        std::cout << "FINISH: Generating model LODs \n";
+    }
+} // namespace sage::meshopt
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "raylib.h"
+
+namespace sage::meshopt
+{
+    // Quadric error metric simplification (Garland & Heckbert) restricted to half-edge collapses, so every
+    // surviving vertex keeps its original attributes (UVs, normals, skinning) as they were.
+    // Collapses continue until the mesh is down to targetTriangles or the next collapse would move the surface
+    // by more than maxError (world units). Vertices on open borders or attribute seams are never collapsed away,
+    // which keeps silhouettes and UV layouts intact at the cost of less reduction on very seamy meshes.
+    // Returns a new, indexed, cache/fetch optimised mesh that isn't uploaded.
+    [[nodiscard]] Mesh SimplifyMesh(const Mesh& mesh, int targetTriangles, float maxError);
+
+    // For every model in the ResourceManager with enough triangles, stores up to 'levels' simplified copies as
+    // "<key>_lod1", "<key>_lod2"... (see lq::LodModelKey). Each level aims for half the triangles of the
+    // previous one, and a level that wouldn't save at least a fifth of them ends the chain.
+    void GenerateResourceManagerLods(int levels, unsigned int jobs);
+} // namespace sage::meshopt
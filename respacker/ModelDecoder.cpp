@@ -0,0 +1,1044 @@
+#include "ModelDecoder.hpp"
+
+#include "raymath.h"
+
+// raylib compiles cgltf's implementation into rmodels.c, only the declarations are needed here.
+#include "cgltf.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace sage
+{
+    namespace
+    {
+        template <typename T>
+        T* allocate(const std::size_t count)
+        {
+            return static_cast<T*>(RL_CALLOC(count, sizeof(T)));
+        }
+
+        unsigned char toByte(const float value)
+        {
+            return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+        }
+
+        Image loadImage(const fs::path& path)
+        {
+            return LoadImage(path.string().c_str());
+        }
+
+        // --- glTF / GLB ---------------------------------------------------------------------------------------
+        // Follows raylib's LoadGLTF: one mesh per triangle primitive of every node (baked into world space by the
+        // node's transform), material 0 is the default one, and the first skin provides the bones.
+
+        cgltf_options gltfOptions()
+        {
+            cgltf_options options{};
+            options.file.read = [](const cgltf_memory_options*,
+                                   const cgltf_file_options*,
+                                   const char* path,
+                                   cgltf_size* size,
+                                   void** data) {
+                int dataSize = 0;
+                auto* bytes = LoadFileData(path, &dataSize);
+                if (bytes == nullptr) return cgltf_result_io_error;
+                *size = static_cast<cgltf_size>(dataSize);
+                *data = bytes;
+                return cgltf_result_success;
+            };
+            // Generic, so it converts to the callback with or without the buffer size (added in cgltf 1.14).
+            options.file.release =
+                [](const cgltf_memory_options*, const cgltf_file_options*, void* data, auto...) {
+                    UnloadFileData(static_cast<unsigned char*>(data));
+                };
+            return options;
+        }
+
+        // raylib's LOAD_ATTRIBUTE: 'components' values per element, converted from Src to Dst.
+        template <typename Src, typename Dst>
+        bool readAccessor(const cgltf_accessor* accessor, const int components, Dst* out)
+        {
+            if (accessor->buffer_view == nullptr || accessor->buffer_view->buffer->data == nullptr) return false;
+            const auto* base = static_cast<const unsigned char*>(accessor->buffer_view->buffer->data) +
+                               accessor->buffer_view->offset + accessor->offset;
+            const auto stride = accessor->stride != 0 ? accessor->stride : components * sizeof(Src);
+            for (cgltf_size k = 0; k < accessor->count; ++k)
+            {
+                for (int c = 0; c < components; ++c)
+                {
+                    Src value;
+                    std::memcpy(&value, base + k * stride + c * sizeof(Src), sizeof(Src));
+                    out[k * components + c] = static_cast<Dst>(value);
+                }
+            }
+            return true;
+        }
+
+        // Normalised unsigned integers to floats in [0, 1].
+        template <typename Src>
+        float* readNormalised(const cgltf_accessor* accessor, const int components)
+        {
+            std::vector<Src> temp(accessor->count * components);
+            if (!readAccessor<Src>(accessor, components, temp.data())) return nullptr;
+            auto* out = allocate<float>(temp.size());
+            for (std::size_t i = 0; i < temp.size(); ++i)
+            {
+                out[i] = static_cast<float>(temp[i]) / static_cast<float>(std::numeric_limits<Src>::max());
+            }
+            return out;
+        }
+
+        Matrix worldMatrixOf(const cgltf_node* node)
+        {
+            cgltf_float m[16];
+            cgltf_node_transform_world(node, m);
+            // cgltf is column-major, raylib's Matrix fields are named row by row.
+            return {m[0], m[4], m[8], m[12],
+                    m[1], m[5], m[9], m[13],
+                    m[2], m[6], m[10], m[14],
+                    m[3], m[7], m[11], m[15]};
+        }
+
+        void transformVectors(float* values, const cgltf_size count, const int components, const Matrix& matrix)
+        {
+            for (cgltf_size k = 0; k < count; ++k)
+            {
+                auto* v = values + k * components;
+                const auto t = Vector3Transform({v[0], v[1], v[2]}, matrix);
+                v[0] = t.x;
+                v[1] = t.y;
+                v[2] = t.z;
+            }
+        }
+
+        bool isMime(const char* mime, const std::string_view type)
+        {
+            if (mime == nullptr) return false;
+            // Some exporters escape the slash.
+            std::string unescaped(mime);
+            std::erase(unescaped, '\\');
+            return unescaped == type;
+        }
+
+        Image loadGltfImage(const cgltf_image* image, const fs::path& directory)
+        {
+            if (image == nullptr) return {};
+            if (image->uri != nullptr)
+            {
+                const std::string_view uri(image->uri);
+                if (!uri.starts_with("data:")) return loadImage(directory / std::string(uri));
+
+                // data:<mediatype>;base64,<data>
+                const auto comma = uri.find(',');
+                if (comma == std::string_view::npos) return {};
+                auto encoded = uri.substr(comma + 1);
+                while (encoded.ends_with('=')) encoded.remove_suffix(1);
+                const auto size = encoded.size() * 6 / 8;
+                void* data = nullptr;
+                const auto options = gltfOptions();
+                if (cgltf_load_buffer_base64(&options, size, encoded.data(), &data) != cgltf_result_success)
+                {
+                    return {};
+                }
+                auto out = LoadImageFromMemory(".png", static_cast<unsigned char*>(data), static_cast<int>(size));
+                RL_FREE(data);
+                return out;
+            }
+
+            const auto* view = image->buffer_view;
+            if (view == nullptr || view->buffer->data == nullptr) return {};
+            const auto* bytes = static_cast<const unsigned char*>(view->buffer->data) + view->offset;
+            const auto size = static_cast<int>(view->size);
+            if (isMime(image->mime_type, "image/png")) return LoadImageFromMemory(".png", bytes, size);
+            if (isMime(image->mime_type, "image/jpeg")) return LoadImageFromMemory(".jpg", bytes, size);
+            return {};
+        }
+
+        void decodeGltfMaterial(
+            const cgltf_material& source, const int index, const fs::path& directory, DecodedModel& out)
+        {
+            auto& material = out.model.materials[index];
+            // Only reads rlgl's default shader and texture ids.
+            material = LoadMaterialDefault();
+            auto addTexture = [&](const int map, const cgltf_texture_view& view) {
+                if (view.texture == nullptr) return;
+                const auto image = loadGltfImage(view.texture->image, directory);
+                if (image.data != nullptr) out.textures.push_back({index, map, image});
+            };
+
+            if (!source.has_pbr_metallic_roughness) return;
+            const auto& pbr = source.pbr_metallic_roughness;
+            addTexture(MATERIAL_MAP_ALBEDO, pbr.base_color_texture);
+            material.maps[MATERIAL_MAP_ALBEDO].color = {
+                toByte(pbr.base_color_factor[0]),
+                toByte(pbr.base_color_factor[1]),
+                toByte(pbr.base_color_factor[2]),
+                toByte(pbr.base_color_factor[3])};
+
+            if (pbr.metallic_roughness_texture.texture != nullptr)
+            {
+                // Roughness is in the green channel, metalness in the blue one.
+                auto combined = loadGltfImage(pbr.metallic_roughness_texture.texture->image, directory);
+                if (combined.data != nullptr)
+                {
+                    auto channel = [&combined]() {
+                        Image image{};
+                        image.data = RL_MALLOC(combined.width * combined.height);
+                        image.width = combined.width;
+                        image.height = combined.height;
+                        image.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+                        image.mipmaps = 1;
+                        return image;
+                    };
+                    auto roughness = channel();
+                    auto metalness = channel();
+                    for (int y = 0; y < combined.height; ++y)
+                    {
+                        for (int x = 0; x < combined.width; ++x)
+                        {
+                            const auto colour = GetImageColor(combined, x, y);
+                            static_cast<unsigned char*>(roughness.data)[y * combined.width + x] = colour.g;
+                            static_cast<unsigned char*>(metalness.data)[y * combined.width + x] = colour.b;
+                        }
+                    }
+                    UnloadImage(combined);
+                    out.textures.push_back({index, MATERIAL_MAP_ROUGHNESS, roughness});
+                    out.textures.push_back({index, MATERIAL_MAP_METALNESS, metalness});
+                }
+                material.maps[MATERIAL_MAP_ROUGHNESS].value = pbr.roughness_factor;
+                material.maps[MATERIAL_MAP_METALNESS].value = pbr.metallic_factor;
+            }
+
+            addTexture(MATERIAL_MAP_NORMAL, source.normal_texture);
+            addTexture(MATERIAL_MAP_OCCLUSION, source.occlusion_texture);
+            if (source.emissive_texture.texture != nullptr)
+            {
+                addTexture(MATERIAL_MAP_EMISSION, source.emissive_texture);
+                material.maps[MATERIAL_MAP_EMISSION].color = {
+                    toByte(source.emissive_factor[0]),
+                    toByte(source.emissive_factor[1]),
+                    toByte(source.emissive_factor[2]),
+                    255};
+            }
+        }
+
+        unsigned char* readColors(const cgltf_accessor* accessor)
+        {
+            const int components = accessor->type == cgltf_type_vec4 ? 4 : 3;
+            if (accessor->type != cgltf_type_vec3 && accessor->type != cgltf_type_vec4) return nullptr;
+            std::vector<float> values(accessor->count * components);
+            bool read = false;
+            switch (accessor->component_type)
+            {
+            case cgltf_component_type_r_8u: {
+                std::vector<unsigned char> temp(values.size());
+                read = readAccessor<unsigned char>(accessor, components, temp.data());
+                std::ranges::transform(temp, values.begin(), [](const unsigned char v) { return v / 255.0f; });
+                break;
+            }
+            case cgltf_component_type_r_16u: {
+                std::vector<unsigned short> temp(values.size());
+                read = readAccessor<unsigned short>(accessor, components, temp.data());
+                std::ranges::transform(temp, values.begin(), [](const unsigned short v) { return v / 65535.0f; });
+                break;
+            }
+            case cgltf_component_type_r_32f:
+                read = readAccessor<float>(accessor, components, values.data());
+                break;
+            default:
+                break;
+            }
+            if (!read) return nullptr;
+
+            auto* colors = allocate<unsigned char>(accessor->count * 4);
+            for (cgltf_size k = 0; k < accessor->count; ++k)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    colors[k * 4 + c] = c < components ? toByte(values[k * components + c]) : 255;
+                }
+            }
+            return colors;
+        }
+
+        void decodeGltfPrimitive(
+            const cgltf_primitive& primitive, const Matrix& world, const Matrix& worldNormals, Mesh& mesh)
+        {
+            for (cgltf_size a = 0; a < primitive.attributes_count; ++a)
+            {
+                const auto& attribute = primitive.attributes[a];
+                const auto* accessor = attribute.data;
+                const bool vec3f = accessor->type == cgltf_type_vec3 &&
+                                   accessor->component_type == cgltf_component_type_r_32f;
+                switch (attribute.type)
+                {
+                case cgltf_attribute_type_position:
+                    if (!vec3f) break;
+                    mesh.vertexCount = static_cast<int>(accessor->count);
+                    mesh.vertices = allocate<float>(accessor->count * 3);
+                    readAccessor<float>(accessor, 3, mesh.vertices);
+                    transformVectors(mesh.vertices, accessor->count, 3, world);
+                    break;
+                case cgltf_attribute_type_normal:
+                    if (!vec3f) break;
+                    mesh.normals = allocate<float>(accessor->count * 3);
+                    readAccessor<float>(accessor, 3, mesh.normals);
+                    transformVectors(mesh.normals, accessor->count, 3, worldNormals);
+                    break;
+                case cgltf_attribute_type_tangent:
+                    if (accessor->type != cgltf_type_vec4 ||
+                        accessor->component_type != cgltf_component_type_r_32f)
+                        break;
+                    mesh.tangents = allocate<float>(accessor->count * 4);
+                    readAccessor<float>(accessor, 4, mesh.tangents);
+                    transformVectors(mesh.tangents, accessor->count, 4, world);
+                    break;
+                case cgltf_attribute_type_texcoord: {
+                    if (accessor->type != cgltf_type_vec2 || attribute.index > 1) break;
+                    float* texcoords = nullptr;
+                    if (accessor->component_type == cgltf_component_type_r_32f)
+                    {
+                        texcoords = allocate<float>(accessor->count * 2);
+                        readAccessor<float>(accessor, 2, texcoords);
+                    }
+                    else if (accessor->component_type == cgltf_component_type_r_8u)
+                    {
+                        texcoords = readNormalised<unsigned char>(accessor, 2);
+                    }
+                    else if (accessor->component_type == cgltf_component_type_r_16u)
+                    {
+                        texcoords = readNormalised<unsigned short>(accessor, 2);
+                    }
+                    (attribute.index == 0 ? mesh.texcoords : mesh.texcoords2) = texcoords;
+                    break;
+                }
+                case cgltf_attribute_type_color:
+                    if (attribute.index == 0) mesh.colors = readColors(accessor);
+                    break;
+                default:
+                    break; // Skinning attributes are read with the bones
+                }
+            }
+
+            const auto* indices = primitive.indices;
+            if (indices == nullptr || indices->buffer_view == nullptr)
+            {
+                mesh.triangleCount = mesh.vertexCount / 3;
+                return;
+            }
+            // raylib meshes have 16-bit indices.
+            mesh.triangleCount = static_cast<int>(indices->count / 3);
+            mesh.indices = allocate<unsigned short>(indices->count);
+            switch (indices->component_type)
+            {
+            case cgltf_component_type_r_8u:
+                readAccessor<unsigned char>(indices, 1, mesh.indices);
+                break;
+            case cgltf_component_type_r_16u:
+                readAccessor<unsigned short>(indices, 1, mesh.indices);
+                break;
+            case cgltf_component_type_r_32u:
+                readAccessor<unsigned int>(indices, 1, mesh.indices);
+                break;
+            default:
+                break;
+            }
+        }
+
+        void decodeGltfSkinning(
+            const cgltf_data* data,
+            const cgltf_node* node,
+            const cgltf_primitive& primitive,
+            Model& model,
+            Mesh& mesh)
+        {
+            bool hasJoints = false;
+            for (cgltf_size a = 0; a < primitive.attributes_count; ++a)
+            {
+                const auto& attribute = primitive.attributes[a];
+                const auto* accessor = attribute.data;
+                // JOINTS_1/WEIGHTS_1 (more than 4 influences) aren't supported by raylib.
+                if (attribute.index != 0 || accessor->type != cgltf_type_vec4) continue;
+                const auto values = static_cast<std::size_t>(mesh.vertexCount) * 4;
+                if (attribute.type == cgltf_attribute_type_joints)
+                {
+                    hasJoints = true;
+                    mesh.boneIds = allocate<unsigned char>(values);
+                    if (accessor->component_type == cgltf_component_type_r_8u)
+                    {
+                        readAccessor<unsigned char>(accessor, 4, mesh.boneIds);
+                    }
+                    else if (accessor->component_type == cgltf_component_type_r_16u)
+                    {
+                        // raylib's bone ids are 8-bit.
+                        readAccessor<unsigned short>(accessor, 4, mesh.boneIds);
+                    }
+                }
+                else if (attribute.type == cgltf_attribute_type_weights)
+                {
+                    if (accessor->component_type == cgltf_component_type_r_32f)
+                    {
+                        mesh.boneWeights = allocate<float>(values);
+                        readAccessor<float>(accessor, 4, mesh.boneWeights);
+                    }
+                    else if (accessor->component_type == cgltf_component_type_r_8u)
+                    {
+                        mesh.boneWeights = readNormalised<unsigned char>(accessor, 4);
+                    }
+                    else if (accessor->component_type == cgltf_component_type_r_16u)
+                    {
+                        mesh.boneWeights = readNormalised<unsigned short>(accessor, 4);
+                    }
+                }
+            }
+
+            // A mesh without weights parented to a bone follows that bone.
+            if (data->skins_count > 0 && !hasJoints && node->parent != nullptr && node->parent->mesh == nullptr)
+            {
+                for (int joint = 0; joint < model.boneCount; ++joint)
+                {
+                    if (data->skins[0].joints[joint] != node->parent) continue;
+                    mesh.boneIds = allocate<unsigned char>(static_cast<std::size_t>(mesh.vertexCount) * 4);
+                    mesh.boneWeights = allocate<float>(static_cast<std::size_t>(mesh.vertexCount) * 4);
+                    for (int v = 0; v < mesh.vertexCount * 4; v += 4)
+                    {
+                        mesh.boneIds[v] = static_cast<unsigned char>(joint);
+                        mesh.boneWeights[v] = 1.0f;
+                    }
+                    break;
+                }
+            }
+
+            const auto floats = static_cast<std::size_t>(mesh.vertexCount) * 3;
+            mesh.animVertices = allocate<float>(floats);
+            if (mesh.vertices != nullptr) std::memcpy(mesh.animVertices, mesh.vertices, floats * sizeof(float));
+            mesh.animNormals = allocate<float>(floats);
+            if (mesh.normals != nullptr) std::memcpy(mesh.animNormals, mesh.normals, floats * sizeof(float));
+
+            mesh.boneCount = model.boneCount;
+            mesh.boneMatrices = allocate<Matrix>(model.boneCount);
+            std::fill_n(mesh.boneMatrices, model.boneCount, MatrixIdentity());
+        }
+
+        BoneInfo* loadBones(const cgltf_skin& skin)
+        {
+            auto* bones = allocate<BoneInfo>(skin.joints_count);
+            for (cgltf_size i = 0; i < skin.joints_count; ++i)
+            {
+                const auto* joint = skin.joints[i];
+                if (joint->name != nullptr) std::strncpy(bones[i].name, joint->name, sizeof(bones[i].name) - 1);
+                bones[i].parent = -1;
+                for (cgltf_size j = 0; j < skin.joints_count; ++j)
+                {
+                    if (skin.joints[j] != joint->parent) continue;
+                    bones[i].parent = static_cast<int>(j);
+                    break;
+                }
+            }
+            return bones;
+        }
+
+        void decodeGltfBones(const cgltf_skin& skin, Model& model)
+        {
+            model.boneCount = static_cast<int>(skin.joints_count);
+            model.bones = loadBones(skin);
+            model.bindPose = allocate<Transform>(skin.joints_count);
+            for (cgltf_size i = 0; i < skin.joints_count; ++i)
+            {
+                auto& pose = model.bindPose[i];
+                MatrixDecompose(worldMatrixOf(skin.joints[i]), &pose.translation, &pose.rotation, &pose.scale);
+            }
+        }
+
+        // A parsed glTF/GLB with its buffers loaded. 'data' is null if the file couldn't be read or parsed.
+        class GltfFile
+        {
+            unsigned char* file = nullptr;
+
+          public:
+            cgltf_data* data = nullptr;
+
+            explicit GltfFile(const fs::path& path)
+            {
+                const auto pathString = path.string();
+                int size = 0;
+                file = LoadFileData(pathString.c_str(), &size);
+                if (file == nullptr) return;
+                const auto options = gltfOptions();
+                if (cgltf_parse(&options, file, static_cast<cgltf_size>(size), &data) != cgltf_result_success)
+                {
+                    std::cout << "WARNING: ModelDecoder -> Failed to parse " << path << "\n";
+                    data = nullptr;
+                    return;
+                }
+                if (cgltf_load_buffers(&options, data, pathString.c_str()) != cgltf_result_success)
+                {
+                    std::cout << "WARNING: ModelDecoder -> Failed to load buffers of " << path << "\n";
+                }
+            }
+
+            ~GltfFile()
+            {
+                if (data != nullptr) cgltf_free(data);
+                UnloadFileData(file); // cgltf reads from it until freed
+            }
+
+            GltfFile(const GltfFile&) = delete;
+            GltfFile& operator=(const GltfFile&) = delete;
+        };
+
+        DecodedModel decodeGltf(const fs::path& path)
+        {
+            DecodedModel out;
+            const GltfFile gltf(path);
+            const auto* data = gltf.data;
+            if (data == nullptr) return out;
+
+            auto& model = out.model;
+            int primitives = 0;
+            for (cgltf_size n = 0; n < data->nodes_count; ++n)
+            {
+                if (const auto* mesh = data->nodes[n].mesh)
+                {
+                    primitives += static_cast<int>(std::ranges::count_if(
+                        mesh->primitives,
+                        mesh->primitives + mesh->primitives_count,
+                        [](const cgltf_primitive& p) { return p.type == cgltf_primitive_type_triangles; }));
+                }
+            }
+            model.meshCount = primitives;
+            model.meshes = allocate<Mesh>(model.meshCount);
+            model.meshMaterial = allocate<int>(model.meshCount);
+            model.materialCount = static_cast<int>(data->materials_count) + 1;
+            model.materials = allocate<Material>(model.materialCount);
+            model.materials[0] = LoadMaterialDefault();
+            const auto directory = path.parent_path();
+            for (cgltf_size m = 0; m < data->materials_count; ++m)
+            {
+                decodeGltfMaterial(data->materials[m], static_cast<int>(m) + 1, directory, out);
+            }
+            if (data->skins_count > 0) decodeGltfBones(data->skins[0], model);
+            if (data->skins_count > 1)
+            {
+                std::cout << "WARNING: ModelDecoder -> Only the first of several skins is loaded from " << path
+                          << "\n";
+            }
+
+            int meshIndex = 0;
+            for (cgltf_size n = 0; n < data->nodes_count; ++n)
+            {
+                const auto* node = &data->nodes[n];
+                if (node->mesh == nullptr) continue;
+                const auto world = worldMatrixOf(node);
+                const auto worldNormals = MatrixTranspose(MatrixInvert(world));
+                for (cgltf_size p = 0; p < node->mesh->primitives_count; ++p)
+                {
+                    const auto& primitive = node->mesh->primitives[p];
+                    if (primitive.type != cgltf_primitive_type_triangles) continue;
+                    auto& mesh = model.meshes[meshIndex];
+                    decodeGltfPrimitive(primitive, world, worldNormals, mesh);
+                    if (primitive.material != nullptr)
+                    {
+                        model.meshMaterial[meshIndex] = static_cast<int>(primitive.material - data->materials) + 1;
+                    }
+                    decodeGltfSkinning(data, node, primitive, model, mesh);
+                    ++meshIndex;
+                }
+            }
+
+            return out;
+        }
+
+        // Follows raylib's LoadModelAnimationsGLTF: every animation is sampled every kAnimationFrameMs against the
+        // first skin's joints, and the poses are stored in model space.
+        constexpr int kAnimationFrameMs = 17; // raylib's GLTF_ANIMDELAY
+
+        // raylib's GetPoseAtTimeGLTF. Leaves 'out' alone (the joint's rest value) for a constant key pair.
+        template <typename T>
+        bool sampleChannel(const cgltf_animation_sampler& sampler, const float time, T& out)
+        {
+            constexpr int components = sizeof(T) / sizeof(float);
+            const auto* input = sampler.input;
+            const auto* output = sampler.output;
+            if (sampler.interpolation >= cgltf_interpolation_type_max_enum) return false;
+
+            float start = 0;
+            float end = 0;
+            cgltf_size key = 0;
+            for (cgltf_size i = 0; i + 1 < input->count; ++i)
+            {
+                if (!cgltf_accessor_read_float(input, i, &start, 1) ||
+                    !cgltf_accessor_read_float(input, i + 1, &end, 1))
+                    return false;
+                if (start <= time && time < end)
+                {
+                    key = i;
+                    break;
+                }
+            }
+            if (FloatEquals(end, start)) return true;
+            const auto t = std::clamp((time - start) / std::max(end - start, EPSILON), 0.0f, 1.0f);
+            if (output->component_type != cgltf_component_type_r_32f) return false;
+            if (output->type != (components == 3 ? cgltf_type_vec3 : cgltf_type_vec4)) return true;
+
+            auto read = [output](const cgltf_size index) {
+                T value{};
+                cgltf_accessor_read_float(output, index, reinterpret_cast<float*>(&value), components);
+                return value;
+            };
+            switch (sampler.interpolation)
+            {
+            case cgltf_interpolation_type_step:
+                out = read(key);
+                break;
+            case cgltf_interpolation_type_linear:
+                if constexpr (components == 3) out = Vector3Lerp(read(key), read(key + 1), t);
+                else out = QuaternionSlerp(read(key), read(key + 1), t);
+                break;
+            case cgltf_interpolation_type_cubic_spline: {
+                // Keys are (in-tangent, value, out-tangent) triples.
+                const auto v1 = read(3 * key + 1);
+                const auto outTangent = read(3 * key + 2);
+                const auto v2 = read(3 * (key + 1) + 1);
+                const auto inTangent = read(3 * (key + 1));
+                if constexpr (components == 3) out = Vector3CubicHermite(v1, outTangent, v2, inTangent, t);
+                else out = QuaternionCubicHermiteSpline(v1, outTangent, v2, inTangent, t);
+                break;
+            }
+            default:
+                break;
+            }
+            return true;
+        }
+
+        // Local joint transforms to model space, parents first.
+        void applyParentPoses(const BoneInfo* bones, const int boneCount, Transform* poses)
+        {
+            for (int i = 0; i < boneCount; ++i)
+            {
+                const auto parent = bones[i].parent;
+                if (parent < 0 || parent > i) continue; // raylib skips (and warns about) unsorted joints
+                auto& pose = poses[i];
+                pose.rotation = QuaternionMultiply(poses[parent].rotation, pose.rotation);
+                const auto rotated = Vector3RotateByQuaternion(pose.translation, poses[parent].rotation);
+                pose.translation = Vector3Add(rotated, poses[parent].translation);
+                pose.scale = Vector3Multiply(pose.scale, poses[parent].scale);
+            }
+        }
+
+        void decodeGltfAnimation(
+            const cgltf_animation& source, const cgltf_skin& skin, const fs::path& path, ModelAnimation& out)
+        {
+            out.boneCount = static_cast<int>(skin.joints_count);
+            out.bones = loadBones(skin);
+            if (source.name != nullptr) std::strncpy(out.name, source.name, sizeof(out.name) - 1);
+
+            struct Channels
+            {
+                const cgltf_animation_sampler* translation = nullptr;
+                const cgltf_animation_sampler* rotation = nullptr;
+                const cgltf_animation_sampler* scale = nullptr;
+            };
+            std::vector<Channels> channels(skin.joints_count);
+            float duration = 0;
+            for (cgltf_size c = 0; c < source.channels_count; ++c)
+            {
+                const auto& channel = source.channels[c];
+                const auto* jointsEnd = skin.joints + skin.joints_count;
+                const auto joint = std::ranges::find(skin.joints, jointsEnd, channel.target_node);
+                if (joint == jointsEnd) continue; // Animates a node outside the skeleton
+                auto& bone = channels[joint - skin.joints];
+                switch (channel.target_path)
+                {
+                case cgltf_animation_path_type_translation:
+                    bone.translation = channel.sampler;
+                    break;
+                case cgltf_animation_path_type_rotation:
+                    bone.rotation = channel.sampler;
+                    break;
+                case cgltf_animation_path_type_scale:
+                    bone.scale = channel.sampler;
+                    break;
+                default:
+                    std::cout << "WARNING: ModelDecoder -> Unsupported animation channel in " << path << "\n";
+                    break;
+                }
+                float last = 0;
+                const auto* input = channel.sampler->input;
+                if (input->count > 0 && cgltf_accessor_read_float(input, input->count - 1, &last, 1))
+                {
+                    duration = std::max(duration, last);
+                }
+            }
+
+            out.frameCount = static_cast<int>(duration * 1000.0f / kAnimationFrameMs) + 1;
+            out.framePoses = allocate<Transform*>(out.frameCount);
+            for (int frame = 0; frame < out.frameCount; ++frame)
+            {
+                auto* poses = allocate<Transform>(skin.joints_count);
+                out.framePoses[frame] = poses;
+                const auto time = static_cast<float>(frame * kAnimationFrameMs) / 1000.0f;
+                for (cgltf_size k = 0; k < skin.joints_count; ++k)
+                {
+                    const auto* joint = skin.joints[k];
+                    auto& pose = poses[k];
+                    pose.translation = {joint->translation[0], joint->translation[1], joint->translation[2]};
+                    const auto* r = joint->rotation;
+                    pose.rotation = {r[0], r[1], r[2], r[3]};
+                    pose.scale = {joint->scale[0], joint->scale[1], joint->scale[2]};
+                    const auto& bone = channels[k];
+                    if (bone.translation != nullptr) sampleChannel(*bone.translation, time, pose.translation);
+                    if (bone.rotation != nullptr) sampleChannel(*bone.rotation, time, pose.rotation);
+                    if (bone.scale != nullptr) sampleChannel(*bone.scale, time, pose.scale);
+                }
+                applyParentPoses(out.bones, out.boneCount, poses);
+            }
+        }
+
+        // --- OBJ ----------------------------------------------------------------------------------------------
+        // Follows raylib's LoadOBJ: faces are triangulated as fans and split into one unindexed mesh per object,
+        // group and material run, texture V is flipped and vertex colours are white. Material libraries and
+        // their texture maps are resolved relative to the OBJ, which raylib does by changing the process's
+        // working directory.
+
+        struct ObjMaterial
+        {
+            std::string name;
+            float diffuse[3]{};
+            float specular[3]{};
+            float emission[3]{};
+            float shininess = 0;
+            std::string diffuseMap;
+            std::string specularMap;
+            std::string bumpMap;
+            std::string displacementMap;
+        };
+
+        std::string_view trim(std::string_view text)
+        {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+                text.remove_suffix(1);
+            return text;
+        }
+
+        // Splits off the first word of 'line', leaving the rest (trimmed) in it.
+        std::string_view nextWord(std::string_view& line)
+        {
+            line = trim(line);
+            const auto end = std::min(line.find_first_of(" \t"), line.size());
+            const auto word = line.substr(0, end);
+            line = trim(line.substr(end));
+            return word;
+        }
+
+        template <typename Fn>
+        void forEachLine(const std::string_view text, Fn&& fn)
+        {
+            std::size_t start = 0;
+            while (start < text.size())
+            {
+                auto end = text.find('\n', start);
+                if (end == std::string_view::npos) end = text.size();
+                auto line = text.substr(start, end - start);
+                start = end + 1;
+                const auto keyword = nextWord(line);
+                if (!keyword.empty() && keyword.front() != '#') fn(keyword, line);
+            }
+        }
+
+        float parseFloat(std::string_view& line)
+        {
+            const auto word = nextWord(line);
+            float value = 0;
+            std::from_chars(word.data(), word.data() + word.size(), value);
+            return value;
+        }
+
+        // Texture map statements may carry options ("-s 1 1 1 file.png"); the file is the last word.
+        std::string mapFile(const std::string_view line)
+        {
+            const auto space = line.find_last_of(" \t");
+            return std::string(space == std::string_view::npos ? line : line.substr(space + 1));
+        }
+
+        void parseMtl(const fs::path& path, std::vector<ObjMaterial>& materials)
+        {
+            auto* text = LoadFileText(path.string().c_str());
+            if (text == nullptr)
+            {
+                std::cout << "WARNING: ModelDecoder -> Failed to read material library " << path << "\n";
+                return;
+            }
+            ObjMaterial* current = nullptr;
+            forEachLine(text, [&](const std::string_view keyword, std::string_view line) {
+                if (keyword == "newmtl")
+                {
+                    current = &materials.emplace_back();
+                    current->name = std::string(line);
+                    return;
+                }
+                if (current == nullptr) return;
+                auto readColour = [&line](float* out) {
+                    for (int c = 0; c < 3; ++c) out[c] = parseFloat(line);
+                };
+                if (keyword == "Kd") readColour(current->diffuse);
+                else if (keyword == "Ks") readColour(current->specular);
+                else if (keyword == "Ke") readColour(current->emission);
+                else if (keyword == "Ns") current->shininess = parseFloat(line);
+                else if (keyword == "map_Kd") current->diffuseMap = mapFile(line);
+                else if (keyword == "map_Ks") current->specularMap = mapFile(line);
+                else if (keyword == "map_bump" || keyword == "map_Bump" || keyword == "bump")
+                    current->bumpMap = mapFile(line);
+                else if (keyword == "disp") current->displacementMap = mapFile(line);
+            });
+            UnloadFileText(text);
+        }
+
+        void decodeObjMaterials(
+            const std::vector<ObjMaterial>& materials, const fs::path& directory, DecodedModel& out)
+        {
+            auto& model = out.model;
+            model.materialCount = std::max(1, static_cast<int>(materials.size()));
+            model.materials = allocate<Material>(model.materialCount);
+            model.materials[0] = LoadMaterialDefault();
+            for (int m = 0; m < static_cast<int>(materials.size()); ++m)
+            {
+                const auto& source = materials[m];
+                auto& material = model.materials[m];
+                material = LoadMaterialDefault();
+                auto addTexture = [&](const int map, const std::string& file) {
+                    out.textures.push_back({m, map, loadImage(directory / file)});
+                };
+                auto colour = [](const float* rgb) -> Color {
+                    return {toByte(rgb[0]), toByte(rgb[1]), toByte(rgb[2]), 255};
+                };
+
+                if (!source.diffuseMap.empty()) addTexture(MATERIAL_MAP_DIFFUSE, source.diffuseMap);
+                else material.maps[MATERIAL_MAP_DIFFUSE].color = colour(source.diffuse);
+                material.maps[MATERIAL_MAP_DIFFUSE].value = 0;
+
+                if (!source.specularMap.empty()) addTexture(MATERIAL_MAP_SPECULAR, source.specularMap);
+                material.maps[MATERIAL_MAP_SPECULAR].color = colour(source.specular);
+                material.maps[MATERIAL_MAP_SPECULAR].value = 0;
+
+                if (!source.bumpMap.empty()) addTexture(MATERIAL_MAP_NORMAL, source.bumpMap);
+                material.maps[MATERIAL_MAP_NORMAL].color = WHITE;
+                material.maps[MATERIAL_MAP_NORMAL].value = source.shininess;
+
+                material.maps[MATERIAL_MAP_EMISSION].color = colour(source.emission);
+                if (!source.displacementMap.empty()) addTexture(MATERIAL_MAP_HEIGHT, source.displacementMap);
+            }
+        }
+
+        DecodedModel decodeObj(const fs::path& path)
+        {
+            DecodedModel out;
+            auto* text = LoadFileText(path.string().c_str());
+            if (text == nullptr) return out;
+
+            struct Builder
+            {
+                int material = -1;
+                std::vector<float> vertices;
+                std::vector<float> normals;
+                std::vector<float> texcoords;
+            };
+
+            const auto directory = path.parent_path();
+            std::vector<ObjMaterial> materials;
+            std::unordered_map<std::string, int> materialIndex;
+            std::vector<float> positions;
+            std::vector<float> normals;
+            std::vector<float> texcoords;
+            std::vector<Builder> meshes(1);
+            int currentMaterial = -1;
+            bool newGroup = false;
+
+            // 1-based, or negative from the end of what's been read so far. Missing or invalid is -1.
+            auto resolve = [](const std::string_view text, const std::size_t count) {
+                int value = 0;
+                const auto* end = text.data() + text.size();
+                if (text.empty() || std::from_chars(text.data(), end, value).ec != std::errc{}) return -1;
+                const auto index = value > 0 ? value - 1 : static_cast<int>(count) + value;
+                return index >= 0 && index < static_cast<int>(count) ? index : -1;
+            };
+            auto addVertex = [&](Builder& mesh, const std::string_view corner) {
+                const auto slash = corner.find('/');
+                const auto slash2 = slash == std::string_view::npos ? slash : corner.find('/', slash + 1);
+                const auto v = resolve(corner.substr(0, slash), positions.size() / 3);
+                const auto vt = slash == std::string_view::npos
+                                    ? -1
+                                    : resolve(corner.substr(slash + 1, slash2 - slash - 1), texcoords.size() / 2);
+                const auto vn =
+                    slash2 == std::string_view::npos ? -1 : resolve(corner.substr(slash2 + 1), normals.size() / 3);
+                for (int c = 0; c < 3; ++c)
+                {
+                    mesh.vertices.push_back(v >= 0 ? positions[v * 3 + c] : 0.0f);
+                    mesh.normals.push_back(vn >= 0 ? normals[vn * 3 + c] : 0.0f);
+                }
+                mesh.texcoords.push_back(vt >= 0 ? texcoords[vt * 2] : 0.0f);
+                mesh.texcoords.push_back(1.0f - (vt >= 0 ? texcoords[vt * 2 + 1] : 0.0f));
+            };
+
+            forEachLine(text, [&](const std::string_view keyword, std::string_view line) {
+                if (keyword == "v" || keyword == "vn")
+                {
+                    auto& target = keyword == "v" ? positions : normals;
+                    for (int c = 0; c < 3; ++c) target.push_back(parseFloat(line));
+                }
+                else if (keyword == "vt")
+                {
+                    texcoords.push_back(parseFloat(line));
+                    texcoords.push_back(parseFloat(line));
+                }
+                else if (keyword == "mtllib")
+                {
+                    const auto first = materials.size();
+                    parseMtl(directory / std::string(line), materials);
+                    for (auto m = first; m < materials.size(); ++m)
+                    {
+                        materialIndex.try_emplace(materials[m].name, static_cast<int>(m));
+                    }
+                }
+                else if (keyword == "usemtl")
+                {
+                    const auto it = materialIndex.find(std::string(line));
+                    currentMaterial = it != materialIndex.end() ? it->second : -1;
+                }
+                else if (keyword == "o" || keyword == "g")
+                {
+                    newGroup = true;
+                }
+                else if (keyword == "f")
+                {
+                    std::vector<std::string_view> corners;
+                    while (!line.empty()) corners.push_back(nextWord(line));
+                    if (corners.size() < 3) return;
+
+                    auto* mesh = &meshes.back();
+                    if (!mesh->vertices.empty() && (newGroup || mesh->material != currentMaterial))
+                    {
+                        mesh = &meshes.emplace_back();
+                    }
+                    mesh->material = currentMaterial;
+                    newGroup = false;
+                    for (std::size_t k = 2; k < corners.size(); ++k)
+                    {
+                        addVertex(*mesh, corners[0]);
+                        addVertex(*mesh, corners[k - 1]);
+                        addVertex(*mesh, corners[k]);
+                    }
+                }
+            });
+            UnloadFileText(text);
+
+            auto& model = out.model;
+            model.meshCount = static_cast<int>(meshes.size());
+            model.meshes = allocate<Mesh>(model.meshCount);
+            model.meshMaterial = allocate<int>(model.meshCount);
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                const auto& source = meshes[m];
+                auto& mesh = model.meshes[m];
+                mesh.vertexCount = static_cast<int>(source.vertices.size() / 3);
+                mesh.triangleCount = mesh.vertexCount / 3;
+                mesh.vertices = allocate<float>(source.vertices.size());
+                mesh.normals = allocate<float>(source.normals.size());
+                mesh.texcoords = allocate<float>(source.texcoords.size());
+                std::ranges::copy(source.vertices, mesh.vertices);
+                std::ranges::copy(source.normals, mesh.normals);
+                std::ranges::copy(source.texcoords, mesh.texcoords);
+                mesh.colors = allocate<unsigned char>(static_cast<std::size_t>(mesh.vertexCount) * 4);
+                std::fill_n(mesh.colors, mesh.vertexCount * 4, 255);
+                const bool known = source.material >= 0 && source.material < static_cast<int>(materials.size());
+                model.meshMaterial[m] = known ? source.material : 0;
+            }
+            decodeObjMaterials(materials, directory, out);
+            return out;
+        }
+
+        std::string lowercaseExtension(const fs::path& path)
+        {
+            auto extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return std::tolower(c); });
+            return extension;
+        }
+    } // namespace
+
+    DecodedModel DecodeModelFile(const fs::path& path)
+    {
+        const auto extension = lowercaseExtension(path);
+        auto out = extension == ".obj" ? decodeObj(path) : decodeGltf(path);
+        auto& model = out.model;
+        model.transform = MatrixIdentity();
+        if (model.materialCount == 0)
+        {
+            model.materialCount = 1;
+            model.materials = allocate<Material>(1);
+            model.materials[0] = LoadMaterialDefault();
+            if (model.meshMaterial == nullptr) model.meshMaterial = allocate<int>(std::max(1, model.meshCount));
+        }
+        return out;
+    }
+
+    ModelAnimation* DecodeModelAnimationsFile(const fs::path& path, int* count)
+    {
+        *count = 0;
+        const auto extension = lowercaseExtension(path);
+        if (extension != ".gltf" && extension != ".glb") return nullptr;
+        const GltfFile gltf(path);
+        const auto* data = gltf.data;
+        if (data == nullptr || data->skins_count == 0) return nullptr;
+
+        auto* animations = allocate<ModelAnimation>(data->animations_count);
+        for (cgltf_size i = 0; i < data->animations_count; ++i)
+        {
+            decodeGltfAnimation(data->animations[i], data->skins[0], path, animations[i]);
+        }
+        *count = static_cast<int>(data->animations_count);
+        return animations;
+    }
+
+    Model FinishDecodedModel(DecodedModel&& decoded)
+    {
+        auto model = decoded.model;
+        for (auto& [material, map, image] : decoded.textures)
+        {
+            model.materials[material].maps[map].texture =
+                image.data != nullptr ? LoadTextureFromImage(image) : Texture2D{};
+            UnloadImage(image);
+        }
+        decoded = {};
+
+        if (model.meshCount == 0 || model.meshes == nullptr)
+        {
+            std::cout << "WARNING: ModelDecoder -> Model has no mesh data \n";
+        }
+        for (int m = 0; m < model.meshCount; ++m)
+        {
+            UploadMesh(&model.meshes[m], false);
+        }
+        return model;
+    }
+
+    void UnloadDecodedModel(DecodedModel&& decoded)
+    {
+        for (auto& texture : decoded.textures)
+        {
+            UnloadImage(texture.image);
+        }
+        UnloadModel(decoded.model);
+        decoded = {};
+    }
+} // namespace sage
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace sage
+{
+    // The CPU half of raylib's LoadModel for glTF/GLB and OBJ files, safe to run on worker threads. Meshes and
+    // materials come out as raylib's loaders build them, except that nothing touches GL: meshes aren't uploaded
+    // and material textures are left as decoded images. FinishDecodedModel does the GPU half on the thread that
+    // owns the GL context.
+    //
+    // Files (the model, glTF buffers and images, OBJ material libraries and texture maps) are read through
+    // raylib's LoadFileData/LoadFileText, so any file callbacks set must be safe to call from several threads.
+    struct DecodedModel
+    {
+        struct PendingTexture
+        {
+            int material = 0;
+            int map = 0;     // MaterialMapIndex
+            Image image{};   // A failed load stays empty and becomes an empty texture, as raylib's LoadTexture
+        };
+
+        Model model{};
+        std::vector<PendingTexture> textures;
+    };
+
+    [[nodiscard]] DecodedModel DecodeModelFile(const std::filesystem::path& path);
+    // Uploads the meshes and textures. Main thread only.
+    [[nodiscard]] Model FinishDecodedModel(DecodedModel&& decoded);
+    // Frees a decoded model that won't be finished. Main thread only.
+    void UnloadDecodedModel(DecodedModel&& decoded);
+
+    // raylib's LoadModelAnimations for glTF/GLB, which is CPU-only too but not safe on worker threads (its file
+    // extension check goes through TextSplit's static buffer). Returns null for other formats. Free with
+    // UnloadModelAnimations.
+    [[nodiscard]] ModelAnimation* DecodeModelAnimationsFile(const std::filesystem::path& path, int* count);
+} // namespace sage
@@ -0,0 +1,134 @@
+#include "PackOptions.hpp"
+
+#include "game/src/components/MeshLod.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+
+namespace sage
+{
+    namespace
+    {
+        unsigned int parseUnsigned(const std::string_view flag, const char* value)
+        {
+            const std::string_view text = value;
+            unsigned int out = 0;
+            const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (ec != std::errc{} || ptr != text.data() + text.size())
+            {
+                std::cerr << "ERROR: " << flag << " expects a non-negative integer, got '" << text << "'"
+                          << std::endl;
+                exit(1);
+            }
+            return out;
+        }
+
+        float parseFloat(const std::string_view flag, const char* value)
+        {
+            char* end = nullptr;
+            const float out = std::strtof(value, &end);
+            if (end == value || *end != '\0' || out < 0.0f)
+            {
+                std::cerr << "ERROR: " << flag << " expects a non-negative number, got '" << value << "'"
+                          << std::endl;
+                exit(1);
+            }
+            return out;
+        }
+
+        const char* requireValue(const int argc, char* argv[], int& i)
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "ERROR: " << argv[i] << " expects a value." << std::endl;
+                exit(1);
+            }
+            return argv[++i];
+        }
+    } // namespace
+
+    bool PackOptions::IsOption(const std::string_view arg)
+    {
+        return arg == "--jobs" || arg == "-j" || arg == "--no-cache" || arg == "--headless" ||
+               arg == "--chunk-size" || arg == "--uncompressed" || arg == "--optimize-meshes" || arg == "--lods" ||
+               arg == "--quantize-meshes" || arg == "--compress-animations" || arg == "--batch-static" ||
+               arg == "--bake-lighting" || arg == "--no-dedupe";
+    }
+
+    PackOptions PackOptions::Parse(
+        const int argc, char* argv[], const int first, std::vector<std::string>& positional)
+    {
+        PackOptions options;
+        for (int i = first; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--jobs" || arg == "-j")
+            {
+                options.jobs = parseUnsigned(arg, requireValue(argc, argv, i));
+            }
+            else if (arg == "--no-cache")
+            {
+                options.useCache = false;
+            }
+            else if (arg == "--chunk-size")
+            {
+                options.chunkSize = parseFloat(arg, requireValue(argc, argv, i));
+            }
+            else if (arg == "--uncompressed")
+            {
+                options.compress = false;
+            }
+            else if (arg == "--optimize-meshes")
+            {
+                options.optimizeMeshes = true;
+            }
+            else if (arg == "--quantize-meshes")
+            {
+                options.quantizeMeshes = true;
+            }
+            else if (arg == "--compress-animations")
+            {
+                options.compressAnimations = true;
+            }
+            else if (arg == "--batch-static")
+            {
+                options.batchStatic = true;
+            }
+            else if (arg == "--bake-lighting")
+            {
+                options.batchStatic = true;
+                options.bakeLighting = true;
+            }
+            else if (arg == "--no-dedupe")
+            {
+                options.dedupeMeshes = false;
+            }
+            else if (arg == "--lods")
+            {
+                const auto levels = parseUnsigned(arg, requireValue(argc, argv, i));
+                if (levels > lq::kMaxLodLevels)
+                {
+                    std::cerr << "ERROR: --lods supports at most " << lq::kMaxLodLevels << " levels, got "
+                              << levels << std::endl;
+                    exit(1);
+                }
+                options.lodLevels = static_cast<int>(levels);
+            }
+            else if (arg == "--headless")
+            {
+                options.headless = true;
+            }
+            else if (arg.starts_with("--"))
+            {
+                std::cerr << "ERROR: Unknown respacker option: " << arg << std::endl;
+                exit(1);
+            }
+            else
+            {
+                positional.emplace_back(arg);
+            }
+        }
+        return options;
+    }
+} // namespace sage
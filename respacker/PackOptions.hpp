@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sage
+{
+    // Command line switches shared by every respacker command.
+    struct PackOptions
+    {
+        // Worker threads used to decode/read assets before they are committed to the ResourceManager.
+        // 1 keeps everything on the main thread, 0 uses one worker per hardware thread.
+        unsigned int jobs = 1;
+        // Reuse imports of unchanged models from the "<output>.cache" directory ("--no-cache" disables it).
+        bool useCache = true;
+        // Never open a window, even if a display is available ("--headless"). Implied when there is no display.
+        // GL then comes from a software OSMesa context, so Mesa's libOSMesa must be installed.
+        bool headless = false;
+        // Edge length (world units) of the streamed static geometry chunks in map bins. 0 keeps the whole map
+        // resident.
+        float chunkSize = 64.0f;
+        // Store asset pack entries and map chunks uncompressed ("--uncompressed"), so the game reads them in
+        // place from the memory mapped file. Trades disk size for load time and memory.
+        bool compress = true;
+        // Weld duplicate vertices and reorder indices/vertices for the GPU's vertex cache and vertex fetch
+        // ("--optimize-meshes"). Prints before/after statistics per mesh.
+        bool optimizeMeshes = false;
+        // Store vertex positions, normals, tangents and UVs in 16 bit formats ("--quantize-meshes"). Meshes are
+        // expanded back to floats when the game loads them.
+        bool quantizeMeshes = false;
+        // Drop redundant keyframes and constant tracks from animation clips and quantize their rotations
+        // ("--compress-animations"). Clips are expanded back to per-frame poses when the game loads them.
+        bool compressAnimations = false;
+        // Simplified copies stored per model for distance LOD ("--lods N", 0 disables them). Each level has
+        // roughly half the triangles of the previous one.
+        int lodLevels = 3;
+        // Merge plain static scenery into one mesh per material and chunk cell when constructing maps
+        // ("--batch-static"). Fewer draw calls; collision still uses the individual objects.
+        bool batchStatic = false;
+        // Bake the direct lighting of the map's lights into the static batches' vertex colours, so they skip the
+        // per-pixel light loop ("--bake-lighting", implies "--batch-static"). Lights added at runtime don't
+        // reach baked scenery.
+        bool bakeLighting = false;
+        // Replace map meshes that are geometrically identical to another one (same triangles and materials) by
+        // a reference to that one when constructing maps ("--no-dedupe" disables it).
+        bool dedupeMeshes = true;
+
+        [[nodiscard]] static bool IsOption(std::string_view arg);
+
+        // Splits "--flag value" style switches out of argv. Anything that isn't a recognised switch is
+        // returned (in order) as a positional argument.
+        static PackOptions Parse(int argc, char* argv[], int first, std::vector<std::string>& positional);
+    };
+} // namespace sage
@@ -1,5 +1,17 @@
 #include "ResourcePacker.hpp"
 
+#include "AssetIngest.hpp"
+#include "AssetPackWriter.hpp"
+#include "BuildCache.hpp"
+#include "BuildReport.hpp"
+#include "LightBaker.hpp"
+#include "MapDescriptor.hpp"
+#include "MapReferences.hpp"
+#include "MeshDeduplicator.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "StaticBatcher.hpp"
+
 #include "engine/components/Collideable.hpp"
 #include "engine/components/DoorBehaviorComponent.hpp"
 #include "engine/components/Renderable.hpp"
@@ -18,10 +30,15 @@
 #include "game/src/components/InventoryComponent.hpp"
 #include "game/src/components/ItemComponent.hpp"
 #include "game/src/components/QuestComponents.hpp"
+#include "game/src/components/StaticBatchMember.hpp"
 #include "game/src/GameObjectFactory.hpp"
 #include "game/src/ItemFactory.hpp"
 #include "game/src/QuestManager.hpp"
+#include "game/utils/AssetPack.hpp"
 #include "game/utils/MapLoader.hpp"
+#include "game/utils/MapObjectTags.hpp"
+#include "game/utils/NavigationGridBake.hpp"
+#include "game/utils/ParallelFor.hpp"
 
 #include "engine/systems/TransformSystem.hpp"
 #include "raylib.h"
@@ -31,13 +48,14 @@
 #include <cassert>
 #include <filesystem>
 #include <fstream>
-#include <initializer_list>
+#include <utility>
 #include <iostream>
+#include <iterator>
 #include <optional>
-#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -53,80 +71,35 @@ namespace sage
         return Vector3Scale(point, scale);
     }
 
-    CollisionLayer getCollisionLayer(const std::string& objectName)
+    CollisionLayer getCollisionLayer(const lq::MapObjectTags& tags)
     {
-        if (objectName.find("_BLD_") != std::string::npos)
-        {
-            return lq::collision_layers::Building;
-        }
-        if (objectName.find("_WALL_") != std::string::npos)
-        {
-            return lq::collision_layers::Building;
-        }
-        if (objectName.find("_HOLE_") != std::string::npos)
-        {
-            return lq::collision_layers::Building;
-        }
-        if (objectName.find("_BG_") != std::string::npos)
-        {
-            return collision_layers::Background;
-        }
-        if (objectName.find("_FLOORSIMPLE_") != std::string::npos)
-        {
+        using lq::MapObjectTag;
+        // First match wins, e.g. a "_BLD_..._FLOORSIMPLE_" object collides as a building.
+        static const std::pair<MapObjectTag, CollisionLayer> layerTable[]{
+            {MapObjectTag::BLD, lq::collision_layers::Building},
+            {MapObjectTag::WALL, lq::collision_layers::Building},
+            {MapObjectTag::HOLE, lq::collision_layers::Building},
+            {MapObjectTag::BG, collision_layers::Background},
             // Uses bounding box bounds for height (flat surfaces).
-            return collision_layers::GeometrySimple;
-        }
-        if (objectName.find("_FLOORCOMPLEX_") != std::string::npos)
-        {
+            {MapObjectTag::FLOORSIMPLE, collision_layers::GeometrySimple},
             // Samples mesh for height/normal information
-            return collision_layers::GeometryComplex;
-        }
-        if (objectName.find("_PROP_") != std::string::npos)
-        {
-            return lq::collision_layers::Building;
-        }
-        if (objectName.find("_STAIRS_") != std::string::npos)
-        {
-            return collision_layers::Stairs;
-        }
-        if (objectName.find("_MAPBASE_") != std::string::npos)
-        {
-            return collision_layers::Background;
-        }
-        if (objectName.find("_ITEM_") != std::string::npos)
-        {
-            return lq::collision_layers::Item;
-        }
-        if (objectName.find("_DOOR_") != std::string::npos)
-        {
-            return lq::collision_layers::Building;
-        }
-        if (objectName.find("_INTERACTABLE_") != std::string::npos)
-        {
-            return lq::collision_layers::Interactable;
-        }
-        if (objectName.find("_CHEST_") != std::string::npos)
+            {MapObjectTag::FLOORCOMPLEX, collision_layers::GeometryComplex},
+            {MapObjectTag::PROP, lq::collision_layers::Building},
+            {MapObjectTag::STAIRS, collision_layers::Stairs},
+            {MapObjectTag::MAPBASE, collision_layers::Background},
+            {MapObjectTag::ITEM, lq::collision_layers::Item},
+            {MapObjectTag::DOOR, lq::collision_layers::Building},
+            {MapObjectTag::INTERACTABLE, lq::collision_layers::Interactable},
+            {MapObjectTag::CHEST, lq::collision_layers::Chest},
+        };
+
+        for (const auto& [tag, layer] : layerTable)
         {
-            return lq::collision_layers::Chest;
+            if (tags.HasAnyTag(tag)) return layer;
         }
-
         return collision_layers::Background; // by default, objects are ignored
     }
 
-    bool containsAnyToken(const std::string& value, const std::initializer_list<const char*> tokens)
-    {
-        return std::ranges::any_of(tokens, [&value](const char* token) {
-            return value.find(token) != std::string::npos;
-        });
-    }
-
-    bool isEditorPlaceableMapAssetName(const std::string& objectName)
-    {
-        return containsAnyToken(
-            objectName,
-            {"_BG_", "_FLOORSIMPLE_", "_FLOORCOMPLEX_", "_PROP_", "_BLD_", "_WALL_", "_HOLE_", "_STAIRS_"});
-    }
-
     bool hasGameplayComponent(entt::registry& registry, const entt::entity entity)
     {
         return registry.any_of<
@@ -142,145 +115,108 @@ namespace sage
         return "editor_map/material/" + sourceMaterialName;
     }
 
-    std::string readLine(std::ifstream& infile, const std::string& key)
+    void HandleLight(entt::registry* registry, const MapDescriptor& descriptor)
     {
-        std::string line;
-        std::getline(infile, line);
-        if (line.substr(0, key.length()) != key)
-        {
-            throw std::runtime_error("Expected key '" + key + "' not found");
-        }
-
-        // Remove carriage returns from the line
-        std::erase(line, '\r');
-
-        return line.substr(key.length() + 2); // +2 to skip ": "
-    }
-
-    void HandleLight(entt::registry* registry, std::ifstream& infile)
-    {
-        std::string light_type;
-        std::string objectName;
-        float x, y, z;
-        int r, g, b, s;
-        try
-        {
-            light_type = readLine(infile, "light_type");
-
-            objectName = readLine(infile, "name");
-
-            std::istringstream locStream(readLine(infile, "location"));
-            locStream >> x >> y >> z;
-
-            std::istringstream rgbStream(readLine(infile, "color"));
-            rgbStream >> r >> g >> b;
-
-            std::istringstream strStream(readLine(infile, "strength"));
-            strStream >> s;
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error parsing spawner data: " << e.what() << std::endl;
-            assert(0);
-        }
-
         auto entity = registry->create();
         auto& light = registry->emplace<Light>(entity);
         light.target = Vector3Zero();
 
-        if (light_type == "sun")
+        if (descriptor.lightType == "sun")
         {
             light.type = LIGHT_DIRECTIONAL;
             light.position = {0, 1500, 0};
             light.brightness = 0.75; // TODO
         }
-        else if (light_type == "point")
+        else if (descriptor.lightType == "point")
         {
             light.type = LIGHT_POINT;
-            light.position = scaleFromOrigin({x, y, z}, WORLD_SCALE);
-            light.brightness = s / 150; // Seems to work well.
+            light.position = scaleFromOrigin(descriptor.location, WORLD_SCALE);
+            light.brightness = descriptor.strength / 150; // Seems to work well.
         }
 
+        const auto [r, g, b] = descriptor.color;
         light.color =
             Color{static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b), 1};
     }
 
-    void HandleSpawner(entt::registry* registry, std::ifstream& infile)
+    void HandleSpawner(entt::registry* registry, const MapDescriptor& descriptor)
     {
-        std::string objectName;
-        std::string spawnerType;
-        std::string spawnerName;
-        float x, y, z, rotx, roty, rotz;
-        try
-        {
-            objectName = readLine(infile, "name");
-
-            std::istringstream locStream(readLine(infile, "location"));
-            locStream >> x >> y >> z;
-
-            std::istringstream rotStream(readLine(infile, "rotation"));
-            rotStream >> rotx >> roty >> rotz;
-
-            spawnerType = readLine(infile, "spawner_type");
-            spawnerName = readLine(infile, "spawner_name");
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error parsing spawner data: " << e.what() << std::endl;
-            assert(0);
-        }
-
         auto entity = registry->create();
 
-        Vector3 scaledPosition = scaleFromOrigin({x, y, z}, WORLD_SCALE);
+        Vector3 scaledPosition = scaleFromOrigin(descriptor.location, WORLD_SCALE);
+        const auto& [rotx, roty, rotz] = descriptor.rotation;
         auto& spawner = registry->emplace<Spawner>(entity);
         spawner.pos = {scaledPosition.x, scaledPosition.y, scaledPosition.z};
         spawner.rot = {rotx * RAD2DEG, roty * RAD2DEG, rotz * RAD2DEG};
+        spawner.type = descriptor.spawnerType;
+        spawner.name = descriptor.spawnerName;
+    }
 
-        std::unordered_map<std::string, SpawnerType> spawnerMap{
-            {"ENEMY", SpawnerType::ENEMY},
-            {"PLAYER", SpawnerType::PLAYER},
-            {"NPC", SpawnerType::NPC},
-            {"DIALOG_CUTSCENE", SpawnerType::DIALOG_CUTSCENE}};
+    // Hash of every file under 'paths' (directories recursively), with their paths, in a stable order.
+    std::uint64_t hashFiles(const std::vector<fs::path>& paths, std::uint64_t hash)
+    {
+        std::vector<fs::path> files;
+        for (const auto& path : paths)
+        {
+            if (fs::is_regular_file(path)) files.push_back(path);
+            if (!fs::is_directory(path)) continue;
+            for (const auto& entry : fs::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file()) files.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(files);
+        for (const auto& file : files)
+        {
+            const auto key = file.lexically_normal().generic_string();
+            std::ifstream stream(file, std::ios::binary);
+            const std::string bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+            hash = BuildCache::Hash(key.data(), key.size(), hash);
+            hash = BuildCache::Hash(bytes.data(), bytes.size(), hash);
+        }
+        return hash;
+    }
 
-        spawner.type = spawnerMap.at(spawnerType);
-        spawner.name = spawnerName;
+    // Everything a constructed map is built from: its descriptors and meshes, the item, dialog and quest data it
+    // references, the options that change the output (not the job count, the output doesn't depend on it) and
+    // the versions of the formats it's written in, so a respacker that writes another layout rebuilds it.
+    std::uint64_t hashMapInputs(const fs::path& inputPath, const PackOptions& options)
+    {
+        auto hash = hashFiles({inputPath, "resources/items.json", "resources/dialog", "resources/quests"},
+                              BuildCache::kHashSeed);
+        auto add = [&hash](const auto value) { hash = BuildCache::Hash(&value, sizeof(value), hash); };
+        add(lq::maploader::kMapFormatVersion);
+        add(lq::kAssetPackVersion); // Also versions the model encoding the map bin shares (PackedModel.hpp)
+        add(options.chunkSize);
+        add(options.compress);
+        add(options.optimizeMeshes);
+        add(options.quantizeMeshes);
+        add(options.lodLevels);
+        add(options.batchStatic);
+        add(options.bakeLighting);
+        add(options.dedupeMeshes);
+        return hash;
     }
 
     entt::entity HandleMesh(
         entt::registry* registry,
         TransformSystem* transformSystem,
-        std::ifstream& infile,
-        const fs::path& meshPath,
+        const MapDescriptor& descriptor,
+        const meshopt::ModelAliases& aliases,
         int& slices)
     {
-        std::string meshName, objectName;
-        float x, y, z, rotx, roty, rotz, scalex, scaley, scalez;
-        try
-        {
-            objectName = readLine(infile, "name");
-            meshName = StripPath(readLine(infile, "mesh"));
-
-            std::istringstream locStream(readLine(infile, "location"));
-            locStream >> x >> y >> z;
-
-            std::istringstream rotStream(readLine(infile, "rotation"));
-            rotStream >> rotx >> roty >> rotz;
-
-            std::istringstream scaleStream(readLine(infile, "scale"));
-            scaleStream >> scalex >> scaley >> scalez;
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error parsing mesh data: " << e.what() << std::endl;
-            assert(0);
-        }
+        const auto& objectName = descriptor.name;
+        const lq::MapObjectTags tags{lq::ClassifyMapObjectName(objectName)};
+        auto meshName = StripPath(descriptor.mesh);
+        if (const auto alias = aliases.find(meshName); alias != aliases.end()) meshName = alias->second;
+        const auto& [rotx, roty, rotz] = descriptor.rotation;
+        const auto& [scalex, scaley, scalez] = descriptor.scale;
 
         auto entity = registry->create();
 
         auto model = ResourceManager::GetInstance().GetModelView(meshName);
 
-        Vector3 scaledPosition = scaleFromOrigin({x, y, z}, WORLD_SCALE);
+        Vector3 scaledPosition = scaleFromOrigin(descriptor.location, WORLD_SCALE);
         Matrix rotMat =
             MatrixMultiply(MatrixMultiply(MatrixRotateZ(rotz), MatrixRotateY(roty)), MatrixRotateX(rotx));
         Matrix transMat = MatrixTranslate(scaledPosition.x, scaledPosition.y, scaledPosition.z);
@@ -302,9 +238,10 @@ namespace sage
         auto& collideable = registry->emplace<Collideable>(entity, localBoundingBox, transMatrix);
         collideable.isStatic = true;
 
-        collideable.collisionLayer = getCollisionLayer(objectName);
+        collideable.collisionLayer = getCollisionLayer(tags);
+        registry->emplace<lq::MapObjectTags>(entity, tags);
 
-        if (objectName.find("_MAPBASE_") != std::string::npos)
+        if (tags.HasAnyTag(lq::MapObjectTag::MAPBASE))
         {
             std::cout << "Calculating map base." << std::endl;
             slices = std::ceil(
@@ -325,52 +262,37 @@ namespace sage
         entt::registry* registry,
         TransformSystem* transformSystem,
         lq::ItemFactory* itemFactory,
-        std::ifstream& infile,
-        const fs::path& meshPath)
+        const MapDescriptor& descriptor)
     {
         int x;
-        const auto itemEntity = HandleMesh(registry, transformSystem, infile, meshPath, x);
+        // Item models are never deduplicated, the item is looked up by its model's key.
+        const auto itemEntity = HandleMesh(registry, transformSystem, descriptor, {}, x);
         const auto itemName = registry->get<Renderable>(itemEntity).GetModel()->GetKey();
         itemFactory->AttachItem(itemEntity, itemName);
     }
 
-    void processTxtFile(
+    void processMapDescriptor(
         entt::registry* registry,
-        NavigationGridSystem* navigationGridSystem,
         TransformSystem* transformSystem,
         lq::ItemFactory* itemFactory,
-        const fs::path& meshPath,
-        const fs::path& txtPath,
+        const MapDescriptor& descriptor,
+        const meshopt::ModelAliases& aliases,
         int& slices)
     {
-        std::string typeName;
-        std::ifstream infile(txtPath);
-
-        try
-        {
-            typeName = readLine(infile, "type");
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error parsing file " << txtPath << ": " << e.what() << std::endl;
-            assert(0);
-        }
-
-        if (typeName.find("spawner") != std::string::npos)
-        {
-            HandleSpawner(registry, infile);
-        }
-        else if (typeName.find("light") != std::string::npos)
-        {
-            HandleLight(registry, infile);
-        }
-        else if (typeName.find("item") != std::string::npos)
-        {
-            HandleItem(registry, transformSystem, itemFactory, infile, meshPath);
-        }
-        else
-        {
-            HandleMesh(registry, transformSystem, infile, meshPath, slices);
+        switch (descriptor.type)
+        {
+        case MapDescriptor::Type::Spawner:
+            HandleSpawner(registry, descriptor);
+            break;
+        case MapDescriptor::Type::Light:
+            HandleLight(registry, descriptor);
+            break;
+        case MapDescriptor::Type::Item:
+            HandleItem(registry, transformSystem, itemFactory, descriptor);
+            break;
+        case MapDescriptor::Type::Mesh:
+            HandleMesh(registry, transformSystem, descriptor, aliases, slices);
+            break;
         }
     }
 
@@ -379,7 +301,8 @@ namespace sage
         NavigationGridSystem* navigationGridSystem,
         TransformSystem* transformSystem,
         const char* input,
-        const char* output)
+        const char* output,
+        const PackOptions& options)
     {
         registry->clear();
         ResourceManager::GetInstance().Reset();
@@ -394,49 +317,117 @@ namespace sage
             exit(1);
         }
 
-        InitWindow(300, 100, "Loading Map!");
-
         std::cout << "START: Constructing map into bin file. \n";
 
+        // The map bin and its chunks are reused as a whole while none of their inputs changed and they are still
+        // what the last construction wrote (the blob is a hash of them).
+        std::optional<BuildCache> cache;
+        if (options.useCache) cache.emplace(fs::path(output) += ".cache");
+        const std::string mapSource = "map:" + fs::path(output).lexically_normal().generic_string();
+        const auto inputHash = hashMapInputs(inputPath, options);
+        auto outputHash = [output] {
+            return std::to_string(hashFiles({output, std::string(output) + ".chunks"}, BuildCache::kHashSeed));
+        };
+        std::string cachedOutputHash;
+        if (cache && cache->Lookup(mapSource, inputHash, cachedOutputHash) && cachedOutputHash == outputHash())
+        {
+            BuildReport report("construct-map");
+            report.upToDate = true;
+            report.AddOutput(output);
+            report.AddOutput(std::string(output) + ".chunks");
+            report.Write(output);
+            std::cout << "FINISH: Map sources unchanged since the last construction, keeping " << output << ". \n";
+            return;
+        }
+
         std::cout << "START: Loading mesh data into resource manager. \n";
+        BuildReport report("construct-map");
+        AssetIngest ingest(cache ? &*cache : nullptr, &report);
         for (const auto& entry : fs::directory_iterator(meshPath))
         {
             auto extension = entry.path().extension().string();
             std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return std::tolower(c); });
             if (extension == ".obj" || extension == ".glb" || extension == ".gltf")
             {
-                ResourceManager::GetInstance().ModelLoadFromFile(entry.path().string());
+                ingest.Add(AssetIngest::Kind::Model, entry.path());
+            }
+            else if (entry.is_regular_file())
+            {
+                ingest.Add(AssetIngest::Kind::Dependency, entry.path());
             }
         }
+        ingest.Run(options.jobs);
         std::cout << "FINISH: Loading mesh data into resource manager. \n";
 
-        int slices = 0;
-
-        std::cout << "START: Processing txt data into resource manager. \n";
+        std::vector<fs::path> txtFiles;
         for (const auto& entry : fs::directory_iterator(inputPath))
         {
             if (entry.path().extension() == ".txt")
             {
-                processTxtFile(
-                    registry, navigationGridSystem, transformSystem, &itemFactory, meshPath, entry.path(), slices);
+                txtFiles.push_back(entry.path());
             }
         }
-        std::cout << "FINISH: Processing txt data into resource manager. \n";
+        // Parsing is independent per file. Entities are still created in directory order so the bin is stable.
+        const auto descriptors = ParseMapDescriptorFiles(txtFiles, options.jobs);
 
-        ImageSafe heightMap(false), normalMap(false);
-
-        navigationGridSystem->Init(slices, 1.0f);
-        navigationGridSystem->InitGridHeightAndNormals();
-        navigationGridSystem->GenerateHeightMap(heightMap);
-        navigationGridSystem->GenerateNormalMap(normalMap);
+        // Before optimizing and generating LODs, so that isn't done for every copy.
+        meshopt::ModelAliases aliases;
+        if (options.dedupeMeshes)
+        {
+            std::unordered_set<std::string> itemModels;
+            for (const auto& descriptor : descriptors)
+            {
+                if (descriptor.type == MapDescriptor::Type::Item) itemModels.insert(StripPath(descriptor.mesh));
+            }
+            aliases = meshopt::DeduplicateResourceManagerModels(itemModels, options.jobs);
+        }
+        if (options.optimizeMeshes) meshopt::OptimizeResourceManagerModels(options.jobs);
+        if (options.lodLevels > 0) meshopt::GenerateResourceManagerLods(options.lodLevels, options.jobs);
+        // Before batching adds models that don't come from a file of their own.
+        report.AddResourceManagerModels(aliases);
 
-        // ExportImage(heightMap.GetImage(), "resources/HeightMap.png");
-        // ExportImage(normalMap.GetImage(), "resources/NormalMap.png");
+        int slices = 0;
 
-        ResourceManager::GetInstance().ImageLoadFromFile("HEIGHT_MAP", heightMap.GetImage());
-        ResourceManager::GetInstance().ImageLoadFromFile("NORMAL_MAP", normalMap.GetImage());
+        std::cout << "START: Processing txt data into resource manager. \n";
+        for (const auto& descriptor : descriptors)
+        {
+            processMapDescriptor(registry, transformSystem, &itemFactory, descriptor, aliases, slices);
+        }
+        std::cout << "FINISH: Processing txt data into resource manager. \n";
 
-        lq::maploader::SaveMap(*registry, output);
+        // Heights, normals and static obstacles go into the map bin as they are, see NavigationGridBake.hpp.
+        constexpr float kNavigationSpacing = 1.0f;
+        navigationGridSystem->Init(slices, kNavigationSpacing);
+        navigationGridSystem->InitGridHeightAndNormals();
+        registry->ctx().insert_or_assign(
+            lq::maploader::BakeNavigationGrid(*navigationGridSystem, slices, kNavigationSpacing, *registry));
+
+        const MapReferences references({"resources/dialog", "resources/quests"});
+        if (options.batchStatic)
+        {
+            // Batches follow the chunk grid, so each one streams with the chunk it lies in.
+            const auto batches =
+                BatchStaticGeometry(registry, options.chunkSize > 0 ? options.chunkSize : 64.0f, references);
+            if (options.bakeLighting) BakeStaticLighting(registry, batches, options.jobs);
+        }
+
+        lq::maploader::MapSaveOptions saveOptions{.chunkSize = options.chunkSize};
+        saveOptions.compressChunks = options.compress;
+        saveOptions.quantizeMeshes = options.quantizeMeshes;
+        saveOptions.jobs = options.jobs;
+        saveOptions.keepResident = [registry, &references](const entt::entity entity) {
+            const auto* renderable = registry->try_get<Renderable>(entity);
+            return renderable != nullptr && references.IsReferenced(renderable->GetName());
+        };
+        lq::maploader::SaveMap(*registry, output, saveOptions);
+        if (cache)
+        {
+            cache->Store(mapSource, inputHash, outputHash());
+            cache->Save();
+        }
+        report.AddOutput(output);
+        report.AddOutput(std::string(output) + ".chunks");
+        report.Write(output);
         std::cout << "FINISH: Constructing map into bin file. \n";
     }
 
@@ -453,16 +444,22 @@ namespace sage
         registry->clear();
         ResourceManager::GetInstance().Reset();
         lq::maploader::LoadMap(registry, inputMapBin);
+        lq::maploader::LoadAllMapChunks(registry);
 
         std::unordered_set<std::string> keepModelKeys;
-        const auto view = registry->view<sgTransform, Renderable, Collideable>();
+        // Batched scenery has no Renderable, but still names the model it was placed with.
+        for (const auto [entity, member, tags] : registry->view<lq::StaticBatchMember, lq::MapObjectTags>().each())
+        {
+            if (hasGameplayComponent(*registry, entity)) continue;
+            if (tags.HasAnyTag(lq::EDITOR_PLACEABLE_TAGS)) keepModelKeys.insert(member.modelKey);
+        }
+        const auto view = registry->view<sgTransform, Renderable, Collideable, lq::MapObjectTags>();
         for (const auto entity : view)
         {
             if (hasGameplayComponent(*registry, entity)) continue;
+            if (!view.get<lq::MapObjectTags>(entity).HasAnyTag(lq::EDITOR_PLACEABLE_TAGS)) continue;
 
             const auto& renderable = view.get<Renderable>(entity);
-            if (!isEditorPlaceableMapAssetName(renderable.GetName())) continue;
-
             const auto* model = renderable.GetModel();
             if (model == nullptr || model->GetKey().empty()) continue;
             keepModelKeys.insert(model->GetKey());
@@ -498,6 +495,10 @@ namespace sage
         resourceManager.materialMap = std::move(filteredMaterials);
 
         serializer::SaveClassBinary(outputAssetBin, resourceManager);
+        BuildReport report("export-editor-assets");
+        report.AddResourceManagerModels();
+        report.AddOutput(outputAssetBin);
+        report.Write(outputAssetBin);
         std::cout << "FINISH: Exported " << resourceManager.modelCopies.size()
                   << " editor-placeable model assets to " << outputAssetBin << ". \n";
     }
@@ -505,7 +506,8 @@ namespace sage
     /**
      * output: The path + filename of the resulting binary
      **/
-    void ResourcePacker::PackAssets(entt::registry* registry, const std::string& output)
+    void ResourcePacker::PackAssets(
+        entt::registry* registry, const std::string& output, const PackOptions& options)
     {
         fs::path outputPath(output);
         if (!fs::is_directory(outputPath.parent_path()))
@@ -520,6 +522,10 @@ namespace sage
         }
 
         std::cout << "START: Loading assets into memory \n";
+        BuildReport report("pack-assets");
+        std::optional<BuildCache> cache;
+        if (options.useCache) cache.emplace(fs::path(output) += ".cache");
+        AssetIngest ingest(cache ? &*cache : nullptr, &report);
         {
             fs::path imagePath("resources/textures");
             if (!fs::is_directory(imagePath.parent_path()))
@@ -527,16 +533,14 @@ namespace sage
                 std::cout << "ResourcePacker: Image directory does not exist, cannot load. Aborting... \n";
                 return;
             }
-            std::cout << "START: Processing image data into resource manager. \n";
             for (const auto& entry : fs::recursive_directory_iterator(imagePath))
             {
                 if (!entry.is_regular_file()) continue;
                 if (entry.path().extension() == ".png")
                 {
-                    ResourceManager::GetInstance().ImageLoadFromFile(entry.path());
+                    ingest.Add(AssetIngest::Kind::Image, entry.path());
                 }
             }
-            std::cout << "FINISH: Processing image data into resource manager. \n";
         }
         {
             fs::path iconsPath("resources/icons");
@@ -545,16 +549,14 @@ namespace sage
                 std::cout << "ResourcePacker: Icon directory does not exist, cannot load. Aborting... \n";
                 return;
             }
-            std::cout << "START: Processing icon data into resource manager. \n";
             for (const auto& entry : fs::recursive_directory_iterator(iconsPath))
             {
                 if (!entry.is_regular_file()) continue;
                 if (entry.path().extension() == ".png")
                 {
-                    ResourceManager::GetInstance().ImageLoadFromFile(entry.path());
+                    ingest.Add(AssetIngest::Kind::Image, entry.path());
                 }
             }
-            std::cout << "FINISH: Processing icon data into resource manager. \n";
         }
         {
             fs::path iconsPath("resources/fonts");
@@ -563,16 +565,14 @@ namespace sage
                 std::cout << "ResourcePacker: Font directory does not exist, cannot load. Aborting... \n";
                 return;
             }
-            std::cout << "START: Processing font data into resource manager. \n";
             for (const auto& entry : fs::recursive_directory_iterator(iconsPath))
             {
                 if (!entry.is_regular_file()) continue;
                 if (entry.path().extension() == ".ttf")
                 {
-                    ResourceManager::GetInstance().FontLoadFromFile(entry.path());
+                    ingest.Add(AssetIngest::Kind::Font, entry.path());
                 }
             }
-            std::cout << "FINISH: Processing font data into resource manager. \n";
         }
         {
             fs::path modelPath("resources/models");
@@ -581,7 +581,6 @@ namespace sage
                 std::cout << "ResourcePacker: Model directory does not exist, cannot load. Aborting... \n";
                 return;
             }
-            std::cout << "START: Processing model data into resource manager. \n";
             constexpr std::array validExtensions = {".glb", ".gltf", ".obj"};
             for (const auto& entry : fs::recursive_directory_iterator(modelPath))
             {
@@ -589,17 +588,30 @@ namespace sage
                 if (std::find(validExtensions.begin(), validExtensions.end(), entry.path().extension()) ==
                     validExtensions.end())
                 {
+                    // glTF buffers, textures and .mtl files are read while the model loads.
+                    ingest.Add(AssetIngest::Kind::Dependency, entry.path());
                     continue;
                 }
-                ResourceManager::GetInstance().ModelLoadFromFile(entry.path());
                 if (entry.path().extension() == ".glb" || entry.path().extension() == ".gltf")
                 {
-                    ResourceManager::GetInstance().ModelAnimationLoadFromFile(entry.path());
+                    ingest.Add(AssetIngest::Kind::AnimatedModel, entry.path());
+                }
+                else
+                {
+                    ingest.Add(AssetIngest::Kind::Model, entry.path());
                 }
             }
-            std::cout << "FINISH: Processing image data into resource manager. \n";
         }
 
+        std::cout << "START: Processing image, icon, font and model data into resource manager (jobs: "
+                  << lq::ResolveJobCount(options.jobs) << "). \n";
+        ingest.Run(options.jobs);
+        if (cache) cache->Save();
+        std::cout << "FINISH: Processing image, icon, font and model data into resource manager. \n";
+        // Ahead of the primitives: those are regenerated from their generator at runtime, not read from the pack.
+        if (options.optimizeMeshes) meshopt::OptimizeResourceManagerModels(options.jobs);
+        if (options.lodLevels > 0) meshopt::GenerateResourceManagerLods(options.lodLevels, options.jobs);
+
         {
             // Bake raylib primitives into the asset pack as shared entries. Each gets a
             // stable key ("primitive_sphere", etc.) and goes through dedupeAndShareMaterials
@@ -636,6 +648,14 @@ namespace sage
         // ResourceManager::GetInstance().SFXLoadFromFile("resources/audio/sfx/equip_open.ogg");
 
         std::cout << "FINISH: Loading assets into memory \n";
-        serializer::SaveClassBinary(output.c_str(), ResourceManager::GetInstance());
+        std::cout << "START: Writing asset pack \n";
+        AssetPackWriter writer;
+        writer.AddResourceManager(options.quantizeMeshes, options.compressAnimations);
+        const auto toc = writer.Write(output, options.jobs, options.compress);
+        std::cout << "FINISH: Writing asset pack \n";
+        report.AddResourceManagerModels();
+        report.AddPackEntries(toc);
+        report.AddOutput(output);
+        report.Write(output);
     }
 }; // namespace sage
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "PackOptions.hpp"
+
 #include "entt/entt.hpp"
 #include <string>
 
@@ -22,9 +24,11 @@ namespace sage
             NavigationGridSystem* navigationGridSystem,
             TransformSystem* transformSystem,
             const char* input,
-            const char* output);
+            const char* output,
+            const PackOptions& options = {});
 
-        static void PackAssets(entt::registry* registry, const std::string& output);
+        static void PackAssets(
+            entt::registry* registry, const std::string& output, const PackOptions& options = {});
 
         static void ExportEditorAssetsFromMapBin(
             entt::registry* registry,
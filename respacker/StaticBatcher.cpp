@@ -0,0 +1,305 @@
+#include "StaticBatcher.hpp"
+
+#include "MapReferences.hpp"
+
+#include "engine/components/Collideable.hpp"
+#include "engine/components/DoorBehaviorComponent.hpp"
+#include "engine/components/Renderable.hpp"
+#include "engine/components/sgTransform.hpp"
+#include "engine/components/Spawner.hpp"
+#include "engine/ResourceManager.hpp"
+
+#include "game/src/collision/RpgCollisionLayers.hpp"
+#include "game/src/components/DialogComponent.hpp"
+#include "game/src/components/InventoryComponent.hpp"
+#include "game/src/components/ItemComponent.hpp"
+#include "game/src/components/StaticBatchMember.hpp"
+#include "game/utils/MapObjectTags.hpp"
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace sage
+{
+    namespace
+    {
+        using lq::MapObjectTag;
+
+        constexpr auto kBatchableTags = MapObjectTag::BG | MapObjectTag::FLOORSIMPLE | MapObjectTag::WALL |
+                                        MapObjectTag::BLD | MapObjectTag::HOLE | MapObjectTag::PROP |
+                                        MapObjectTag::STAIRS;
+        constexpr auto kUnbatchableTags = MapObjectTag::DOOR | MapObjectTag::INTERACTABLE | MapObjectTag::CHEST |
+                                          MapObjectTag::ITEM | MapObjectTag::MAPBASE | MapObjectTag::FLOORCOMPLEX;
+        // raylib indices are 16 bit.
+        constexpr int kMaxBatchVertices = 65536;
+
+        struct Piece
+        {
+            const Mesh* mesh;
+            Matrix world;
+        };
+
+        struct MaterialBatch
+        {
+            Material material{};
+            std::string sourcePath;
+            std::vector<Piece> pieces;
+        };
+
+        // Cell x, cell z, material name. Ordered, so the batches (and the map bin) are stable.
+        using BatchKey = std::tuple<int, int, std::string>;
+
+        Vector3 transformDirection(const Matrix& m, const Vector3 v)
+        {
+            return Vector3Normalize(
+                {m.m0 * v.x + m.m4 * v.y + m.m8 * v.z,
+                 m.m1 * v.x + m.m5 * v.y + m.m9 * v.z,
+                 m.m2 * v.x + m.m6 * v.y + m.m10 * v.z});
+        }
+
+        // World space copy of pieces [first, last) as one mesh. Attributes only some pieces have are filled with
+        // defaults for the others.
+        Mesh mergePieces(const std::vector<Piece>& pieces, const std::size_t first, const std::size_t last)
+        {
+            Mesh out{};
+            bool normals = false, tangents = false, texcoords = false, texcoords2 = false, colors = false;
+            for (auto p = first; p < last; ++p)
+            {
+                const auto& mesh = *pieces[p].mesh;
+                out.vertexCount += mesh.vertexCount;
+                out.triangleCount += mesh.triangleCount;
+                normals |= mesh.normals != nullptr;
+                tangents |= mesh.tangents != nullptr;
+                texcoords |= mesh.texcoords != nullptr;
+                texcoords2 |= mesh.texcoords2 != nullptr;
+                colors |= mesh.colors != nullptr;
+            }
+
+            const auto vertexCount = static_cast<std::size_t>(out.vertexCount);
+            out.vertices = static_cast<float*>(RL_MALLOC(vertexCount * 3 * sizeof(float)));
+            out.indices = static_cast<unsigned short*>(RL_MALLOC(out.triangleCount * 3 * sizeof(unsigned short)));
+            if (normals) out.normals = static_cast<float*>(RL_MALLOC(vertexCount * 3 * sizeof(float)));
+            if (tangents) out.tangents = static_cast<float*>(RL_MALLOC(vertexCount * 4 * sizeof(float)));
+            if (texcoords) out.texcoords = static_cast<float*>(RL_CALLOC(vertexCount * 2, sizeof(float)));
+            if (texcoords2) out.texcoords2 = static_cast<float*>(RL_CALLOC(vertexCount * 2, sizeof(float)));
+            if (colors) out.colors = static_cast<unsigned char*>(RL_MALLOC(vertexCount * 4));
+
+            std::size_t base = 0;
+            std::size_t index = 0;
+            for (auto p = first; p < last; ++p)
+            {
+                const auto& [mesh, world] = std::tie(*pieces[p].mesh, pieces[p].world);
+                const auto normalMatrix = MatrixTranspose(MatrixInvert(world));
+                const bool mirrored = MatrixDeterminant(world) < 0.0f;
+
+                for (int v = 0; v < mesh.vertexCount; ++v)
+                {
+                    const auto o = base + v;
+                    const auto position = Vector3Transform(
+                        {mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]}, world);
+                    std::memcpy(&out.vertices[o * 3], &position, sizeof(position));
+                    if (normals)
+                    {
+                        const auto normal =
+                            mesh.normals != nullptr
+                                ? transformDirection(
+                                      normalMatrix,
+                                      {mesh.normals[v * 3], mesh.normals[v * 3 + 1], mesh.normals[v * 3 + 2]})
+                                : Vector3{0.0f, 1.0f, 0.0f};
+                        std::memcpy(&out.normals[o * 3], &normal, sizeof(normal));
+                    }
+                    if (tangents)
+                    {
+                        const float* t = mesh.tangents != nullptr ? &mesh.tangents[v * 4] : nullptr;
+                        const auto tangent = t != nullptr ? transformDirection(world, {t[0], t[1], t[2]})
+                                                          : Vector3{1.0f, 0.0f, 0.0f};
+                        const float handedness = (t != nullptr ? t[3] : 1.0f) * (mirrored ? -1.0f : 1.0f);
+                        std::memcpy(&out.tangents[o * 4], &tangent, sizeof(tangent));
+                        out.tangents[o * 4 + 3] = handedness;
+                    }
+                    if (mesh.texcoords != nullptr)
+                        std::memcpy(&out.texcoords[o * 2], &mesh.texcoords[v * 2], 2 * sizeof(float));
+                    if (mesh.texcoords2 != nullptr)
+                        std::memcpy(&out.texcoords2[o * 2], &mesh.texcoords2[v * 2], 2 * sizeof(float));
+                    if (colors)
+                    {
+                        if (mesh.colors != nullptr)
+                            std::memcpy(&out.colors[o * 4], &mesh.colors[v * 4], 4);
+                        else
+                            std::memset(&out.colors[o * 4], 255, 4);
+                    }
+                }
+
+                for (int t = 0; t < mesh.triangleCount; ++t)
+                {
+                    std::size_t corners[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const auto i = t * 3 + k;
+                        corners[k] = mesh.indices != nullptr ? mesh.indices[i] : static_cast<std::size_t>(i);
+                    }
+                    // Mirroring turns the triangles around, keep them facing out.
+                    if (mirrored) std::swap(corners[1], corners[2]);
+                    for (const auto corner : corners)
+                    {
+                        out.indices[index++] = static_cast<unsigned short>(base + corner);
+                    }
+                }
+                base += mesh.vertexCount;
+            }
+            return out;
+        }
+
+        BoundingBox boundsOf(const Mesh& mesh)
+        {
+            BoundingBox box{{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+            for (int v = 0; v < mesh.vertexCount; ++v)
+            {
+                const Vector3 p{mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2]};
+                box.min = Vector3Min(box.min, p);
+                box.max = Vector3Max(box.max, p);
+            }
+            return box;
+        }
+    } // namespace
+
+    std::vector<entt::entity> BatchStaticGeometry(
+        entt::registry* registry, const float cellSize, const MapReferences& references)
+    {
+        std::cout << "START: Batching static geometry. \n";
+        auto& rm = ResourceManager::GetInstance();
+
+        std::map<BatchKey, MaterialBatch> batches;
+        std::vector<std::pair<entt::entity, std::string>> members; // Entity, model key
+        unsigned int drawCallsBefore = 0;
+        const auto view = registry->view<sgTransform, Renderable, Collideable, lq::MapObjectTags>();
+        for (const auto entity : view)
+        {
+            const auto& tags = view.get<lq::MapObjectTags>(entity);
+            if (!tags.HasAnyTag(kBatchableTags) || tags.HasAnyTag(kUnbatchableTags)) continue;
+            if (registry->any_of<
+                    Spawner,
+                    DoorBehaviorComponent,
+                    lq::DialogComponent,
+                    lq::InventoryComponent,
+                    lq::ItemComponent>(entity))
+                continue;
+            const auto& renderable = view.get<Renderable>(entity);
+            if (references.IsReferenced(renderable.GetName())) continue;
+            const auto* model = renderable.GetModel();
+            if (model == nullptr) continue;
+            const auto info = rm.modelCopies.find(model->GetKey());
+            if (info == rm.modelCopies.end() || info->second.privateMaterials) continue;
+
+            const auto& source = info->second.model;
+            bool fits = true;
+            for (int m = 0; m < source.meshCount; ++m)
+            {
+                fits &= source.meshes[m].vertices != nullptr && source.meshes[m].vertexCount <= kMaxBatchVertices;
+            }
+            if (!fits) continue;
+
+            const auto& box = view.get<Collideable>(entity).worldBoundingBox;
+            const auto center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+            const int cellX = static_cast<int>(std::floor(center.x / cellSize));
+            const int cellZ = static_cast<int>(std::floor(center.z / cellSize));
+            const auto world =
+                MatrixMultiply(renderable.initialTransform, view.get<sgTransform>(entity).GetMatrix());
+            for (int m = 0; m < source.meshCount; ++m)
+            {
+                const int material = source.meshMaterial[m];
+                auto& batch = batches[{cellX, cellZ, info->second.materialNames[material]}];
+                if (batch.pieces.empty())
+                {
+                    batch.material = source.materials[material];
+                    batch.sourcePath = info->second.sourcePath;
+                }
+                batch.pieces.push_back({&source.meshes[m], world});
+            }
+            drawCallsBefore += source.meshCount;
+            members.emplace_back(entity, model->GetKey());
+        }
+
+        // One model per cell, one mesh per material (more if a material's pieces overflow 16 bit indices).
+        std::map<std::pair<int, int>, std::vector<std::pair<Mesh, const MaterialBatch*>>> cells;
+        std::map<std::pair<int, int>, std::vector<std::string>> cellMaterialNames;
+        for (const auto& [key, batch] : batches)
+        {
+            const auto& [cellX, cellZ, materialName] = key;
+            std::size_t first = 0;
+            while (first < batch.pieces.size())
+            {
+                auto last = first;
+                int vertices = 0;
+                while (last < batch.pieces.size() &&
+                       vertices + batch.pieces[last].mesh->vertexCount <= kMaxBatchVertices)
+                {
+                    vertices += batch.pieces[last++].mesh->vertexCount;
+                }
+                cells[{cellX, cellZ}].emplace_back(mergePieces(batch.pieces, first, last), &batch);
+                cellMaterialNames[{cellX, cellZ}].push_back(materialName);
+                first = last;
+            }
+        }
+
+        unsigned int drawCallsAfter = 0;
+        std::vector<entt::entity> out;
+        for (auto& [cell, meshes] : cells)
+        {
+            const auto key = "batch_" + std::to_string(cell.first) + "_" + std::to_string(cell.second);
+            Model model{};
+            model.transform = MatrixIdentity();
+            model.meshCount = static_cast<int>(meshes.size());
+            model.materialCount = model.meshCount;
+            model.meshes = static_cast<Mesh*>(RL_CALLOC(model.meshCount, sizeof(Mesh)));
+            model.materials = static_cast<Material*>(RL_CALLOC(model.materialCount, sizeof(Material)));
+            model.meshMaterial = static_cast<int*>(RL_CALLOC(model.meshCount, sizeof(int)));
+            BoundingBox bounds{{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+            for (int m = 0; m < model.meshCount; ++m)
+            {
+                model.meshes[m] = meshes[m].first;
+                // Shallow copies of the pooled materials, like every other model that uses them.
+                model.materials[m] = meshes[m].second->material;
+                model.meshMaterial[m] = m;
+                const auto box = boundsOf(model.meshes[m]);
+                bounds.min = Vector3Min(bounds.min, box.min);
+                bounds.max = Vector3Max(bounds.max, box.max);
+            }
+            rm.StoreModel(
+                ModelInfo{model, cellMaterialNames[cell], meshes.front().second->sourcePath, false}, key);
+            drawCallsAfter += model.meshCount;
+
+            const auto entity = registry->create();
+            auto& renderable = registry->emplace<Renderable>(entity, rm.GetModelView(key), MatrixIdentity());
+            renderable.SetName(key);
+            auto& trans = registry->emplace<sgTransform>(entity);
+            trans.position.world = {0.0f, 0.0f, 0.0f};
+            trans.scale.world = {1.0f, 1.0f, 1.0f};
+            // Only there to place the batch in a map chunk, nothing queries the background layer.
+            auto& collideable = registry->emplace<Collideable>(entity, bounds, trans.GetMatrix());
+            collideable.isStatic = true;
+            collideable.collisionLayer = collision_layers::Background;
+            registry->emplace<lq::MapObjectTags>(entity);
+            out.push_back(entity);
+        }
+
+        for (auto& [entity, modelKey] : members)
+        {
+            registry->remove<Renderable>(entity);
+            registry->emplace<lq::StaticBatchMember>(entity, std::move(modelKey));
+        }
+
+        std::cout << "Static batching: " << members.size() << " object(s) into " << cells.size()
+                  << " batch model(s), draw calls " << drawCallsBefore << " -> " << drawCallsAfter << ". \n";
+        std::cout << "FINISH: Batching static geometry. \n";
+        return out;
+    }
+} // namespace sage
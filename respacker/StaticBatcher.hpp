@@ -0,0 +1,18 @@
+#pragma once
+
+#include "entt/entt.hpp"
+
+#include <vector>
+
+namespace sage
+{
+    class MapReferences;
+
+    // Merges the plain static scenery of a constructed map (walls, floors, background, props...) into one batch
+    // model per cell of 'cellSize' world units, with one mesh per material. Doors, chests, interactables, items,
+    // complex floors (their collision samples the mesh) and objects named by dialog/quest files are left alone.
+    // Batched objects keep their transform, collision and tags, their Renderable is swapped for a
+    // lq::StaticBatchMember, so gameplay queries see the same pieces as before. Returns the batch entities.
+    std::vector<entt::entity> BatchStaticGeometry(
+        entt::registry* registry, float cellSize, const MapReferences& references);
+} // namespace sage
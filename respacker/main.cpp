@@ -2,25 +2,40 @@
 #include "engine/systems/CollisionSystem.hpp"
 #include "engine/systems/NavigationGridSystem.hpp"
 #include "engine/systems/TransformSystem.hpp"
+#include "Benchmarks.hpp"
 #include "ResourcePacker.hpp"
 
+#include "game/utils/HeadlessContext.hpp"
+
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 int main(int argc, char* argv[])
 {
-    InitWindow(300, 100, "Packing Assets...");
+    // Options (e.g. "--jobs 8") may be given with or without a command.
+    const bool hasCommand = argc > 1 && !sage::PackOptions::IsOption(argv[1]);
+    std::vector<std::string> args;
+    const auto options = sage::PackOptions::Parse(argc, argv, hasCommand ? 2 : 1, args);
+
+    // Packing never draws anything, the context only exists for raylib's loaders.
+    const lq::HeadlessContext context(
+        options.headless || !lq::HeadlessContext::DisplayAvailable(), "Packing Assets...");
     entt::registry registry{};
     sage::TransformSystem transformSystem(&registry);
     sage::CollisionSystem collisionSystem(&registry);
     sage::NavigationGridSystem navigationGridSystem(&registry, &collisionSystem);
+    auto arg = [&args](const std::size_t index, const char* fallback) {
+        return index < args.size() ? args[index].c_str() : fallback;
+    };
 
-    if (argc > 1)
+    if (hasCommand)
     {
         const std::string command = argv[1];
         if (command == "--pack-assets")
         {
-            sage::ResourcePacker::PackAssets(&registry, argc > 2 ? argv[2] : "resources/assets.bin");
+            sage::ResourcePacker::PackAssets(&registry, arg(0, "resources/assets.bin"), options);
         }
         else if (command == "--construct-map")
         {
@@ -28,35 +43,60 @@ int main(int argc, char* argv[])
                 &registry,
                 &navigationGridSystem,
                 &transformSystem,
-                argc > 2 ? argv[2] : "resources/maps/dungeon-map",
-                argc > 3 ? argv[3] : "resources/dungeon-map.bin");
+                arg(0, "resources/maps/dungeon-map"),
+                arg(1, "resources/dungeon-map.bin"),
+                options);
         }
         else if (command == "--export-editor-assets")
         {
             sage::ResourcePacker::ExportEditorAssetsFromMapBin(
                 &registry,
                 &transformSystem,
-                argc > 2 ? argv[2] : "resources/dungeon-map.bin",
-                argc > 3 ? argv[3] : "resources/editor-map-assets.bin");
+                arg(0, "resources/dungeon-map.bin"),
+                arg(1, "resources/editor-map-assets.bin"));
+        }
+        else if (command == "--bench-map-parser")
+        {
+            sage::bench::MapParser(
+                arg(0, "resources/maps/dungeon-map"), std::strtoul(arg(1, "5"), nullptr, 10), options);
+        }
+        else if (command == "--bench-model-decoder")
+        {
+            sage::bench::ModelDecoder(
+                arg(0, "resources/models"), std::strtoul(arg(1, "5"), nullptr, 10), options);
+        }
+        else if (command == "--bench-compression")
+        {
+            sage::bench::Compression(
+                arg(0, "resources/dungeon-map.bin"), std::strtoul(arg(1, "5"), nullptr, 10), options);
+        }
+        else if (command == "--bench-map-instantiation")
+        {
+            sage::bench::MapInstantiation(
+                &registry,
+                arg(0, "resources/dungeon-map.bin"),
+                std::strtoul(arg(1, "5"), nullptr, 10),
+                std::strtoul(arg(2, "50000"), nullptr, 10));
+        }
+        else if (command == "--bench-ray-queries")
+        {
+            sage::bench::RayQueries(
+                &registry, arg(0, "resources/dungeon-map.bin"), std::strtoul(arg(1, "5"), nullptr, 10));
         }
         else
         {
             std::cerr << "Unknown respacker command: " << command << std::endl;
-            CloseWindow();
             return 1;
         }
 
-        CloseWindow();
         return 0;
     }
 
     // clang-format off
-    sage::ResourcePacker::PackAssets(&registry, "resources/assets.bin");
-    sage::ResourcePacker::ConstructMap( &registry, &navigationGridSystem, &transformSystem, "resources/maps/dungeon-map", "resources/dungeon-map.bin");
+    sage::ResourcePacker::PackAssets(&registry, "resources/assets.bin", options);
+    sage::ResourcePacker::ConstructMap( &registry, &navigationGridSystem, &transformSystem, "resources/maps/dungeon-map", "resources/dungeon-map.bin", options);
     sage::ResourcePacker::ExportEditorAssetsFromMapBin(&registry, &transformSystem, "resources/dungeon-map.bin", "resources/editor-map-assets.bin");
     // clang-format on
 
-    CloseWindow();
-
     return 0;
 }